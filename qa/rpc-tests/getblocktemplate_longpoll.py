@@ -69,6 +69,13 @@ class GetBlockTemplateLPTest(BitcoinTestFramework):
         thr.join(60 + 20)
         assert(not thr.is_alive())
 
+        # Test 5: a delta relative to the previous template only contains the new transaction
+        templat = self.nodes[0].getblocktemplate({'longpollid':thr.longpollid, 'delta':True})
+        assert('transactions' not in templat)
+        assert_equal(templat['delta']['base'], thr.longpollid)
+        assert_equal([tx['hash'] for tx in templat['delta']['added']], [txid])
+        assert_equal(templat['delta']['removed'], [])
+
 if __name__ == '__main__':
     GetBlockTemplateLPTest().main()
 
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Copyright (c) 2019 The Jemcash Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+import json
+import time
+
+from test_framework.test_framework import DashTestFramework
+from test_framework.util import *
+
+'''
+governance-votesync.py
+
+Syncs the votes of many proposals to fresh nodes, once with per object vote requests
+and once with vote set sketches, and compares sync duration and governance traffic
+
+'''
+
+PROPOSAL_COUNT = 20
+GOVERNANCE_MSG_TYPES = ['govsync', 'govobj', 'govobjvote', 'govvsketch', 'govvotes', 'ssc', 'inv', 'getdata']
+
+class GovernanceVoteSyncTest(DashTestFramework):
+    def __init__(self):
+        super().__init__(6, 5, [], fast_dip3_enforcement=True)
+
+    def run_test(self):
+        self.create_proposals()
+        expected_votes = PROPOSAL_COUNT * self.mn_count
+        assert_equal(self.nodes[0].gobject('count')['votes'], expected_votes)
+
+        # every fresh node gets its own index, so that the second one doesn't start from the first one's datadir
+        legacy = self.sync_fresh_node(len(self.nodes), ['-governancevotesketch=0'], expected_votes)
+        self.log.info("per object requests: {} ticks, {:.2f}s, {} bytes".format(*legacy))
+
+        sketch = self.sync_fresh_node(len(self.nodes) + 1, [], expected_votes)
+        self.log.info("vote set sketches: {} ticks, {:.2f}s, {} bytes".format(*sketch))
+
+        assert(sketch[2] < legacy[2])
+
+    def create_proposals(self):
+        node = self.nodes[0]
+        proposals = []
+        for i in range(PROPOSAL_COUNT):
+            proposal = {
+                'type': 1,
+                'name': 'proposal_%d' % i,
+                'start_epoch': get_mocktime(),
+                'end_epoch': get_mocktime() + 30 * 24 * 60 * 60,
+                'payment_address': node.getnewaddress(),
+                'payment_amount': 10,
+                'url': 'https://jempay.net/proposal_%d' % i,
+            }
+            data_hex = bytes_to_hex_str(json.dumps(proposal).encode('utf-8'))
+            collateral_txid = node.gobject('prepare', '0', 1, get_mocktime(), data_hex)
+            proposals.append((data_hex, collateral_txid))
+
+        # collaterals need 6 confirmations
+        node.generate(6)
+        self.sync_all()
+
+        for data_hex, collateral_txid in proposals:
+            proposal_hash = node.gobject('submit', '0', 1, get_mocktime(), data_hex, collateral_txid)
+            # the voting keys of all masternodes are in the wallet of the faucet node
+            node.gobject('vote-many', proposal_hash, 'funding', 'yes')
+
+    def sync_fresh_node(self, idx, args, expected_votes):
+        initialize_datadir(self.options.tmpdir, idx)
+        node = start_node(idx, self.options.tmpdir, self.extra_args + args)
+        connect_nodes(node, 0)
+        sync_blocks([self.nodes[0], node])
+
+        # let the quick regtest mnsync and the vote requests after it run, every tick needs 6 seconds of mocktime
+        ticks = 0
+        start = time.time()
+        while node.gobject('count')['votes'] < expected_votes:
+            assert(ticks < 100)
+            set_mocktime(get_mocktime() + 6)
+            set_node_times(self.nodes + [node], get_mocktime())
+            ticks += 1
+            time.sleep(0.5)
+        duration = time.time() - start
+
+        assert_equal(node.gobject('count')['votes'], expected_votes)
+
+        total_bytes = 0
+        for peer in node.getpeerinfo():
+            for msg_type in GOVERNANCE_MSG_TYPES:
+                total_bytes += peer['bytessent_per_msg'].get(msg_type, 0)
+                total_bytes += peer['bytesrecv_per_msg'].get(msg_type, 0)
+
+        stop_node(node, idx)
+        return ticks, duration, total_bytes
+
+if __name__ == '__main__':
+    GovernanceVoteSyncTest().main()
@@ -9,6 +9,10 @@
 #include "validation.h"
 #include "util.h"
 
+void InitBLSTests();
+void CleanupBLSTests();
+void CleanupBLSDkgTests();
+
 int
 main(int argc, char** argv)
 {
@@ -19,7 +23,13 @@ main(int argc, char** argv)
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
 
+    InitBLSTests();
+
     benchmark::BenchRunner::RunAll();
 
+    // need to be called before global destructors kick in (the worker pool references the BLS objects)
+    CleanupBLSDkgTests();
+    CleanupBLSTests();
+
     ECC_Stop();
 }
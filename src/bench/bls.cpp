@@ -4,6 +4,7 @@
 
 #include "bench.h"
 #include "random.h"
+#include "bls/bls_batchverifier.h"
 #include "bls/bls_worker.h"
 #include "utiltime.h"
 
@@ -11,6 +12,11 @@
 
 CBLSWorker blsWorker;
 
+void InitBLSTests()
+{
+    blsWorker.Start();
+}
+
 void CleanupBLSTests()
 {
     blsWorker.Stop();
@@ -343,6 +349,67 @@ static void BLSVerify_BatchedParallel(benchmark::State& state)
     }
 }
 
+// Throughput of CBLSBatchVerifier with different ratios of bad signatures, each signature coming from its own source
+static void BLSVerify_BatchVerifier(size_t invalidCount, bool parallel, benchmark::State& state)
+{
+    BLSPublicKeyVector pubKeys;
+    BLSSecretKeyVector secKeys;
+    BLSSignatureVector sigs;
+    std::vector<uint256> msgHashes;
+    std::vector<bool> invalid;
+    BuildTestVectors(100, invalidCount, pubKeys, secKeys, sigs, msgHashes, invalid);
+
+    CBLSWorker worker;
+    if (parallel) {
+        worker.Start();
+    }
+    CBLSBatchSizeController sizeController(1, 100);
+
+    // Benchmark.
+    while (state.KeepRunning()) {
+        CBLSBatchVerifier<size_t, size_t> batchVerifier(false, true);
+        for (size_t i = 0; i < pubKeys.size(); i++) {
+            batchVerifier.PushMessage(i, i, msgHashes[i], sigs[i], pubKeys[i]);
+        }
+        batchVerifier.Verify(parallel ? &worker : nullptr, &sizeController);
+        assert(batchVerifier.badSources.size() == invalidCount);
+    }
+
+    if (parallel) {
+        worker.Stop();
+    }
+}
+
+static void BLSVerify_BatchVerifier0(benchmark::State& state)
+{
+    BLSVerify_BatchVerifier(0, false, state);
+}
+
+static void BLSVerify_BatchVerifier1(benchmark::State& state)
+{
+    BLSVerify_BatchVerifier(1, false, state);
+}
+
+static void BLSVerify_BatchVerifier10(benchmark::State& state)
+{
+    BLSVerify_BatchVerifier(10, false, state);
+}
+
+static void BLSVerify_BatchVerifierParallel0(benchmark::State& state)
+{
+    BLSVerify_BatchVerifier(0, true, state);
+}
+
+static void BLSVerify_BatchVerifierParallel1(benchmark::State& state)
+{
+    BLSVerify_BatchVerifier(1, true, state);
+}
+
+static void BLSVerify_BatchVerifierParallel10(benchmark::State& state)
+{
+    BLSVerify_BatchVerifier(10, true, state);
+}
+
 BENCHMARK(BLSPubKeyAggregate_Normal)
 BENCHMARK(BLSSecKeyAggregate_Normal)
 BENCHMARK(BLSSign_Normal)
@@ -355,3 +422,9 @@ BENCHMARK(BLSVerify_LargeAggregatedBlock10000)
 BENCHMARK(BLSVerify_LargeAggregatedBlock1000PreVerified)
 BENCHMARK(BLSVerify_Batched)
 BENCHMARK(BLSVerify_BatchedParallel)
+BENCHMARK(BLSVerify_BatchVerifier0)
+BENCHMARK(BLSVerify_BatchVerifier1)
+BENCHMARK(BLSVerify_BatchVerifier10)
+BENCHMARK(BLSVerify_BatchVerifierParallel0)
+BENCHMARK(BLSVerify_BatchVerifierParallel1)
+BENCHMARK(BLSVerify_BatchVerifierParallel10)
@@ -6,6 +6,8 @@
 #include "random.h"
 #include "bls/bls_worker.h"
 
+#include <list>
+
 extern CBLSWorker blsWorker;
 
 struct Member {
@@ -109,9 +111,101 @@ struct DKG
             memberIdx = (memberIdx + 1) % members.size();
         }
     }
+
+    // Like CDKGSession, verify contributions in batches in the background while they arrive
+    void Bench_VerifyContributionSharesPipelined(benchmark::State& state, size_t batchSize)
+    {
+        ReceiveVvecs();
+
+        struct Batch {
+            std::vector<BLSVerificationVectorPtr> vvecs;
+            BLSSecretKeyVector skShares;
+            std::future<std::vector<bool>> result;
+        };
+
+        size_t memberIdx = 0;
+        while (state.KeepRunning()) {
+            ReceiveShares(memberIdx);
+
+            std::list<Batch> batches;
+            for (size_t i = 0; i < members.size(); i += batchSize) {
+                size_t end = std::min(i + batchSize, members.size());
+                batches.emplace_back();
+                auto& b = batches.back();
+                b.vvecs.assign(receivedVvecs.begin() + i, receivedVvecs.begin() + end);
+                b.skShares.assign(receivedSkShares.begin() + i, receivedSkShares.begin() + end);
+                b.result = blsWorker.AsyncVerifyContributionShares(members[memberIdx].id, b.vvecs, b.skShares, true, true);
+            }
+            for (auto& b : batches) {
+                for (bool r : b.result.get()) {
+                    assert(r);
+                }
+            }
+
+            memberIdx = (memberIdx + 1) % members.size();
+        }
+    }
+
+    // Quorum vvec and own secret key share, as built by CDKGSession::SendCommitment
+    void Bench_BuildCommitment(benchmark::State& state, bool concurrent)
+    {
+        ReceiveVvecs();
+        ReceiveShares(0);
+
+        while (state.KeepRunning()) {
+            if (concurrent) {
+                auto skShareFuture = blsWorker.AsyncAggregateSecretKeys(receivedSkShares, 0, receivedSkShares.size(), true);
+                BuildQuorumVerificationVector(true);
+                assert(skShareFuture.get().IsValid());
+            } else {
+                BuildQuorumVerificationVector(true);
+                assert(blsWorker.AggregateSecretKeys(receivedSkShares).IsValid());
+            }
+        }
+    }
+
+    // Members signature aggregation and quorum signature recovery, as done by CDKGSession::FinalizeCommitments
+    void Bench_FinalizeCommitment(benchmark::State& state, bool concurrent)
+    {
+        uint256 commitmentHash = GetRandHash();
+
+        std::vector<CBLSSignature> operatorSigs;
+        std::vector<CBLSPublicKey> operatorPubKeys;
+        std::vector<CBLSSignature> thresholdSigs;
+        std::vector<CBLSId> signerIds;
+        for (size_t i = 0; i < members.size(); i++) {
+            CBLSSecretKey operatorKey;
+            operatorKey.MakeNewKey();
+            operatorPubKeys.emplace_back(operatorKey.GetPublicKey());
+            operatorSigs.emplace_back(operatorKey.Sign(commitmentHash));
+
+            ReceiveShares(i);
+            CBLSSecretKey skShare = blsWorker.AggregateSecretKeys(receivedSkShares);
+            thresholdSigs.emplace_back(skShare.Sign(commitmentHash));
+            signerIds.emplace_back(members[i].id);
+        }
+
+        while (state.KeepRunning()) {
+            CBLSSignature membersSig;
+            CBLSSignature quorumSig;
+            if (concurrent) {
+                auto f = blsWorker.AsyncExec([&]() {
+                    membersSig = CBLSSignature::AggregateSecure(operatorSigs, operatorPubKeys, commitmentHash);
+                });
+                bool recovered = quorumSig.Recover(thresholdSigs, signerIds);
+                f.get();
+                assert(recovered);
+            } else {
+                membersSig = CBLSSignature::AggregateSecure(operatorSigs, operatorPubKeys, commitmentHash);
+                assert(quorumSig.Recover(thresholdSigs, signerIds));
+            }
+            assert(membersSig.IsValid());
+        }
+    }
 };
 
 std::shared_ptr<DKG> dkg10;
+std::shared_ptr<DKG> dkg50;
 std::shared_ptr<DKG> dkg100;
 std::shared_ptr<DKG> dkg400;
 
@@ -120,6 +214,9 @@ void InitIfNeeded()
     if (dkg10 == nullptr) {
         dkg10 = std::make_shared<DKG>(10);
     }
+    if (dkg50 == nullptr) {
+        dkg50 = std::make_shared<DKG>(50);
+    }
     if (dkg100 == nullptr) {
         dkg100 = std::make_shared<DKG>(100);
     }
@@ -131,6 +228,7 @@ void InitIfNeeded()
 void CleanupBLSDkgTests()
 {
     dkg10.reset();
+    dkg50.reset();
     dkg100.reset();
     dkg400.reset();
 }
@@ -179,3 +277,44 @@ BENCH_VerifyContributionShares(parallel, 400, 5, true, false)
 BENCH_VerifyContributionShares(parallel_aggregated, 10, 5, true, true)
 BENCH_VerifyContributionShares(parallel_aggregated, 100, 5, true, true)
 BENCH_VerifyContributionShares(parallel_aggregated, 400, 5, true, true)
+
+///////////////////////////////
+
+// Full size LLMQ scenarios (llmq_50_60 and llmq_400_60/llmq_400_85)
+
+#define BENCH_VerifyContributionSharesPipelined(quorumSize, batchSize) \
+    static void BLSDKG_VerifyContributionSharesPipelined_##batchSize##_##quorumSize(benchmark::State& state) \
+    { \
+        InitIfNeeded(); \
+        dkg##quorumSize->Bench_VerifyContributionSharesPipelined(state, batchSize); \
+    } \
+    BENCHMARK(BLSDKG_VerifyContributionSharesPipelined_##batchSize##_##quorumSize)
+
+BENCH_VerifyContributionSharesPipelined(50, 32)
+BENCH_VerifyContributionSharesPipelined(400, 32)
+
+#define BENCH_BuildCommitment(name, quorumSize, concurrent) \
+    static void BLSDKG_BuildCommitment_##name##_##quorumSize(benchmark::State& state) \
+    { \
+        InitIfNeeded(); \
+        dkg##quorumSize->Bench_BuildCommitment(state, concurrent); \
+    } \
+    BENCHMARK(BLSDKG_BuildCommitment_##name##_##quorumSize)
+
+BENCH_BuildCommitment(simple, 50, false)
+BENCH_BuildCommitment(simple, 400, false)
+BENCH_BuildCommitment(concurrent, 50, true)
+BENCH_BuildCommitment(concurrent, 400, true)
+
+#define BENCH_FinalizeCommitment(name, quorumSize, concurrent) \
+    static void BLSDKG_FinalizeCommitment_##name##_##quorumSize(benchmark::State& state) \
+    { \
+        InitIfNeeded(); \
+        dkg##quorumSize->Bench_FinalizeCommitment(state, concurrent); \
+    } \
+    BENCHMARK(BLSDKG_FinalizeCommitment_##name##_##quorumSize)
+
+BENCH_FinalizeCommitment(simple, 50, false)
+BENCH_FinalizeCommitment(simple, 400, false)
+BENCH_FinalizeCommitment(concurrent, 50, true)
+BENCH_FinalizeCommitment(concurrent, 400, true)
@@ -3,6 +3,11 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "bench.h"
+#include "evo/deterministicmns.h"
+#include "evo/evodb.h"
+#include "privatesend.h"
+#include "random.h"
+#include "validation.h"
 #include "wallet/wallet.h"
 
 #include <boost/foreach.hpp>
@@ -57,4 +62,91 @@ static void CoinSelection(benchmark::State& state)
     }
 }
 
+// PrivateSend coin selection in a wallet where only a small part of the coins is relevant for mixing. Every
+// transaction has a single output, so the cost of scanning the wallet shows up directly.
+static const int PS_REGULAR_COINS = 10000;
+static const int PS_DENOMINATED_COINS = 1000;
+static const int PS_COLLATERAL_COINS = 10;
+
+static void AddWalletCoin(CWallet& wallet, const CScript& scriptPubKey, const CAmount& nValue, CBlockIndex* pindex)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(GetRandHash(), 0);
+    tx.vout.emplace_back(nValue, scriptPubKey);
+    CWalletTx wtx(&wallet, MakeTransactionRef(std::move(tx)));
+    wtx.SetMerkleBranch(pindex, 0);
+    wallet.AddToWallet(wtx);
+}
+
+static void PrivateSendCoinSelection(benchmark::State& state, AvailableCoinsType nCoinType, size_t nExpectedCoins)
+{
+    CPrivateSend::InitStandardDenominations();
+    evoDb = new CEvoDB(1 << 20, true, true);
+    deterministicMNManager = new CDeterministicMNManager(*evoDb);
+
+    // all coins are confirmed in the tip, so they are trusted without any mempool or InstantSend lookups
+    uint256 blockHash = GetRandHash();
+    CBlockIndex* pindex = new CBlockIndex();
+    pindex->phashBlock = &blockHash;
+    {
+        LOCK(cs_main);
+        mapBlockIndex.emplace(blockHash, pindex);
+        chainActive.SetTip(pindex);
+    }
+
+    {
+        CWallet wallet;
+        CKey key;
+        key.MakeNewKey(true);
+        wallet.AddKeyPubKey(key, key.GetPubKey());
+        CScript scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+        std::vector<CAmount> vecDenoms = CPrivateSend::GetStandardDenominations();
+        for (int i = 0; i < PS_REGULAR_COINS; i++) {
+            AddWalletCoin(wallet, scriptPubKey, 5 * COIN, pindex);
+        }
+        for (int i = 0; i < PS_DENOMINATED_COINS; i++) {
+            AddWalletCoin(wallet, scriptPubKey, vecDenoms[i % vecDenoms.size()], pindex);
+        }
+        for (int i = 0; i < PS_COLLATERAL_COINS; i++) {
+            AddWalletCoin(wallet, scriptPubKey, CPrivateSend::GetCollateralAmount(), pindex);
+        }
+
+        while (state.KeepRunning()) {
+            std::vector<COutput> vCoins;
+            wallet.AvailableCoins(vCoins, true, NULL, false, nCoinType);
+            assert(vCoins.size() == nExpectedCoins);
+        }
+    }
+
+    {
+        LOCK(cs_main);
+        chainActive.SetTip(NULL);
+        mapBlockIndex.erase(blockHash);
+    }
+    delete pindex;
+    delete deterministicMNManager;
+    deterministicMNManager = NULL;
+    delete evoDb;
+    evoDb = NULL;
+}
+
+static void CoinSelectionPrivateSendDenominated(benchmark::State& state)
+{
+    PrivateSendCoinSelection(state, ONLY_DENOMINATED, PS_DENOMINATED_COINS);
+}
+
+static void CoinSelectionPrivateSendCollateral(benchmark::State& state)
+{
+    PrivateSendCoinSelection(state, ONLY_PRIVATESEND_COLLATERAL, PS_COLLATERAL_COINS);
+}
+
+static void CoinSelectionNonDenominated(benchmark::State& state)
+{
+    PrivateSendCoinSelection(state, ONLY_NONDENOMINATED, PS_REGULAR_COINS);
+}
+
 BENCHMARK(CoinSelection);
+BENCHMARK(CoinSelectionPrivateSendDenominated);
+BENCHMARK(CoinSelectionPrivateSendCollateral);
+BENCHMARK(CoinSelectionNonDenominated);
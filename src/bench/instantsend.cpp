@@ -0,0 +1,85 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "dbwrapper.h"
+#include "random.h"
+#include "util.h"
+#include "llmq/quorums_instantsend.h"
+
+// Lookups in the islock index as done by mempool acceptance for every input of every new transaction. Most inputs
+// are not locked, so misses are as important as hits.
+static const size_t INDEXED_ISLOCKS = 10000;
+static const size_t ISLOCK_INPUTS = 2;
+static const size_t LOOKUPS = 1000;
+
+static void BuildISLockIndex(llmq::CInstantSendDb& isdb, std::vector<COutPoint>& lockedInputs)
+{
+    CDBBatch batch(isdb.GetRawDB());
+    for (size_t i = 0; i < INDEXED_ISLOCKS; i++) {
+        llmq::CInstantSendLock islock;
+        for (size_t j = 0; j < ISLOCK_INPUTS; j++) {
+            islock.inputs.emplace_back(GetRandHash(), j);
+            lockedInputs.emplace_back(islock.inputs.back());
+        }
+        islock.txid = GetRandHash();
+        isdb.WriteNewInstantSendLock(batch, ::SerializeHash(islock), islock);
+    }
+    isdb.GetRawDB().WriteBatch(batch);
+}
+
+static void InstantSendLockIndexLookupHit(benchmark::State& state)
+{
+    CDBWrapper db("islocks", 1 << 20, true);
+    llmq::CInstantSendDb isdb(db);
+    std::vector<COutPoint> lockedInputs;
+    BuildISLockIndex(isdb, lockedInputs);
+
+    LogPrintf("InstantSendLockIndexLookupHit -- index memory usage: %d bytes per islock\n", isdb.GetIndexMemoryUsage() / INDEXED_ISLOCKS);
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        for (size_t j = 0; j < LOOKUPS; j++) {
+            assert(isdb.GetInstantSendLockByInput(lockedInputs[i++ % lockedInputs.size()]) != nullptr);
+        }
+    }
+}
+
+static void InstantSendLockIndexLookupMiss(benchmark::State& state)
+{
+    CDBWrapper db("islocks", 1 << 20, true);
+    llmq::CInstantSendDb isdb(db);
+    std::vector<COutPoint> lockedInputs;
+    BuildISLockIndex(isdb, lockedInputs);
+
+    std::vector<COutPoint> unlockedInputs;
+    for (size_t j = 0; j < LOOKUPS; j++) {
+        unlockedInputs.emplace_back(GetRandHash(), 0);
+    }
+
+    while (state.KeepRunning()) {
+        for (auto& in : unlockedInputs) {
+            assert(isdb.GetInstantSendLockByInput(in) == nullptr);
+        }
+    }
+}
+
+static void InstantSendLockIndexLoad(benchmark::State& state)
+{
+    CDBWrapper db("islocks", 1 << 20, true);
+    {
+        llmq::CInstantSendDb isdb(db);
+        std::vector<COutPoint> lockedInputs;
+        BuildISLockIndex(isdb, lockedInputs);
+    }
+
+    while (state.KeepRunning()) {
+        llmq::CInstantSendDb isdb(db);
+        assert(isdb.GetInstantSendLockCount() == INDEXED_ISLOCKS);
+    }
+}
+
+BENCHMARK(InstantSendLockIndexLookupHit);
+BENCHMARK(InstantSendLockIndexLookupMiss);
+BENCHMARK(InstantSendLockIndexLoad);
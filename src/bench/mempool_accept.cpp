@@ -0,0 +1,162 @@
+// Copyright (c) 2018 The Jemcash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "chain.h"
+#include "chainparams.h"
+#include "coins.h"
+#include "consensus/validation.h"
+#include "dbwrapper.h"
+#include "evo/evodb.h"
+#include "key.h"
+#include "keystore.h"
+#include "llmq/quorums_instantsend.h"
+#include "random.h"
+#include "script/sigcache.h"
+#include "script/sign.h"
+#include "script/standard.h"
+#include "txmempool.h"
+#include "util.h"
+#include "validation.h"
+
+#include <boost/thread/thread.hpp>
+
+// Mempool acceptance of a burst of relayed transactions, one by one through AcceptToMemoryPool() and as one batch
+// through AcceptToMemoryPoolBatch(), which verifies the scripts on the script check threads. Accepted tx/sec at
+// saturation is BATCH_TXS / (time per iteration).
+static const size_t BATCH_TXS = 100;
+static const size_t BATCH_INPUTS = 2;
+
+// Just enough chain state for AcceptToMemoryPool(): a genesis tip and a coins cache holding the spent outputs
+class MempoolAcceptSetup
+{
+private:
+    CCoinsView coinsDummy;
+    CDBWrapper llmqDb;
+    CBlockIndex genesisIndex;
+    uint256 genesisHash;
+    boost::thread_group threadGroup;
+
+public:
+    std::vector<CTransactionRef> vtx;
+
+    MempoolAcceptSetup() : llmqDb("", 1 << 20, true)
+    {
+        SelectParams(CBaseChainParams::REGTEST);
+        // Small caches, so that clearing them for every iteration is cheap
+        ForceSetArg("-maxsigcachesize", "4");
+
+        evoDb = new CEvoDB(1 << 20, true, true);
+        llmq::quorumInstantSendManager = new llmq::CInstantSendManager(llmqDb);
+        pcoinsTip = new CCoinsViewCache(&coinsDummy);
+
+        genesisIndex = CBlockIndex(Params().GenesisBlock());
+        genesisHash = Params().GenesisBlock().GetHash();
+        genesisIndex.phashBlock = &genesisHash;
+        {
+            LOCK(cs_main);
+            mapBlockIndex.emplace(genesisHash, &genesisIndex);
+            chainActive.SetTip(&genesisIndex);
+            pcoinsTip->SetBestBlock(genesisHash);
+        }
+
+        nScriptCheckThreads = std::max(2, GetNumCores());
+        for (int i = 0; i < nScriptCheckThreads - 1; i++) {
+            threadGroup.create_thread(&ThreadScriptCheck);
+        }
+
+        CreateSignedBatch();
+    }
+
+    ~MempoolAcceptSetup()
+    {
+        threadGroup.interrupt_all();
+        threadGroup.join_all();
+        nScriptCheckThreads = 0;
+
+        LOCK(cs_main);
+        mempool.clear();
+        chainActive.SetTip(NULL);
+        mapBlockIndex.erase(genesisHash);
+        delete pcoinsTip;
+        pcoinsTip = NULL;
+        delete llmq::quorumInstantSendManager;
+        llmq::quorumInstantSendManager = NULL;
+        delete evoDb;
+        evoDb = NULL;
+    }
+
+    // Every iteration has to verify all signatures again
+    void Reset()
+    {
+        LOCK(cs_main);
+        mempool.clear();
+        InitSignatureCache();
+        InitScriptExecutionCache();
+    }
+
+private:
+    void CreateSignedBatch()
+    {
+        CBasicKeyStore keystore;
+        CKey key;
+        key.MakeNewKey(true);
+        keystore.AddKey(key);
+        CScript scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+        LOCK(cs_main);
+        for (size_t i = 0; i < BATCH_TXS; i++) {
+            CMutableTransaction tx;
+            tx.nVersion = 1;
+            tx.vin.resize(BATCH_INPUTS);
+            for (size_t j = 0; j < BATCH_INPUTS; j++) {
+                tx.vin[j].prevout = COutPoint(GetRandHash(), j);
+                pcoinsTip->AddCoin(tx.vin[j].prevout, Coin(CTxOut(COIN, scriptPubKey), 0, false, false), false);
+            }
+            tx.vout.resize(1);
+            tx.vout[0].scriptPubKey = scriptPubKey;
+            tx.vout[0].nValue = BATCH_INPUTS * COIN - 10000;
+            for (size_t j = 0; j < BATCH_INPUTS; j++) {
+                SignSignature(keystore, scriptPubKey, tx, j);
+            }
+            vtx.emplace_back(MakeTransactionRef(std::move(tx)));
+        }
+    }
+};
+
+static void MempoolAcceptSerial(benchmark::State& state)
+{
+    ECCVerifyHandle verifyHandle;
+    MempoolAcceptSetup setup;
+
+    while (state.KeepRunning()) {
+        setup.Reset();
+        LOCK(cs_main);
+        for (const auto& tx : setup.vtx) {
+            CValidationState validationState;
+            bool fAccepted = AcceptToMemoryPool(mempool, validationState, tx, true, NULL);
+            assert(fAccepted);
+        }
+    }
+}
+
+static void MempoolAcceptBatch(benchmark::State& state)
+{
+    ECCVerifyHandle verifyHandle;
+    MempoolAcceptSetup setup;
+    std::vector<int64_t> vAcceptTime(setup.vtx.size(), GetTime());
+
+    while (state.KeepRunning()) {
+        setup.Reset();
+        LOCK(cs_main);
+        std::vector<bool> vAccepted;
+        std::vector<CValidationState> vStates;
+        std::vector<bool> vMissingInputs;
+        AcceptToMemoryPoolBatch(mempool, setup.vtx, vAcceptTime, true, vAccepted, vStates, vMissingInputs);
+        assert(mempool.size() == BATCH_TXS);
+    }
+}
+
+BENCHMARK(MempoolAcceptSerial);
+BENCHMARK(MempoolAcceptBatch);
@@ -5,6 +5,7 @@
 #include "bench.h"
 #include "policy/policy.h"
 #include "txmempool.h"
+#include "validation.h"
 
 #include <list>
 #include <vector>
@@ -111,4 +112,40 @@ static void MempoolEviction(benchmark::State& state)
     }
 }
 
+// Long chains are the worst case for the ancestor/descendant bookkeeping:
+// every new transaction has all previous ones as ancestors.
+static void MempoolChainedTransactions(benchmark::State& state)
+{
+    const size_t nChainLength = 25;
+    std::vector<CMutableTransaction> vChain(nChainLength);
+    for (size_t i = 0; i < nChainLength; i++) {
+        CMutableTransaction& tx = vChain[i];
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << OP_1;
+        if (i > 0) {
+            tx.vin[0].prevout = COutPoint(vChain[i - 1].GetHash(), 0);
+        }
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nValue = 10 * COIN;
+    }
+
+    CTxMemPool pool;
+    LOCK(pool.cs);
+
+    while (state.KeepRunning()) {
+        for (const auto& tx : vChain) {
+            CTxMemPoolEntry entry(MakeTransactionRef(tx), 1000LL, 0, 1, false, 4, LockPoints());
+            CTxMemPool::setEntries setAncestors;
+            std::string errString;
+            pool.CalculateMemPoolAncestors(entry, setAncestors,
+                DEFAULT_ANCESTOR_LIMIT, DEFAULT_ANCESTOR_SIZE_LIMIT * 1000,
+                DEFAULT_DESCENDANT_LIMIT, DEFAULT_DESCENDANT_SIZE_LIMIT * 1000, errString);
+            pool.addUnchecked(tx.GetHash(), entry, setAncestors);
+        }
+        pool.removeRecursive(vChain[0]);
+    }
+}
+
 BENCHMARK(MempoolEviction);
+BENCHMARK(MempoolChainedTransactions);
@@ -6,10 +6,51 @@
 #define DASH_CRYPTO_BLS_BATCHVERIFIER_H
 
 #include "bls.h"
+#include "bls_worker.h"
 
+#include <atomic>
 #include <map>
 #include <vector>
 
+// Chooses the number of sources per batch from the rate of bad sources seen in previous verifications. A batch
+// containing a bad source costs about 2*log2(n) additional batch verifications, so with a bad rate of p batches are
+// kept at around 1/p sources. Shared between multiple verifiers of the same kind of messages and thread-safe.
+class CBLSBatchSizeController
+{
+private:
+    // exponential moving average of the bad rate, in parts per million
+    std::atomic<int64_t> badRatePPM{0};
+    size_t minBatchSize;
+    size_t maxBatchSize;
+
+public:
+    CBLSBatchSizeController(size_t _minBatchSize, size_t _maxBatchSize) :
+            minBatchSize(_minBatchSize),
+            maxBatchSize(_maxBatchSize)
+    {
+        assert(minBatchSize != 0 && minBatchSize <= maxBatchSize);
+    }
+
+    size_t GetBatchSize() const
+    {
+        int64_t rate = badRatePPM;
+        if (rate == 0) {
+            return maxBatchSize;
+        }
+        return std::max(minBatchSize, std::min(maxBatchSize, (size_t)(1000000 / rate)));
+    }
+
+    void Update(size_t sourceCount, size_t badCount)
+    {
+        if (sourceCount == 0) {
+            return;
+        }
+        int64_t rate = (int64_t)(badCount * 1000000 / sourceCount);
+        int64_t oldRate = badRatePPM;
+        badRatePPM = oldRate + (rate - oldRate) / 8;
+    }
+};
+
 template<typename SourceId, typename MessageId>
 class CBLSBatchVerifier
 {
@@ -24,6 +65,7 @@ private:
     typedef std::map<MessageId, Message> MessageMap;
     typedef typename MessageMap::iterator MessageMapIterator;
     typedef std::map<SourceId, std::vector<MessageMapIterator>> MessagesBySourceMap;
+    typedef typename MessagesBySourceMap::const_iterator MessagesBySourceIterator;
 
     bool secureVerification;
     bool perMessageFallback;
@@ -63,55 +105,128 @@ public:
         messagesBySource.clear();
     }
 
-    void Verify()
+    // Verifies all pushed messages. Sources are split into sub batches of the size suggested by sizeController (or a
+    // single batch if none is given). If a worker is given, the sub batches are verified in parallel on its pool.
+    // Failed (sub) batches are bisected to find the bad sources, which needs about 2*log2(n) batch verifications
+    // per bad source instead of one verification per source
+    void Verify(CBLSWorker* worker = nullptr, CBLSBatchSizeController* sizeController = nullptr)
     {
-        std::map<uint256, std::vector<MessageMapIterator>> byMessageHash;
-
-        for (auto it = messages.begin(); it != messages.end(); ++it) {
-            byMessageHash[it->second.msgHash].emplace_back(it);
+        std::vector<MessagesBySourceIterator> sources;
+        sources.reserve(messagesBySource.size());
+        for (auto it = messagesBySource.begin(); it != messagesBySource.end(); ++it) {
+            sources.emplace_back(it);
         }
-
-        if (VerifyBatch(byMessageHash)) {
-            // full batch is valid
+        if (sources.empty()) {
             return;
         }
 
-        // revert to per-source verification
-        for (const auto& p : messagesBySource) {
-            bool batchValid = false;
+        size_t batchSize = sizeController ? sizeController->GetBatchSize() : sources.size();
+        size_t batchCount = (sources.size() + batchSize - 1) / batchSize;
+
+        std::vector<std::set<SourceId>> batchBadSources(batchCount);
+        std::vector<std::set<MessageId>> batchBadMessages(batchCount);
+        if (worker != nullptr && batchCount > 1) {
+            std::vector<std::future<void>> futures;
+            futures.reserve(batchCount);
+            for (size_t i = 0; i < batchCount; i++) {
+                size_t start = i * batchSize;
+                size_t count = std::min(batchSize, sources.size() - start);
+                auto& badSourcesRet = batchBadSources[i];
+                auto& badMessagesRet = batchBadMessages[i];
+                futures.emplace_back(worker->AsyncExec([this, &sources, start, count, &badSourcesRet, &badMessagesRet]() {
+                    VerifySources(sources, start, count, false, badSourcesRet, badMessagesRet);
+                }));
+            }
+            for (auto& f : futures) {
+                f.get();
+            }
+        } else {
+            for (size_t i = 0; i < batchCount; i++) {
+                size_t start = i * batchSize;
+                size_t count = std::min(batchSize, sources.size() - start);
+                VerifySources(sources, start, count, false, batchBadSources[i], batchBadMessages[i]);
+            }
+        }
+
+        size_t badCount = 0;
+        for (size_t i = 0; i < batchCount; i++) {
+            badCount += batchBadSources[i].size();
+            badSources.insert(batchBadSources[i].begin(), batchBadSources[i].end());
+            badMessages.insert(batchBadMessages[i].begin(), batchBadMessages[i].end());
+        }
+        if (sizeController) {
+            sizeController->Update(sources.size(), badCount);
+        }
+    }
 
-            // no need to verify it again if there was just one source
-            if (messagesBySource.size() != 1) {
-                byMessageHash.clear();
-                for (auto it = p.second.begin(); it != p.second.end(); ++it) {
-                    byMessageHash[(*it)->second.msgHash].emplace_back(*it);
+private:
+    // Verifies sources[start, start+count). If knownBad is true, the caller already knows that the range contains at
+    // least one bad message
+    void VerifySources(const std::vector<MessagesBySourceIterator>& sources, size_t start, size_t count, bool knownBad,
+                       std::set<SourceId>& badSourcesRet, std::set<MessageId>& badMessagesRet)
+    {
+        if (!knownBad) {
+            std::map<uint256, std::vector<MessageMapIterator>> byMessageHash;
+            for (size_t i = start; i < start + count; i++) {
+                for (const auto& msgIt : sources[i]->second) {
+                    byMessageHash[msgIt->second.msgHash].emplace_back(msgIt);
                 }
-                batchValid = VerifyBatch(byMessageHash);
             }
-            if (!batchValid) {
-                badSources.emplace(p.first);
-
-                if (perMessageFallback) {
-                    // revert to per-message verification
-                    if (p.second.size() == 1) {
-                        // no need to re-verify a single message
-                        badMessages.emplace(p.second[0]->second.msgId);
-                    } else {
-                        for (const auto& msgIt : p.second) {
-                            if (badMessages.count(msgIt->first)) {
-                                // same message might be invalid from different source, so no need to re-verify it
-                                continue;
-                            }
-
-                            const auto& msg = msgIt->second;
-                            if (!msg.sig.VerifyInsecure(msg.pubKey, msg.msgHash)) {
-                                badMessages.emplace(msg.msgId);
-                            }
-                        }
+            if (VerifyBatch(byMessageHash)) {
+                return;
+            }
+        }
+
+        if (count == 1) {
+            const auto& p = *sources[start];
+            badSourcesRet.emplace(p.first);
+            if (perMessageFallback) {
+                // same message might be invalid from different source, so no need to re-verify it
+                std::vector<MessageMapIterator> msgIts;
+                std::set<MessageId> seen;
+                for (const auto& msgIt : p.second) {
+                    if (!badMessagesRet.count(msgIt->first) && seen.emplace(msgIt->first).second) {
+                        msgIts.emplace_back(msgIt);
                     }
                 }
+                if (!msgIts.empty()) {
+                    // we only know that one of the remaining messages is bad if none was skipped
+                    VerifyMessages(msgIts, 0, msgIts.size(), msgIts.size() == p.second.size(), badMessagesRet);
+                }
             }
+            return;
         }
+
+        // if the first half turns out to be valid, the second half must contain the bad message(s)
+        size_t half = count / 2;
+        size_t badCount = badSourcesRet.size();
+        VerifySources(sources, start, half, false, badSourcesRet, badMessagesRet);
+        VerifySources(sources, start + half, count - half, badCount == badSourcesRet.size(), badSourcesRet, badMessagesRet);
+    }
+
+    // msgIts must not contain duplicates
+    void VerifyMessages(const std::vector<MessageMapIterator>& msgIts, size_t start, size_t count, bool knownBad,
+                        std::set<MessageId>& badMessagesRet)
+    {
+        if (!knownBad) {
+            std::map<uint256, std::vector<MessageMapIterator>> byMessageHash;
+            for (size_t i = start; i < start + count; i++) {
+                byMessageHash[msgIts[i]->second.msgHash].emplace_back(msgIts[i]);
+            }
+            if (VerifyBatch(byMessageHash)) {
+                return;
+            }
+        }
+
+        if (count == 1) {
+            badMessagesRet.emplace(msgIts[start]->first);
+            return;
+        }
+
+        size_t half = count / 2;
+        size_t badCount = badMessagesRet.size();
+        VerifyMessages(msgIts, start, half, false, badMessagesRet);
+        VerifyMessages(msgIts, start + half, count - half, badCount == badMessagesRet.size(), badMessagesRet);
     }
 
 private:
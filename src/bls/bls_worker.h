@@ -139,6 +139,21 @@ public:
     std::future<bool> AsyncVerifySig(const CBLSSignature& sig, const CBLSPublicKey& pubKey, const uint256& msgHash, CancelCond cancelCond = [] { return false; });
     bool IsAsyncVerifyInProgress();
 
+    // Runs an arbitrary job on the worker pool. Used for work that is independent from the callers thread but not
+    // covered by the functions above, e.g. batch verification of signatures belonging to different quorums
+    template<typename Callable>
+    std::future<void> AsyncExec(Callable&& f)
+    {
+        if (workerPool.size() == 0) {
+            // not started (e.g. in unit tests), so run it on the callers thread
+            std::promise<void> p;
+            f();
+            p.set_value();
+            return p.get_future();
+        }
+        return workerPool.push([f](int threadId) { f(); });
+    }
+
 private:
     void PushSigVerifyBatch();
 };
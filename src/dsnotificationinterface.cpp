@@ -80,6 +80,11 @@ void CDSNotificationInterface::SyncTransaction(const CTransaction &tx, const CBl
     CPrivateSend::SyncTransaction(tx, pindex, posInBlock);
 }
 
+void CDSNotificationInterface::NotifyTransactionLock(const CTransaction &tx)
+{
+    llmq::chainLocksHandler->NotifyTransactionLock(tx);
+}
+
 void CDSNotificationInterface::NotifyMasternodeListChanged(bool undo, const CDeterministicMNList& oldMNList, const CDeterministicMNListDiff& diff)
 {
     CMNAuth::NotifyMasternodeListChanged(undo, oldMNList, diff);
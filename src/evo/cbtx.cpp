@@ -91,12 +91,14 @@ bool CheckCbTxMerkleRoots(const CBlock& block, const CBlockIndex* pindex, CValid
     return true;
 }
 
+// Shared by block validation and mining, only rehashes the entries which changed since the last calculation
+static CSimplifiedMNListMerkleTree smlMerkleTree;
+
 bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev, uint256& merkleRootRet, CValidationState& state)
 {
     LOCK(deterministicMNManager->cs);
 
     static int64_t nTimeDMN = 0;
-    static int64_t nTimeSMNL = 0;
     static int64_t nTimeMerkle = 0;
 
     int64_t nTime1 = GetTimeMicros();
@@ -109,29 +111,11 @@ bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev
     int64_t nTime2 = GetTimeMicros(); nTimeDMN += nTime2 - nTime1;
     LogPrint("bench", "            - BuildNewListFromBlock: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), nTimeDMN * 0.000001);
 
-    CSimplifiedMNList sml(tmpMNList);
-
-    int64_t nTime3 = GetTimeMicros(); nTimeSMNL += nTime3 - nTime2;
-    LogPrint("bench", "            - CSimplifiedMNList: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeSMNL * 0.000001);
-
-    static CSimplifiedMNList smlCached;
-    static uint256 merkleRootCached;
-    static bool mutatedCached{false};
-
-    if (sml.mnList == smlCached.mnList) {
-        merkleRootRet = merkleRootCached;
-        return !mutatedCached;
-    }
-
     bool mutated = false;
-    merkleRootRet = sml.CalcMerkleRoot(&mutated);
-
-    int64_t nTime4 = GetTimeMicros(); nTimeMerkle += nTime4 - nTime3;
-    LogPrint("bench", "            - CalcMerkleRoot: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeMerkle * 0.000001);
+    merkleRootRet = smlMerkleTree.CalcMerkleRoot(tmpMNList, &mutated);
 
-    smlCached = std::move(sml);
-    merkleRootCached = merkleRootRet;
-    mutatedCached = mutated;
+    int64_t nTime3 = GetTimeMicros(); nTimeMerkle += nTime3 - nTime2;
+    LogPrint("bench", "            - CalcMerkleRoot: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeMerkle * 0.000001);
 
     return !mutated;
 }
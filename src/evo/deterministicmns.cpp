@@ -258,18 +258,20 @@ std::vector<CDeterministicMNCPtr> CDeterministicMNList::CalculateQuorum(size_t m
 {
     auto scores = CalculateScores(modifier);
 
+    // only the top maxSize entries are needed, so we don't have to sort the whole list
     // sort is descending order
-    std::sort(scores.rbegin(), scores.rend(), [](const std::pair<arith_uint256, CDeterministicMNCPtr>& a, std::pair<arith_uint256, CDeterministicMNCPtr>& b) {
+    size_t resultSize = std::min(maxSize, scores.size());
+    std::partial_sort(scores.begin(), scores.begin() + resultSize, scores.end(), [](const std::pair<arith_uint256, CDeterministicMNCPtr>& a, const std::pair<arith_uint256, CDeterministicMNCPtr>& b) {
         if (a.first == b.first) {
             // this should actually never happen, but we should stay compatible with how the non deterministic MNs did the sorting
-            return a.second->collateralOutpoint < b.second->collateralOutpoint;
+            return b.second->collateralOutpoint < a.second->collateralOutpoint;
         }
-        return a.first < b.first;
+        return b.first < a.first;
     });
 
     // take top maxSize entries and return it
     std::vector<CDeterministicMNCPtr> result;
-    result.resize(std::min(maxSize, scores.size()));
+    result.resize(resultSize);
     for (size_t i = 0; i < result.size(); i++) {
         result[i] = std::move(scores[i].second);
     }
@@ -499,7 +501,9 @@ void CDeterministicMNList::RemoveMN(const uint256& proTxHash)
 }
 
 CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb) :
-    evoDb(_evoDb)
+    evoDb(_evoDb),
+    nSnapshotPeriod(std::max(1, (int)GetArg("-dmnsnapshotperiod", DEFAULT_SNAPSHOT_LIST_PERIOD))),
+    mnListsLRU(std::max((size_t)1, (size_t)GetArg("-dmnlistcachesize", DEFAULT_LISTS_LRU_SIZE)))
 {
 }
 
@@ -539,7 +543,7 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         diff = oldList.BuildDiff(newList);
 
         evoDb.Write(std::make_pair(DB_LIST_DIFF, newList.GetBlockHash()), diff);
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0 || oldList.GetHeight() == -1) {
+        if ((nHeight % nSnapshotPeriod) == 0 || oldList.GetHeight() == -1) {
             evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, newList.GetBlockHash()), newList);
             LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
                 __func__, nHeight, newList.GetAllMNsCount());
@@ -589,6 +593,8 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
         evoDb.Erase(std::make_pair(DB_LIST_SNAPSHOT, blockHash));
 
         mnListsCache.erase(blockHash);
+        mnListsCheckpoints.erase(std::make_pair(nHeight, blockHash));
+        mnListsLRU.erase(blockHash);
     }
 
     if (diff.HasChanges()) {
@@ -893,25 +899,32 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
     LOCK(cs);
 
     CDeterministicMNList snapshot;
+    if (GetCachedList(pindex, snapshot)) {
+        nListCacheHits++;
+        return snapshot;
+    }
+    nListCacheMisses++;
+
+    int64_t nTimeStart = GetTimeMicros();
+
+    const CBlockIndex* pindexRequested = pindex;
     std::list<std::pair<const CBlockIndex*, CDeterministicMNListDiff>> listDiff;
 
     while (true) {
         // try using cache before reading from disk
-        auto it = mnListsCache.find(pindex->GetBlockHash());
-        if (it != mnListsCache.end()) {
-            snapshot = it->second;
+        if (pindex != pindexRequested && GetCachedList(pindex, snapshot)) {
             break;
         }
 
         if (evoDb.Read(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), snapshot)) {
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            AddListToCache(pindex, snapshot, pindex == pindexRequested);
             break;
         }
 
         CDeterministicMNListDiff diff;
         if (!evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff)) {
             snapshot = CDeterministicMNList(pindex->GetBlockHash(), -1, 0);
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            AddListToCache(pindex, snapshot, pindex == pindexRequested);
             break;
         }
 
@@ -929,12 +942,53 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
             snapshot.SetHeight(diffIndex->nHeight);
         }
 
-        mnListsCache.emplace(diffIndex->GetBlockHash(), snapshot);
+        AddListToCache(diffIndex, snapshot, diffIndex == pindexRequested);
     }
 
+    int64_t nTime = GetTimeMicros() - nTimeStart;
+    nListDiffsApplied += listDiff.size();
+    nListRebuildTime += nTime;
+    LogPrint("bench", "CDeterministicMNManager::%s -- rebuilt list for block %s from %d diffs: %.2fms\n", __func__,
+             pindexRequested->GetBlockHash().ToString(), listDiff.size(), 0.001 * nTime);
+
     return snapshot;
 }
 
+bool CDeterministicMNManager::GetCachedList(const CBlockIndex* pindex, CDeterministicMNList& listRet)
+{
+    AssertLockHeld(cs);
+
+    auto it = mnListsCache.find(pindex->GetBlockHash());
+    if (it != mnListsCache.end()) {
+        listRet = it->second;
+        return true;
+    }
+    auto it2 = mnListsCheckpoints.find(std::make_pair(pindex->nHeight, pindex->GetBlockHash()));
+    if (it2 != mnListsCheckpoints.end()) {
+        listRet = it2->second;
+        return true;
+    }
+    return mnListsLRU.get(pindex->GetBlockHash(), listRet);
+}
+
+void CDeterministicMNManager::AddListToCache(const CBlockIndex* pindex, const CDeterministicMNList& list, bool fRequested)
+{
+    AssertLockHeld(cs);
+
+    // intermediate historic lists which are neither recent nor checkpoints are only needed once while rebuilding
+    // and would otherwise push out the lists that are actually used
+    if (!tipIndex || pindex->nHeight + LISTS_CACHE_SIZE >= tipIndex->nHeight) {
+        mnListsCache.emplace(pindex->GetBlockHash(), list);
+    } else if ((pindex->nHeight % LIST_CHECKPOINT_PERIOD) == 0) {
+        mnListsCheckpoints.emplace(std::make_pair(pindex->nHeight, pindex->GetBlockHash()), list);
+        if (mnListsCheckpoints.size() > MAX_LIST_CHECKPOINTS) {
+            mnListsCheckpoints.erase(mnListsCheckpoints.begin());
+        }
+    } else if (fRequested) {
+        mnListsLRU.insert(pindex->GetBlockHash(), list);
+    }
+}
+
 CDeterministicMNList CDeterministicMNManager::GetListAtChainTip()
 {
     LOCK(cs);
@@ -977,6 +1031,20 @@ bool CDeterministicMNManager::IsDIP3Enforced(int nHeight)
     return nHeight >= Params().GetConsensus().DIP0003EnforcementHeight;
 }
 
+void CDeterministicMNManager::GetListCacheStats(UniValue& obj)
+{
+    LOCK(cs);
+
+    obj.push_back(Pair("snapshotPeriod", nSnapshotPeriod));
+    obj.push_back(Pair("recentLists", (int64_t)mnListsCache.size()));
+    obj.push_back(Pair("checkpointLists", (int64_t)mnListsCheckpoints.size()));
+    obj.push_back(Pair("lruLists", (int64_t)mnListsLRU.size()));
+    obj.push_back(Pair("hits", nListCacheHits));
+    obj.push_back(Pair("misses", nListCacheMisses));
+    obj.push_back(Pair("diffsApplied", nListDiffsApplied));
+    obj.push_back(Pair("rebuildTime", nListRebuildTime * 0.000001));
+}
+
 void CDeterministicMNManager::CleanupCache(int nHeight)
 {
     AssertLockHeld(cs);
@@ -988,7 +1056,15 @@ void CDeterministicMNManager::CleanupCache(int nHeight)
         }
     }
     for (const auto& h : toDelete) {
-        mnListsCache.erase(h);
+        auto it = mnListsCache.find(h);
+        // lists leaving the recent window might still be useful as checkpoints
+        if ((it->second.GetHeight() % LIST_CHECKPOINT_PERIOD) == 0) {
+            mnListsCheckpoints.emplace(std::make_pair(it->second.GetHeight(), h), std::move(it->second));
+        }
+        mnListsCache.erase(it);
+    }
+    while (mnListsCheckpoints.size() > MAX_LIST_CHECKPOINTS) {
+        mnListsCheckpoints.erase(mnListsCheckpoints.begin());
     }
 }
 
@@ -1083,7 +1159,7 @@ void CDeterministicMNManager::UpgradeDBIfNeeded()
         CDeterministicMNList newMNList;
         UpgradeDiff(batch, pindex, curMNList, newMNList);
 
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0) {
+        if ((nHeight % nSnapshotPeriod) == 0) {
             batch.Write(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), newMNList);
             evoDb.GetRawDB().WriteBatch(batch);
             batch.Clear();
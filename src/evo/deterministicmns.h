@@ -10,8 +10,10 @@
 #include "dbwrapper.h"
 #include "evodb.h"
 #include "providertx.h"
+#include "saltedhasher.h"
 #include "simplifiedmns.h"
 #include "sync.h"
+#include "unordered_lru_cache.h"
 
 #include "immer/map.hpp"
 #include "immer/map_transient.hpp"
@@ -625,8 +627,17 @@ public:
 
 class CDeterministicMNManager
 {
-    static const int SNAPSHOT_LIST_PERIOD = 576; // once per day
+public:
+    static const int DEFAULT_SNAPSHOT_LIST_PERIOD = 576; // once per day
+    static const size_t DEFAULT_LISTS_LRU_SIZE = 256;
+
+private:
+    // lists of the last LISTS_CACHE_SIZE blocks below the tip
     static const int LISTS_CACHE_SIZE = 576;
+    // every LIST_CHECKPOINT_PERIOD-th historic list is kept, so that rebuilding an older list has to apply at most
+    // LIST_CHECKPOINT_PERIOD diffs instead of walking back to the last snapshot
+    static const int LIST_CHECKPOINT_PERIOD = 32;
+    static const size_t MAX_LIST_CHECKPOINTS = 1024;
 
 public:
     CCriticalSection cs;
@@ -634,7 +645,20 @@ public:
 private:
     CEvoDB& evoDb;
 
+    int nSnapshotPeriod;
+
+    // hot tier, trimmed by height in CleanupCache
     std::map<uint256, CDeterministicMNList> mnListsCache;
+    // sparse tier, ordered by height so that the oldest checkpoint is evicted first
+    std::map<std::pair<int, uint256>, CDeterministicMNList> mnListsCheckpoints;
+    // historic lists that were explicitly requested (e.g. by "protx diff" or mnlistdiff)
+    unordered_lru_cache<uint256, CDeterministicMNList, StaticSaltedHasher> mnListsLRU;
+
+    uint64_t nListCacheHits{0};
+    uint64_t nListCacheMisses{0};
+    uint64_t nListDiffsApplied{0};
+    int64_t nListRebuildTime{0};
+
     const CBlockIndex* tipIndex{nullptr};
 
 public:
@@ -658,12 +682,16 @@ public:
 
     bool IsDIP3Enforced(int nHeight = -1);
 
+    void GetListCacheStats(UniValue& obj);
+
 public:
     // TODO these can all be removed in a future version
     bool UpgradeDiff(CDBBatch& batch, const CBlockIndex* pindexNext, const CDeterministicMNList& curMNList, CDeterministicMNList& newMNList);
     void UpgradeDBIfNeeded();
 
 private:
+    bool GetCachedList(const CBlockIndex* pindex, CDeterministicMNList& listRet);
+    void AddListToCache(const CBlockIndex* pindex, const CDeterministicMNList& list, bool fRequested);
     void CleanupCache(int nHeight);
 };
 
@@ -14,7 +14,10 @@
 #include "base58.h"
 #include "chainparams.h"
 #include "consensus/merkle.h"
+#include "hash.h"
+#include "saltedhasher.h"
 #include "univalue.h"
+#include "unordered_lru_cache.h"
 #include "validation.h"
 
 CSimplifiedMNListEntry::CSimplifiedMNListEntry(const CDeterministicMN& dmn) :
@@ -88,6 +91,104 @@ uint256 CSimplifiedMNList::CalcMerkleRoot(bool* pmutated) const
     return ComputeMerkleRoot(leaves, pmutated);
 }
 
+uint256 CSimplifiedMNListMerkleTree::CalcMerkleRoot(const CDeterministicMNList& mnList, bool* pmutated)
+{
+    std::vector<CDeterministicMNCPtr> dmns;
+    dmns.reserve(mnList.GetAllMNsCount());
+    mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+        dmns.emplace_back(dmn);
+    });
+    std::sort(dmns.begin(), dmns.end(), [](const CDeterministicMNCPtr& a, const CDeterministicMNCPtr& b) {
+        return a->proTxHash.Compare(b->proTxHash) < 0;
+    });
+
+    LOCK(cs);
+
+    // Build the new leaves, only hashing entries which changed. Both lists are sorted, so we can walk them in parallel
+    std::vector<Leaf> newLeaves;
+    std::vector<uint256> newHashes;
+    newLeaves.reserve(dmns.size());
+    newHashes.reserve(dmns.size());
+    std::vector<size_t> dirty;
+    size_t oldIdx = 0;
+    for (size_t i = 0; i < dmns.size(); i++) {
+        const auto& dmn = dmns[i];
+        while (oldIdx < leaves.size() && leaves[oldIdx].proRegTxHash.Compare(dmn->proTxHash) < 0) {
+            oldIdx++;
+        }
+        uint256 hash;
+        if (oldIdx < leaves.size() && leaves[oldIdx].proRegTxHash == dmn->proTxHash && leaves[oldIdx].pdmnState == dmn->pdmnState) {
+            hash = levels[0][oldIdx];
+        } else {
+            hash = CSimplifiedMNListEntry(*dmn).CalcHash();
+        }
+        if (levels.empty() || i >= levels[0].size() || levels[0][i] != hash) {
+            dirty.emplace_back(i);
+        }
+        newLeaves.push_back(Leaf{dmn->proTxHash, dmn->pdmnState});
+        newHashes.emplace_back(hash);
+    }
+
+    size_t oldSize = levels.empty() ? 0 : levels[0].size();
+    leaves = std::move(newLeaves);
+    if (levels.empty()) {
+        levels.emplace_back();
+    }
+    levels[0] = std::move(newHashes);
+
+    // Recalculate all parents of dirty nodes, level by level
+    size_t level = 0;
+    while (levels[level].size() > 1) {
+        if (levels.size() == level + 1) {
+            levels.emplace_back();
+        }
+        const auto& children = levels[level];
+        auto& parents = levels[level + 1];
+        size_t parentsSize = (children.size() + 1) / 2;
+        size_t oldParentsSize = parents.size();
+
+        std::vector<size_t> dirtyParents;
+        dirtyParents.reserve(dirty.size() + 1);
+        for (size_t idx : dirty) {
+            if (dirtyParents.empty() || dirtyParents.back() != idx / 2) {
+                dirtyParents.emplace_back(idx / 2);
+            }
+        }
+        if (children.size() != oldSize) {
+            // the last node might have lost or gained its sibling
+            size_t lastParent = parentsSize - 1;
+            if (dirtyParents.empty() || dirtyParents.back() < lastParent) {
+                dirtyParents.emplace_back(lastParent);
+            }
+        }
+
+        parents.resize(parentsSize);
+        mutatedNodes.erase(mutatedNodes.lower_bound(std::make_pair(level + 1, parentsSize)),
+                           mutatedNodes.lower_bound(std::make_pair(level + 2, (size_t)0)));
+        for (size_t p : dirtyParents) {
+            size_t left = p * 2;
+            size_t right = std::min(left + 1, children.size() - 1);
+            parents[p] = Hash(children[left].begin(), children[left].end(), children[right].begin(), children[right].end());
+            if (right != left && children[left] == children[right]) {
+                mutatedNodes.emplace(level + 1, p);
+            } else {
+                mutatedNodes.erase(std::make_pair(level + 1, p));
+            }
+        }
+
+        dirty = std::move(dirtyParents);
+        oldSize = oldParentsSize;
+        level++;
+    }
+    levels.resize(level + 1);
+    mutatedNodes.erase(mutatedNodes.lower_bound(std::make_pair(level + 1, (size_t)0)), mutatedNodes.end());
+
+    if (pmutated) {
+        *pmutated = !mutatedNodes.empty();
+    }
+    return levels[0].empty() ? uint256() : levels.back()[0];
+}
+
 CSimplifiedMNListDiff::CSimplifiedMNListDiff()
 {
 }
@@ -185,6 +286,30 @@ void CSimplifiedMNListDiff::ToJson(UniValue& obj) const
     }
 }
 
+static const std::string DB_COINBASE_PROOF = "smle_cbp";
+
+// Recently built diffs, keyed by the hash of (baseBlockHash, blockHash). Protected by cs_main.
+// A diff between two blocks never changes, so entries don't need to be invalidated on reorgs.
+static unordered_lru_cache<uint256, CSimplifiedMNListDiff, StaticSaltedHasher, 128> mnListDiffCache;
+
+void WriteCoinbaseProof(const CBlock& block, const CBlockIndex* pindex)
+{
+    std::vector<uint256> vHashes;
+    vHashes.reserve(block.vtx.size());
+    for (const auto& tx : block.vtx) {
+        vHashes.emplace_back(tx->GetHash());
+    }
+    std::vector<bool> vMatch(block.vtx.size(), false);
+    vMatch[0] = true; // only coinbase matches
+
+    evoDb->Write(std::make_pair(DB_COINBASE_PROOF, pindex->GetBlockHash()), std::make_pair(block.vtx[0], CPartialMerkleTree(vHashes, vMatch)));
+}
+
+void EraseCoinbaseProof(const CBlockIndex* pindex)
+{
+    evoDb->Erase(std::make_pair(DB_COINBASE_PROOF, pindex->GetBlockHash()));
+}
+
 bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& blockHash, CSimplifiedMNListDiff& mnListDiffRet, std::string& errorRet)
 {
     AssertLockHeld(cs_main);
@@ -215,6 +340,11 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
         return false;
     }
 
+    uint256 cacheKey = ::SerializeHash(std::make_pair(baseBlockHash, blockHash));
+    if (mnListDiffCache.get(cacheKey, mnListDiffRet)) {
+        return true;
+    }
+
     LOCK(deterministicMNManager->cs);
 
     auto baseDmnList = deterministicMNManager->GetListForBlock(baseBlockIndex);
@@ -231,22 +361,30 @@ bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& bloc
         return false;
     }
 
-    // TODO store coinbase TX in CBlockIndex
-    CBlock block;
-    if (!ReadBlockFromDisk(block, blockIndex, Params().GetConsensus())) {
-        errorRet = strprintf("failed to read block %s from disk", blockHash.ToString());
-        return false;
-    }
+    std::pair<CTransactionRef, CPartialMerkleTree> coinbaseProof;
+    if (evoDb->Read(std::make_pair(DB_COINBASE_PROOF, blockHash), coinbaseProof)) {
+        mnListDiffRet.cbTx = coinbaseProof.first;
+        mnListDiffRet.cbTxMerkleTree = coinbaseProof.second;
+    } else {
+        // blocks connected before the coinbase proofs were stored
+        CBlock block;
+        if (!ReadBlockFromDisk(block, blockIndex, Params().GetConsensus())) {
+            errorRet = strprintf("failed to read block %s from disk", blockHash.ToString());
+            return false;
+        }
 
-    mnListDiffRet.cbTx = block.vtx[0];
+        mnListDiffRet.cbTx = block.vtx[0];
 
-    std::vector<uint256> vHashes;
-    std::vector<bool> vMatch(block.vtx.size(), false);
-    for (const auto& tx : block.vtx) {
-        vHashes.emplace_back(tx->GetHash());
+        std::vector<uint256> vHashes;
+        std::vector<bool> vMatch(block.vtx.size(), false);
+        for (const auto& tx : block.vtx) {
+            vHashes.emplace_back(tx->GetHash());
+        }
+        vMatch[0] = true; // only coinbase matches
+        mnListDiffRet.cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
     }
-    vMatch[0] = true; // only coinbase matches
-    mnListDiffRet.cbTxMerkleTree = CPartialMerkleTree(vHashes, vMatch);
+
+    mnListDiffCache.insert(cacheKey, mnListDiffRet);
 
     return true;
 }
@@ -10,11 +10,17 @@
 #include "netaddress.h"
 #include "pubkey.h"
 #include "serialize.h"
+#include "sync.h"
 #include "version.h"
 
+#include <set>
+
 class UniValue;
+class CBlock;
+class CBlockIndex;
 class CDeterministicMNList;
 class CDeterministicMN;
+class CDeterministicMNState;
 
 namespace llmq
 {
@@ -84,6 +90,33 @@ public:
     uint256 CalcMerkleRoot(bool* pmutated = NULL) const;
 };
 
+/**
+ * Merkle tree over the simplified MN list, kept in memory between calculations. Only the leaves which differ from
+ * the previously calculated list and the nodes above them are rehashed. As the tree is always compared against the
+ * list it was last built from, it is not bound to a specific chain and also handles reorgs and calculations for
+ * different tips (e.g. mining and block validation).
+ */
+class CSimplifiedMNListMerkleTree
+{
+private:
+    struct Leaf {
+        uint256 proRegTxHash;
+        std::shared_ptr<const CDeterministicMNState> pdmnState;
+    };
+
+    CCriticalSection cs;
+    // sorted by proRegTxHash, same as CSimplifiedMNList
+    std::vector<Leaf> leaves;
+    // levels[0] are the entry hashes, levels.back() holds the root
+    std::vector<std::vector<uint256>> levels;
+    // (level, index) of nodes which were built from two identical children, see ComputeMerkleRoot
+    std::set<std::pair<size_t, size_t>> mutatedNodes;
+
+public:
+    // result is identical to CSimplifiedMNList(mnList).CalcMerkleRoot(pmutated)
+    uint256 CalcMerkleRoot(const CDeterministicMNList& mnList, bool* pmutated = nullptr);
+};
+
 /// P2P messages
 
 class CGetSimplifiedMNListDiff
@@ -147,4 +180,9 @@ public:
 
 bool BuildSimplifiedMNListDiff(const uint256& baseBlockHash, const uint256& blockHash, CSimplifiedMNListDiff& mnListDiffRet, std::string& errorRet);
 
+// Stores the coinbase transaction of a block together with its partial merkle tree in evoDb, so that
+// BuildSimplifiedMNListDiff doesn't have to read and hash the whole block for every request
+void WriteCoinbaseProof(const CBlock& block, const CBlockIndex* pindex);
+void EraseCoinbaseProof(const CBlockIndex* pindex);
+
 #endif //DASH_SIMPLIFIEDMNS_H
@@ -129,6 +129,11 @@ bool ProcessSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex, CV
     int64_t nTime5 = GetTimeMicros(); nTimeMerkle += nTime5 - nTime4;
     LogPrint("bench", "        - CheckCbTxMerkleRoots: %.2fms [%.2fs]\n", 0.001 * (nTime5 - nTime4), nTimeMerkle * 0.000001);
 
+    // only blocks with a CbTx can be the target of a mnlistdiff
+    if (!fJustCheck && block.vtx[0]->nType == TRANSACTION_COINBASE) {
+        WriteCoinbaseProof(block, pindex);
+    }
+
     return true;
 }
 
@@ -149,6 +154,10 @@ bool UndoSpecialTxsInBlock(const CBlock& block, const CBlockIndex* pindex)
         return false;
     }
 
+    if (block.vtx[0]->nType == TRANSACTION_COINBASE) {
+        EraseCoinbaseProof(pindex);
+    }
+
     return true;
 }
 
@@ -181,6 +181,7 @@ void CGovernanceTriggerManager::CleanAndRemove()
                 if (pObj->nDeletionTime == 0) {
                     pObj->nDeletionTime = GetAdjustedTime();
                 }
+                governance.MarkObjectDirty(pObj->GetHash());
             }
             // delete the trigger
             mapTrigger.erase(it++);
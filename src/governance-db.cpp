@@ -0,0 +1,181 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "governance-db.h"
+
+#include "util.h"
+
+CGovernanceDb* governanceDb;
+
+static const std::string DB_VERSION = "gov_version";
+static const std::string DB_OBJECT = "gov_o";
+static const std::string DB_VOTE = "gov_v";
+static const std::string DB_VOTE_RECORD = "gov_r";
+
+// Serializes a governance object without its votes and vote records, as these are stored separately
+class CGovernanceObjectRecord
+{
+private:
+    CGovernanceObject& govobj;
+
+public:
+    explicit CGovernanceObjectRecord(CGovernanceObject& _govobj) : govobj(_govobj) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        govobj.SerializationOpRecord(s, ser_action);
+    }
+};
+
+CGovernanceDb::CGovernanceDb(size_t nCacheSize, bool fMemory, bool fWipe) :
+    db(fMemory ? "" : (GetDataDir() / "governance"), nCacheSize, fMemory, fWipe)
+{
+}
+
+bool CGovernanceDb::HasCurrentVersion()
+{
+    int nVersion{0};
+    return db.Read(DB_VERSION, nVersion) && nVersion == CURRENT_VERSION;
+}
+
+void CGovernanceDb::WriteCurrentVersion()
+{
+    db.Write(DB_VERSION, CURRENT_VERSION);
+}
+
+void CGovernanceDb::WriteObject(CDBBatch& batch, const CGovernanceObject& govobj)
+{
+    batch.Write(std::make_tuple(DB_OBJECT, govobj.GetHash()), CGovernanceObjectRecord(const_cast<CGovernanceObject&>(govobj)));
+}
+
+void CGovernanceDb::EraseObject(CDBBatch& batch, const uint256& nHash)
+{
+    batch.Erase(std::make_tuple(DB_OBJECT, nHash));
+
+    ForEachVoteHash(nHash, [&](const uint256& nVoteHash) {
+        EraseVote(batch, nHash, nVoteHash);
+    });
+
+    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
+    auto firstKey = std::make_tuple(DB_VOTE_RECORD, nHash, COutPoint());
+    it->Seek(firstKey);
+    while (it->Valid()) {
+        decltype(firstKey) curKey;
+        if (!it->GetKey(curKey) || std::get<0>(curKey) != DB_VOTE_RECORD || std::get<1>(curKey) != nHash) {
+            break;
+        }
+        batch.Erase(curKey);
+        it->Next();
+    }
+}
+
+void CGovernanceDb::WriteVote(CDBBatch& batch, const CGovernanceVote& vote)
+{
+    batch.Write(std::make_tuple(DB_VOTE, vote.GetParentHash(), vote.GetHash()), vote);
+}
+
+void CGovernanceDb::EraseVote(CDBBatch& batch, const uint256& nParentHash, const uint256& nVoteHash)
+{
+    batch.Erase(std::make_tuple(DB_VOTE, nParentHash, nVoteHash));
+}
+
+bool CGovernanceDb::HasVote(const uint256& nParentHash, const uint256& nVoteHash)
+{
+    return db.Exists(std::make_tuple(DB_VOTE, nParentHash, nVoteHash));
+}
+
+bool CGovernanceDb::ReadVote(const uint256& nParentHash, const uint256& nVoteHash, CGovernanceVote& vote)
+{
+    return db.Read(std::make_tuple(DB_VOTE, nParentHash, nVoteHash), vote);
+}
+
+std::vector<CGovernanceVote> CGovernanceDb::ReadVotes(const uint256& nParentHash)
+{
+    std::vector<CGovernanceVote> vecVotes;
+
+    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
+    auto firstKey = std::make_tuple(DB_VOTE, nParentHash, uint256());
+    it->Seek(firstKey);
+    while (it->Valid()) {
+        decltype(firstKey) curKey;
+        if (!it->GetKey(curKey) || std::get<0>(curKey) != DB_VOTE || std::get<1>(curKey) != nParentHash) {
+            break;
+        }
+        vecVotes.emplace_back();
+        if (!it->GetValue(vecVotes.back())) {
+            vecVotes.pop_back();
+            break;
+        }
+        it->Next();
+    }
+
+    return vecVotes;
+}
+
+void CGovernanceDb::WriteVoteRecord(CDBBatch& batch, const uint256& nParentHash, const COutPoint& mnOutpoint, const vote_rec_t& voteRecord)
+{
+    batch.Write(std::make_tuple(DB_VOTE_RECORD, nParentHash, mnOutpoint), voteRecord);
+}
+
+void CGovernanceDb::EraseVoteRecord(CDBBatch& batch, const uint256& nParentHash, const COutPoint& mnOutpoint)
+{
+    batch.Erase(std::make_tuple(DB_VOTE_RECORD, nParentHash, mnOutpoint));
+}
+
+void CGovernanceDb::ForEachObject(std::function<void(CGovernanceObject& govobj)>&& func)
+{
+    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
+    auto firstKey = std::make_tuple(DB_OBJECT, uint256());
+    it->Seek(firstKey);
+    while (it->Valid()) {
+        decltype(firstKey) curKey;
+        if (!it->GetKey(curKey) || std::get<0>(curKey) != DB_OBJECT) {
+            break;
+        }
+        CGovernanceObject govobj;
+        CGovernanceObjectRecord record(govobj);
+        if (!it->GetValue(record)) {
+            LogPrintf("CGovernanceDb::%s -- failed to read object %s\n", __func__, std::get<1>(curKey).ToString());
+        } else {
+            func(govobj);
+        }
+        it->Next();
+    }
+}
+
+void CGovernanceDb::ForEachVoteRecord(std::function<void(const uint256& nParentHash, const COutPoint& mnOutpoint, const vote_rec_t& voteRecord)>&& func)
+{
+    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
+    auto firstKey = std::make_tuple(DB_VOTE_RECORD, uint256(), COutPoint());
+    it->Seek(firstKey);
+    while (it->Valid()) {
+        decltype(firstKey) curKey;
+        if (!it->GetKey(curKey) || std::get<0>(curKey) != DB_VOTE_RECORD) {
+            break;
+        }
+        vote_rec_t voteRecord;
+        if (it->GetValue(voteRecord)) {
+            func(std::get<1>(curKey), std::get<2>(curKey), voteRecord);
+        }
+        it->Next();
+    }
+}
+
+void CGovernanceDb::ForEachVoteHash(const uint256& nParentHash, std::function<void(const uint256& nVoteHash)>&& func)
+{
+    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
+    auto firstKey = std::make_tuple(DB_VOTE, nParentHash, uint256());
+    it->Seek(firstKey);
+    while (it->Valid()) {
+        decltype(firstKey) curKey;
+        if (!it->GetKey(curKey) || std::get<0>(curKey) != DB_VOTE || std::get<1>(curKey) != nParentHash) {
+            break;
+        }
+        func(std::get<2>(curKey));
+        it->Next();
+    }
+}
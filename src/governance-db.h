@@ -0,0 +1,75 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GOVERNANCE_DB_H
+#define GOVERNANCE_DB_H
+
+#include "dbwrapper.h"
+#include "governance-object.h"
+#include "governance-vote.h"
+
+#include <functional>
+
+class CGovernanceDb;
+
+extern CGovernanceDb* governanceDb;
+
+/**
+ * Keyed, incremental storage for governance objects and votes, replacing the monolithic governance.dat.
+ *
+ * Objects are stored without their votes. Each vote and each per masternode vote record (used for vote tallies) is
+ * stored as its own entry and written when the vote is accepted. On startup, objects and vote records are loaded,
+ * while vote files are only loaded on first use (see CGovernanceObject::GetVoteFile). Caches of the governance
+ * manager which are not worth storing incrementally are written as a whole from time to time.
+ */
+class CGovernanceDb
+{
+public:
+    static const int CURRENT_VERSION = 1;
+
+private:
+    CDBWrapper db;
+
+public:
+    CGovernanceDb(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    // Returns false if nothing was stored yet (or by an incompatible version)
+    bool HasCurrentVersion();
+    void WriteCurrentVersion();
+
+    void WriteObject(CDBBatch& batch, const CGovernanceObject& govobj);
+    // Also erases all votes and vote records of the object
+    void EraseObject(CDBBatch& batch, const uint256& nHash);
+
+    void WriteVote(CDBBatch& batch, const CGovernanceVote& vote);
+    void EraseVote(CDBBatch& batch, const uint256& nParentHash, const uint256& nVoteHash);
+    bool HasVote(const uint256& nParentHash, const uint256& nVoteHash);
+    bool ReadVote(const uint256& nParentHash, const uint256& nVoteHash, CGovernanceVote& vote);
+    std::vector<CGovernanceVote> ReadVotes(const uint256& nParentHash);
+
+    void WriteVoteRecord(CDBBatch& batch, const uint256& nParentHash, const COutPoint& mnOutpoint, const vote_rec_t& voteRecord);
+    void EraseVoteRecord(CDBBatch& batch, const uint256& nParentHash, const COutPoint& mnOutpoint);
+
+    void ForEachObject(std::function<void(CGovernanceObject& govobj)>&& func);
+    void ForEachVoteRecord(std::function<void(const uint256& nParentHash, const COutPoint& mnOutpoint, const vote_rec_t& voteRecord)>&& func);
+    // Only reads keys, the votes themselves are not deserialized
+    void ForEachVoteHash(const uint256& nParentHash, std::function<void(const uint256& nVoteHash)>&& func);
+
+    template <typename V>
+    void WriteState(CDBBatch& batch, const std::string& strName, const V& value)
+    {
+        batch.Write(std::make_pair(std::string("gov_s"), strName), value);
+    }
+
+    template <typename V>
+    bool ReadState(const std::string& strName, V& value)
+    {
+        return db.Read(std::make_pair(std::string("gov_s"), strName), value);
+    }
+
+    bool WriteBatch(CDBBatch& batch) { return db.WriteBatch(batch); }
+    CDBWrapper& GetRawDB() { return db; }
+};
+
+#endif
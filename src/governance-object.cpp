@@ -5,9 +5,11 @@
 #include "governance-object.h"
 #include "core_io.h"
 #include "governance-classes.h"
+#include "governance-db.h"
 #include "governance-validators.h"
 #include "governance-vote.h"
 #include "governance.h"
+#include "hash.h"
 #include "masternode-meta.h"
 #include "masternode-sync.h"
 #include "messagesigner.h"
@@ -40,7 +42,10 @@ CGovernanceObject::CGovernanceObject() :
     fUnparsable(false),
     mapCurrentMNVotes(),
     cmmapOrphanVotes(),
-    fileVotes()
+    fileVotes(),
+    fVoteFileLoaded(true),
+    nStoredDeletionTime(0),
+    fStoredExpired(false)
 {
     // PARSE JSON DATA STORAGE (VCHDATA)
     LoadData();
@@ -68,7 +73,10 @@ CGovernanceObject::CGovernanceObject(const uint256& nHashParentIn, int nRevision
     fUnparsable(false),
     mapCurrentMNVotes(),
     cmmapOrphanVotes(),
-    fileVotes()
+    fileVotes(),
+    fVoteFileLoaded(true),
+    nStoredDeletionTime(0),
+    fStoredExpired(false)
 {
     // PARSE JSON DATA STORAGE (VCHDATA)
     LoadData();
@@ -96,17 +104,23 @@ CGovernanceObject::CGovernanceObject(const CGovernanceObject& other) :
     fUnparsable(other.fUnparsable),
     mapCurrentMNVotes(other.mapCurrentMNVotes),
     cmmapOrphanVotes(other.cmmapOrphanVotes),
-    fileVotes(other.fileVotes)
+    fileVotes(other.fileVotes),
+    fVoteFileLoaded(other.fVoteFileLoaded),
+    nStoredDeletionTime(other.nStoredDeletionTime),
+    fStoredExpired(other.fStoredExpired)
 {
 }
 
 bool CGovernanceObject::ProcessVote(CNode* pfrom,
     const CGovernanceVote& vote,
     CGovernanceException& exception,
-    CConnman& connman)
+    CConnman& connman,
+    const uint256& nVerifiedKeyHash)
 {
     LOCK(cs);
 
+    LoadVoteFile();
+
     // do not process already known valid votes twice
     if (fileVotes.HasVote(vote.GetHash())) {
         // nothing to do here, not an error
@@ -195,8 +209,9 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
 
     bool onlyVotingKeyAllowed = nObjectType == GOVERNANCE_OBJECT_PROPOSAL && vote.GetSignal() == VOTE_SIGNAL_FUNDING;
 
-    // Finally check that the vote is actually valid (done last because of cost of signature verification)
-    if (!vote.IsValid(onlyVotingKeyAllowed)) {
+    // Finally check that the vote is actually valid (done last because of cost of signature verification, unless the
+    // signature was already verified in a batch against the key which is still current)
+    if (!vote.IsValid(onlyVotingKeyAllowed, nVerifiedKeyHash)) {
         std::ostringstream ostr;
         ostr << "CGovernanceObject::ProcessVote -- Invalid vote"
              << ", MN outpoint = " << vote.GetMasternodeOutpoint().ToStringShort()
@@ -219,8 +234,18 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
     }
 
     voteInstanceRef = vote_instance_t(vote.GetOutcome(), nVoteTimeUpdate, vote.GetTimestamp());
-    fileVotes.AddVote(vote);
+    auto replacedVotes = fileVotes.AddVote(vote);
     fDirtyCache = true;
+
+    if (governanceDb) {
+        CDBBatch batch(governanceDb->GetRawDB());
+        governanceDb->WriteVote(batch, vote);
+        for (const auto& nReplacedHash : replacedVotes) {
+            governanceDb->EraseVote(batch, vote.GetParentHash(), nReplacedHash);
+        }
+        governanceDb->WriteVoteRecord(batch, vote.GetParentHash(), vote.GetMasternodeOutpoint(), voteRecordRef);
+        governanceDb->WriteBatch(batch);
+    }
     return true;
 }
 
@@ -230,58 +255,189 @@ void CGovernanceObject::ClearMasternodeVotes()
 
     auto mnList = deterministicMNManager->GetListAtChainTip();
 
+    std::unique_ptr<CDBBatch> batch;
+    if (governanceDb) {
+        batch.reset(new CDBBatch(governanceDb->GetRawDB()));
+    }
+
+    uint256 nParentHash = GetHash();
     vote_m_it it = mapCurrentMNVotes.begin();
     while (it != mapCurrentMNVotes.end()) {
         if (!mnList.HasMNByCollateral(it->first)) {
-            fileVotes.RemoveVotesFromMasternode(it->first);
+            LoadVoteFile();
+            auto removedVotes = fileVotes.RemoveVotesFromMasternode(it->first);
+            if (batch) {
+                for (const auto& nVoteHash : removedVotes) {
+                    governanceDb->EraseVote(*batch, nParentHash, nVoteHash);
+                }
+                governanceDb->EraseVoteRecord(*batch, nParentHash, it->first);
+            }
             mapCurrentMNVotes.erase(it++);
         } else {
             ++it;
         }
     }
+
+    if (batch && batch->SizeEstimate() != 0) {
+        governanceDb->WriteBatch(*batch);
+    }
 }
 
-std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const COutPoint& mnOutpoint)
+std::vector<CGovernanceVote> CGovernanceObject::GetVotesOfMasternodes(const std::set<COutPoint>& setMasternodes)
 {
     LOCK(cs);
 
-    auto it = mapCurrentMNVotes.find(mnOutpoint);
-    if (it == mapCurrentMNVotes.end()) {
-        // don't even try as we don't have any votes from this MN
+    // don't even try for MNs we don't have any votes from
+    std::set<COutPoint> setVotedMasternodes;
+    for (const auto& mnOutpoint : setMasternodes) {
+        if (mapCurrentMNVotes.count(mnOutpoint)) {
+            setVotedMasternodes.emplace(mnOutpoint);
+        }
+    }
+    if (setVotedMasternodes.empty()) {
         return {};
     }
 
-    auto removedVotes = fileVotes.RemoveInvalidVotes(mnOutpoint, nObjectType == GOVERNANCE_OBJECT_PROPOSAL);
+    LoadVoteFile();
+    return fileVotes.GetVotesOfMasternodes(setVotedMasternodes);
+}
+
+std::set<uint256> CGovernanceObject::RemoveInvalidVotes(const std::vector<CGovernanceVote>& vecInvalidVotes)
+{
+    LOCK(cs);
+
+    std::set<COutPoint> setVotedMasternodes;
+    std::set<uint256> setVoteHashes;
+    for (const auto& vote : vecInvalidVotes) {
+        if (mapCurrentMNVotes.count(vote.GetMasternodeOutpoint())) {
+            setVotedMasternodes.emplace(vote.GetMasternodeOutpoint());
+        }
+        setVoteHashes.emplace(vote.GetHash());
+    }
+
+    LoadVoteFile();
+    auto removedVotes = fileVotes.RemoveVotes(setVoteHashes);
     if (removedVotes.empty()) {
         return {};
     }
 
+    std::unique_ptr<CDBBatch> batch;
+    if (governanceDb) {
+        batch.reset(new CDBBatch(governanceDb->GetRawDB()));
+    }
+
     auto nParentHash = GetHash();
-    for (auto jt = it->second.mapInstances.begin(); jt != it->second.mapInstances.end(); ) {
-        CGovernanceVote tmpVote(mnOutpoint, nParentHash, (vote_signal_enum_t)jt->first, jt->second.eOutcome);
-        tmpVote.SetTime(jt->second.nCreationTime);
-        if (removedVotes.count(tmpVote.GetHash())) {
-            jt = it->second.mapInstances.erase(jt);
-        } else {
-            ++jt;
+    for (const auto& mnOutpoint : setVotedMasternodes) {
+        auto it = mapCurrentMNVotes.find(mnOutpoint);
+        bool fChanged = false;
+        for (auto jt = it->second.mapInstances.begin(); jt != it->second.mapInstances.end(); ) {
+            CGovernanceVote tmpVote(mnOutpoint, nParentHash, (vote_signal_enum_t)jt->first, jt->second.eOutcome);
+            tmpVote.SetTime(jt->second.nCreationTime);
+            if (removedVotes.count(tmpVote.GetHash())) {
+                jt = it->second.mapInstances.erase(jt);
+                fChanged = true;
+            } else {
+                ++jt;
+            }
+        }
+        if (!fChanged) {
+            continue;
+        }
+
+        if (batch) {
+            if (it->second.mapInstances.empty()) {
+                governanceDb->EraseVoteRecord(*batch, nParentHash, mnOutpoint);
+            } else {
+                governanceDb->WriteVoteRecord(*batch, nParentHash, mnOutpoint, it->second);
+            }
+        }
+        if (it->second.mapInstances.empty()) {
+            mapCurrentMNVotes.erase(it);
         }
-    }
-    if (it->second.mapInstances.empty()) {
-        mapCurrentMNVotes.erase(it);
     }
 
-    if (!removedVotes.empty()) {
-        std::string removedStr;
-        for (auto& h : removedVotes) {
-            removedStr += strprintf("  %s\n", h.ToString());
+    if (batch) {
+        for (const auto& nVoteHash : removedVotes) {
+            governanceDb->EraseVote(*batch, nParentHash, nVoteHash);
         }
-        LogPrintf("CGovernanceObject::%s -- Removed %d invalid votes for %s from MN %s:\n%s", __func__, removedVotes.size(), nParentHash.ToString(), mnOutpoint.ToString(), removedStr);
-        fDirtyCache = true;
+        governanceDb->WriteBatch(*batch);
+    }
+
+    std::string removedStr;
+    for (auto& h : removedVotes) {
+        removedStr += strprintf("  %s\n", h.ToString());
     }
+    LogPrintf("CGovernanceObject::%s -- Removed %d invalid votes for %s:\n%s", __func__, removedVotes.size(), nParentHash.ToString(), removedStr);
+    fDirtyCache = true;
 
     return removedVotes;
 }
 
+void CGovernanceObject::LoadVoteFile() const
+{
+    LOCK(cs);
+
+    if (fVoteFileLoaded) {
+        return;
+    }
+    fVoteFileLoaded = true;
+
+    if (governanceDb) {
+        fileVotes.LoadVotes(governanceDb->ReadVotes(GetHash()));
+        LogPrint("gobject", "CGovernanceObject::%s -- loaded %d votes for %s\n", __func__, fileVotes.GetVoteCount(), GetHash().ToString());
+    }
+}
+
+const CGovernanceObjectVoteFile& CGovernanceObject::GetVoteFile() const
+{
+    LoadVoteFile();
+    return fileVotes;
+}
+
+bool CGovernanceObject::HasVote(const uint256& nHash) const
+{
+    LOCK(cs);
+
+    if (!fVoteFileLoaded && governanceDb) {
+        return governanceDb->HasVote(GetHash(), nHash);
+    }
+    return fileVotes.HasVote(nHash);
+}
+
+void CGovernanceObject::GetVoteSetHash(int& nVoteCountRet, uint256& nVoteSetHashRet) const
+{
+    LOCK(cs);
+
+    if (!fVoteFileLoaded && governanceDb) {
+        // vote keys are iterated in the same order as CGovernanceObjectVoteFile::mapVoteIndex
+        CHashWriter hw(SER_GETHASH, 0);
+        nVoteCountRet = 0;
+        governanceDb->ForEachVoteHash(GetHash(), [&](const uint256& nVoteHash) {
+            hw << nVoteHash;
+            ++nVoteCountRet;
+        });
+        nVoteSetHashRet = hw.GetHash();
+        return;
+    }
+    nVoteCountRet = fileVotes.GetVoteCount();
+    nVoteSetHashRet = fileVotes.GetVoteSetHash();
+}
+
+bool CGovernanceObject::SerializeVoteToStream(const uint256& nHash, CDataStream& ss) const
+{
+    LOCK(cs);
+
+    if (!fVoteFileLoaded && governanceDb) {
+        CGovernanceVote vote;
+        if (!governanceDb->ReadVote(GetHash(), nHash, vote)) {
+            return false;
+        }
+        ss << vote;
+        return true;
+    }
+    return fileVotes.SerializeVoteToStream(nHash, ss);
+}
+
 std::string CGovernanceObject::GetSignatureMessage() const
 {
     LOCK(cs);
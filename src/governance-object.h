@@ -26,6 +26,7 @@ class CGovernanceVote;
 static const int MIN_GOVERNANCE_PEER_PROTO_VERSION = 70213;
 static const int GOVERNANCE_FILTER_PROTO_VERSION = 70206;
 static const int GOVERNANCE_POSE_BANNED_VOTES_VERSION = 70215;
+static const int GOVERNANCE_VOTE_SKETCH_PROTO_VERSION = 70221;
 
 static const double GOVERNANCE_FILTER_FP_RATE = 0.001;
 
@@ -183,7 +184,13 @@ private:
     /// Limited map of votes orphaned by MN
     vote_cmm_t cmmapOrphanVotes;
 
-    CGovernanceObjectVoteFile fileVotes;
+    /// Loaded on demand when the object was loaded from the governance db, see GetVoteFile()
+    mutable CGovernanceObjectVoteFile fileVotes;
+    mutable bool fVoteFileLoaded;
+
+    /// Values of nDeletionTime and fExpired when the object was last written to the governance db
+    int64_t nStoredDeletionTime;
+    bool fStoredExpired;
 
 public:
     CGovernanceObject();
@@ -249,10 +256,12 @@ public:
         return fExpired;
     }
 
-    const CGovernanceObjectVoteFile& GetVoteFile() const
-    {
-        return fileVotes;
-    }
+    const CGovernanceObjectVoteFile& GetVoteFile() const;
+
+    // These don't require the vote file to be loaded
+    bool HasVote(const uint256& nHash) const;
+    void GetVoteSetHash(int& nVoteCountRet, uint256& nVoteSetHashRet) const;
+    bool SerializeVoteToStream(const uint256& nHash, CDataStream& ss) const;
 
     // Signature related functions
 
@@ -332,24 +341,44 @@ public:
         // AFTER DESERIALIZATION OCCURS, CACHED VARIABLES MUST BE CALCULATED MANUALLY
     }
 
+    // Format used by the governance db, votes and vote records are stored separately
+    template <typename Stream, typename Operation>
+    inline void SerializationOpRecord(Stream& s, Operation ser_action)
+    {
+        READWRITE(nHashParent);
+        READWRITE(nRevision);
+        READWRITE(nTime);
+        READWRITE(nCollateralHash);
+        READWRITE(vchData);
+        READWRITE(nObjectType);
+        READWRITE(masternodeOutpoint);
+        READWRITE(vchSig);
+        READWRITE(nDeletionTime);
+        READWRITE(fExpired);
+    }
+
 private:
     // FUNCTIONS FOR DEALING WITH DATA STRING
     void LoadData();
     void GetData(UniValue& objResult);
 
+    void LoadVoteFile() const;
+
     bool ProcessVote(CNode* pfrom,
         const CGovernanceVote& vote,
         CGovernanceException& exception,
-        CConnman& connman);
+        CConnman& connman,
+        const uint256& nVerifiedKeyHash = uint256());
 
     /// Called when MN's which have voted on this object have been removed
     void ClearMasternodeVotes();
 
-    // Revalidate all votes from this MN and delete them if validation fails.
-    // This is the case for DIP3 MNs that changed voting or operator keys and
-    // also for MNs that were removed from the list completely.
-    // Returns deleted vote hashes.
-    std::set<uint256> RemoveInvalidVotes(const COutPoint& mnOutpoint);
+    // Votes from these MNs need to be revalidated. This is the case for DIP3 MNs
+    // that changed voting or operator keys and also for MNs that were removed
+    // from the list completely.
+    std::vector<CGovernanceVote> GetVotesOfMasternodes(const std::set<COutPoint>& setMasternodes);
+    // Delete votes which failed revalidation. Returns deleted vote hashes.
+    std::set<uint256> RemoveInvalidVotes(const std::vector<CGovernanceVote>& vecInvalidVotes);
 
     void CheckOrphanVotes(CConnman& connman);
 };
@@ -89,6 +89,11 @@ bool CProposalValidator::ValidateName()
     return true;
 }
 
+bool CProposalValidator::GetEndEpoch(int64_t& nEndEpochRet)
+{
+    return fJSONValid && GetDataValue("end_epoch", nEndEpochRet);
+}
+
 bool CProposalValidator::ValidateStartEndEpoch(bool fCheckExpiration)
 {
     int64_t nStartEpoch = 0;
@@ -27,6 +27,8 @@ public:
         return strErrorMessages;
     }
 
+    bool GetEndEpoch(int64_t& nEndEpochRet);
+
 private:
     void ParseStrHexData(const std::string& strHexData);
     void ParseJSONData(const std::string& strJSONData);
@@ -9,7 +9,17 @@
 #include "spork.h"
 #include "util.h"
 
+#include "bls/bls_batchverifier.h"
 #include "evo/deterministicmns.h"
+#include "llmq/quorums_init.h"
+
+#include <future>
+
+// Shared by all vote verifications, so that batch sizes adapt to the rate of invalid votes
+static CBLSBatchSizeController voteBatchSizeController(1, 256);
+
+// ECDSA signed votes verified by a single job on the worker pool
+static const size_t ECDSA_VOTES_PER_JOB = 64;
 
 std::string CGovernanceVoting::ConvertOutcomeToString(vote_outcome_enum_t nOutcome)
 {
@@ -252,31 +262,53 @@ bool CGovernanceVote::CheckSignature(const CBLSPublicKey& pubKey) const
     return true;
 }
 
-bool CGovernanceVote::IsValid(bool useVotingKey) const
+std::shared_ptr<const CDeterministicMN> CGovernanceVote::GetValidMasternode(const CDeterministicMNList& mnList) const
 {
     if (nTime > GetAdjustedTime() + (60 * 60)) {
         LogPrint("gobject", "CGovernanceVote::IsValid -- vote is too far ahead of current time - %s - nTime %lli - Max Time %lli\n", GetHash().ToString(), nTime, GetAdjustedTime() + (60 * 60));
-        return false;
+        return nullptr;
     }
 
     // support up to MAX_SUPPORTED_VOTE_SIGNAL, can be extended
     if (nVoteSignal > MAX_SUPPORTED_VOTE_SIGNAL) {
         LogPrint("gobject", "CGovernanceVote::IsValid -- Client attempted to vote on invalid signal(%d) - %s\n", nVoteSignal, GetHash().ToString());
-        return false;
+        return nullptr;
     }
 
     // 0=none, 1=yes, 2=no, 3=abstain. Beyond that reject votes
     if (nVoteOutcome > 3) {
         LogPrint("gobject", "CGovernanceVote::IsValid -- Client attempted to vote on invalid outcome(%d) - %s\n", nVoteSignal, GetHash().ToString());
-        return false;
+        return nullptr;
     }
 
-    auto dmn = deterministicMNManager->GetListAtChainTip().GetMNByCollateral(masternodeOutpoint);
+    auto dmn = mnList.GetMNByCollateral(masternodeOutpoint);
     if (!dmn) {
         LogPrint("gobject", "CGovernanceVote::IsValid -- Unknown Masternode - %s\n", masternodeOutpoint.ToStringShort());
+        return nullptr;
+    }
+    return dmn;
+}
+
+uint256 CGovernanceVote::GetKeyHash(const CDeterministicMN& dmn, bool useVotingKey)
+{
+    if (useVotingKey) {
+        return ::SerializeHash(dmn.pdmnState->keyIDVoting);
+    }
+    return ::SerializeHash(dmn.pdmnState->pubKeyOperator.Get());
+}
+
+bool CGovernanceVote::IsValid(bool useVotingKey, const uint256& nVerifiedKeyHash) const
+{
+    auto dmn = GetValidMasternode(deterministicMNManager->GetListAtChainTip());
+    if (!dmn) {
         return false;
     }
 
+    // the key might have changed after the signature was verified
+    if (!nVerifiedKeyHash.IsNull() && nVerifiedKeyHash == GetKeyHash(*dmn, useVotingKey)) {
+        return true;
+    }
+
     if (useVotingKey) {
         return CheckSignature(dmn->pdmnState->keyIDVoting);
     } else {
@@ -284,6 +316,87 @@ bool CGovernanceVote::IsValid(bool useVotingKey) const
     }
 }
 
+void CGovernanceVoteBatchVerifier::Verify()
+{
+    auto mnList = deterministicMNManager->GetListAtChainTip();
+
+    CBLSBatchVerifier<uint256, uint256> blsVerifier(false, false);
+    std::vector<uint256> vecBLSVotes;
+    std::vector<std::pair<const CGovernanceVote*, CKeyID> > vecECDSAVotes;
+    std::map<uint256, uint256> mapKeyHashes;
+
+    for (const auto& p : vecVotes) {
+        const CGovernanceVote& vote = *p.first;
+        uint256 nHash = vote.GetHash();
+
+        if (!mnList.HasMNByCollateral(vote.GetMasternodeOutpoint())) {
+            // left unverified, ProcessVote keeps votes of unknown masternodes as orphans
+            continue;
+        }
+        auto dmn = vote.GetValidMasternode(mnList);
+        if (!dmn) {
+            setInvalidVotes.emplace(nHash);
+            continue;
+        }
+        mapKeyHashes[nHash] = CGovernanceVote::GetKeyHash(*dmn, p.second);
+
+        if (p.second) {
+            vecECDSAVotes.emplace_back(&vote, dmn->pdmnState->keyIDVoting);
+            continue;
+        }
+
+        CBLSSignature sig;
+        sig.SetBuf(vote.vchSig);
+        CBLSPublicKey pubKey = dmn->pdmnState->pubKeyOperator.Get();
+        if (!sig.IsValid() || !pubKey.IsValid()) {
+            setInvalidVotes.emplace(nHash);
+            continue;
+        }
+        blsVerifier.PushMessage(nHash, nHash, vote.GetSignatureHash(), sig, pubKey);
+        vecBLSVotes.emplace_back(nHash);
+    }
+
+    // ECDSA signatures can't be batch verified, but they can be verified in parallel
+    std::vector<char> vecECDSAResults(vecECDSAVotes.size(), 0);
+    std::vector<std::future<void> > futures;
+    for (size_t nStart = 0; nStart < vecECDSAVotes.size(); nStart += ECDSA_VOTES_PER_JOB) {
+        size_t nEnd = std::min(nStart + ECDSA_VOTES_PER_JOB, vecECDSAVotes.size());
+        auto job = [&vecECDSAVotes, &vecECDSAResults, nStart, nEnd]() {
+            for (size_t i = nStart; i < nEnd; i++) {
+                vecECDSAResults[i] = vecECDSAVotes[i].first->CheckSignature(vecECDSAVotes[i].second);
+            }
+        };
+        if (llmq::blsWorker) {
+            futures.emplace_back(llmq::blsWorker->AsyncExec(job));
+        } else {
+            job();
+        }
+    }
+
+    blsVerifier.Verify(llmq::blsWorker, &voteBatchSizeController);
+
+    for (auto& f : futures) {
+        f.get();
+    }
+
+    for (size_t i = 0; i < vecECDSAVotes.size(); i++) {
+        uint256 nHash = vecECDSAVotes[i].first->GetHash();
+        if (vecECDSAResults[i]) {
+            mapValidVotes.emplace(nHash, mapKeyHashes.at(nHash));
+        } else {
+            setInvalidVotes.emplace(nHash);
+        }
+    }
+    for (const auto& nHash : vecBLSVotes) {
+        if (blsVerifier.badSources.count(nHash)) {
+            LogPrint("gobject", "CGovernanceVoteBatchVerifier::%s -- invalid BLS signature, vote hash = %s\n", __func__, nHash.ToString());
+            setInvalidVotes.emplace(nHash);
+        } else {
+            mapValidVotes.emplace(nHash, mapKeyHashes.at(nHash));
+        }
+    }
+}
+
 bool operator==(const CGovernanceVote& vote1, const CGovernanceVote& vote2)
 {
     bool fResult = ((vote1.masternodeOutpoint == vote2.masternodeOutpoint) &&
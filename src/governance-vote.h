@@ -9,8 +9,14 @@
 #include "primitives/transaction.h"
 #include "bls/bls.h"
 
+#include <map>
+#include <memory>
+#include <set>
+
 class CGovernanceVote;
 class CConnman;
+class CDeterministicMN;
+class CDeterministicMNList;
 
 // INTENTION OF MASTERNODES REGARDING ITEM
 enum vote_outcome_enum_t {
@@ -57,6 +63,8 @@ class CGovernanceVote
 
     friend bool operator<(const CGovernanceVote& vote1, const CGovernanceVote& vote2);
 
+    friend class CGovernanceVoteBatchVerifier;
+
 private:
     bool fValid;     //if the vote is currently valid / counted
     bool fSynced;    //if we've sent this to our peers
@@ -71,6 +79,11 @@ private:
     const uint256 hash;
     void UpdateHash() const;
 
+    // Checks everything except the signature, returns the voting masternode if the vote is valid so far
+    std::shared_ptr<const CDeterministicMN> GetValidMasternode(const CDeterministicMNList& mnList) const;
+    // Identifies the key votes of this masternode are signed with
+    static uint256 GetKeyHash(const CDeterministicMN& dmn, bool useVotingKey);
+
 public:
     CGovernanceVote();
     CGovernanceVote(const COutPoint& outpointMasternodeIn, const uint256& nParentHashIn, vote_signal_enum_t eVoteSignalIn, vote_outcome_enum_t eVoteOutcomeIn);
@@ -99,7 +112,8 @@ public:
     bool CheckSignature(const CKeyID& keyID) const;
     bool Sign(const CBLSSecretKey& key);
     bool CheckSignature(const CBLSPublicKey& pubKey) const;
-    bool IsValid(bool useVotingKey) const;
+    // The signature check is skipped if it was already verified against nVerifiedKeyHash and the key didn't change since
+    bool IsValid(bool useVotingKey, const uint256& nVerifiedKeyHash = uint256()) const;
     void Relay(CConnman& connman) const;
 
     const COutPoint& GetMasternodeOutpoint() const { return masternodeOutpoint; }
@@ -133,4 +147,31 @@ public:
     }
 };
 
+/**
+ * Verifies the signatures of many votes at once, e.g. of all votes received in one round. BLS signed votes are batch
+ * verified, ECDSA signed votes are verified in parallel, both on the BLS worker pool. Pushed votes must outlive the
+ * verifier.
+ */
+class CGovernanceVoteBatchVerifier
+{
+private:
+    std::vector<std::pair<const CGovernanceVote*, bool> > vecVotes;
+
+public:
+    // vote hash -> key hash (see CGovernanceVote::GetKeyHash) the signature was verified against
+    std::map<uint256, uint256> mapValidVotes;
+    // malformed votes and votes with bad signatures, votes of unknown masternodes are in neither of both
+    std::set<uint256> setInvalidVotes;
+
+public:
+    void PushVote(const CGovernanceVote& vote, bool useVotingKey)
+    {
+        vecVotes.emplace_back(&vote, useVotingKey);
+    }
+
+    size_t GetVoteCount() const { return vecVotes.size(); }
+
+    void Verify();
+};
+
 #endif
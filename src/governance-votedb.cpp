@@ -4,6 +4,8 @@
 
 #include "governance-votedb.h"
 
+#include "hash.h"
+
 CGovernanceObjectVoteFile::CGovernanceObjectVoteFile() :
     nMemoryVotes(0),
     listVotes(),
@@ -19,16 +21,16 @@ CGovernanceObjectVoteFile::CGovernanceObjectVoteFile(const CGovernanceObjectVote
     RebuildIndex();
 }
 
-void CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote)
+std::set<uint256> CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote)
 {
     uint256 nHash = vote.GetHash();
     // make sure to never add/update already known votes
     if (HasVote(nHash))
-        return;
+        return {};
     listVotes.push_front(vote);
     mapVoteIndex.emplace(nHash, listVotes.begin());
     ++nMemoryVotes;
-    RemoveOldVotes(vote);
+    return RemoveOldVotes(vote);
 }
 
 bool CGovernanceObjectVoteFile::HasVote(const uint256& nHash) const
@@ -55,11 +57,32 @@ std::vector<CGovernanceVote> CGovernanceObjectVoteFile::GetVotes() const
     return vecResult;
 }
 
-void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
+uint256 CGovernanceObjectVoteFile::GetVoteSetHash() const
+{
+    CHashWriter hw(SER_GETHASH, 0);
+    for (const auto& p : mapVoteIndex) {
+        hw << p.first;
+    }
+    return hw.GetHash();
+}
+
+void CGovernanceObjectVoteFile::LoadVotes(std::vector<CGovernanceVote>&& vecVotes)
+{
+    listVotes.clear();
+    for (auto& vote : vecVotes) {
+        listVotes.emplace_back(std::move(vote));
+    }
+    RebuildIndex();
+}
+
+std::set<uint256> CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
 {
+    std::set<uint256> removedVotes;
+
     vote_l_it it = listVotes.begin();
     while (it != listVotes.end()) {
         if (it->GetMasternodeOutpoint() == outpointMasternode) {
+            removedVotes.emplace(it->GetHash());
             --nMemoryVotes;
             mapVoteIndex.erase(it->GetHash());
             listVotes.erase(it++);
@@ -67,32 +90,43 @@ void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpo
             ++it;
         }
     }
+
+    return removedVotes;
+}
+
+std::vector<CGovernanceVote> CGovernanceObjectVoteFile::GetVotesOfMasternodes(const std::set<COutPoint>& setMasternodes) const
+{
+    std::vector<CGovernanceVote> vecResult;
+    for (const auto& vote : listVotes) {
+        if (setMasternodes.count(vote.GetMasternodeOutpoint())) {
+            vecResult.push_back(vote);
+        }
+    }
+    return vecResult;
 }
 
-std::set<uint256> CGovernanceObjectVoteFile::RemoveInvalidVotes(const COutPoint& outpointMasternode, bool fProposal)
+std::set<uint256> CGovernanceObjectVoteFile::RemoveVotes(const std::set<uint256>& setVoteHashes)
 {
     std::set<uint256> removedVotes;
 
-    vote_l_it it = listVotes.begin();
-    while (it != listVotes.end()) {
-        if (it->GetMasternodeOutpoint() == outpointMasternode) {
-            bool useVotingKey = fProposal && (it->GetSignal() == VOTE_SIGNAL_FUNDING);
-            if (!it->IsValid(useVotingKey)) {
-                removedVotes.emplace(it->GetHash());
-                --nMemoryVotes;
-                mapVoteIndex.erase(it->GetHash());
-                listVotes.erase(it++);
-                continue;
-            }
+    for (const auto& nHash : setVoteHashes) {
+        auto it = mapVoteIndex.find(nHash);
+        if (it == mapVoteIndex.end()) {
+            continue;
         }
-        ++it;
+        removedVotes.emplace(nHash);
+        --nMemoryVotes;
+        listVotes.erase(it->second);
+        mapVoteIndex.erase(it);
     }
 
     return removedVotes;
 }
 
-void CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
+std::set<uint256> CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
 {
+    std::set<uint256> removedVotes;
+
     vote_l_it it = listVotes.begin();
     while (it != listVotes.end()) {
         if (it->GetMasternodeOutpoint() == vote.GetMasternodeOutpoint() // same masternode
@@ -100,6 +134,7 @@ void CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
             && it->GetSignal() == vote.GetSignal() // same signal (e.g. "funding", "delete", etc.)
             && it->GetTimestamp() < vote.GetTimestamp()) // older than new vote
         {
+            removedVotes.emplace(it->GetHash());
             --nMemoryVotes;
             mapVoteIndex.erase(it->GetHash());
             listVotes.erase(it++);
@@ -107,6 +142,8 @@ void CGovernanceObjectVoteFile::RemoveOldVotes(const CGovernanceVote& vote)
             ++it;
         }
     }
+
+    return removedVotes;
 }
 
 void CGovernanceObjectVoteFile::RebuildIndex()
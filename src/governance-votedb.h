@@ -7,6 +7,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 
 #include "governance-vote.h"
 #include "serialize.h"
@@ -52,8 +53,9 @@ public:
 
     /**
      * Add a vote to the file
+     * Returns the hashes of older votes which were replaced by this vote
      */
-    void AddVote(const CGovernanceVote& vote);
+    std::set<uint256> AddVote(const CGovernanceVote& vote);
 
     /**
      * Return true if the vote with this hash is currently cached in memory
@@ -65,15 +67,30 @@ public:
      */
     bool SerializeVoteToStream(const uint256& nHash, CDataStream& ss) const;
 
-    int GetVoteCount()
+    int GetVoteCount() const
     {
         return nMemoryVotes;
     }
 
     std::vector<CGovernanceVote> GetVotes() const;
 
-    void RemoveVotesFromMasternode(const COutPoint& outpointMasternode);
-    std::set<uint256> RemoveInvalidVotes(const COutPoint& outpointMasternode, bool fProposal);
+    /**
+     * Hash over the sorted hashes of all votes, equal for two vote files if they contain the same votes
+     */
+    uint256 GetVoteSetHash() const;
+
+    /**
+     * Replace all votes with the given ones, which must not contain replaced votes (e.g. when loaded from the
+     * governance db)
+     */
+    void LoadVotes(std::vector<CGovernanceVote>&& vecVotes);
+
+    std::set<uint256> RemoveVotesFromMasternode(const COutPoint& outpointMasternode);
+    std::vector<CGovernanceVote> GetVotesOfMasternodes(const std::set<COutPoint>& setMasternodes) const;
+    /**
+     * Remove the votes with the given hashes, returns the hashes of the votes which were actually removed
+     */
+    std::set<uint256> RemoveVotes(const std::set<uint256>& setVoteHashes);
 
     ADD_SERIALIZE_METHODS;
 
@@ -89,7 +106,7 @@ public:
 
 private:
     // Drop older votes for the same gobject from the same masternode
-    void RemoveOldVotes(const CGovernanceVote& vote);
+    std::set<uint256> RemoveOldVotes(const CGovernanceVote& vote);
 
     void RebuildIndex();
 };
@@ -5,6 +5,7 @@
 #include "governance.h"
 #include "consensus/validation.h"
 #include "governance-classes.h"
+#include "governance-db.h"
 #include "governance-object.h"
 #include "governance-validators.h"
 #include "governance-vote.h"
@@ -28,6 +29,17 @@ const std::string CGovernanceManager::SERIALIZATION_VERSION_STRING = "CGovernanc
 const int CGovernanceManager::MAX_TIME_FUTURE_DEVIATION = 60 * 60;
 const int CGovernanceManager::RELIABLE_PROPAGATION_TIME = 60;
 
+CGovernanceVoteSketch::CGovernanceVoteSketch(const uint256& nParentHashIn, const CGovernanceObjectVoteFile& fileVotes) :
+    nParentHash(nParentHashIn),
+    nVoteCount(fileVotes.GetVoteCount()),
+    nVoteSetHash(fileVotes.GetVoteSetHash()),
+    filter(std::max(1, fileVotes.GetVoteCount()), GOVERNANCE_FILTER_FP_RATE, GetRandInt(999999), BLOOM_UPDATE_ALL)
+{
+    for (const auto& vote : fileVotes.GetVotes()) {
+        filter.insert(vote.GetHash());
+    }
+}
+
 CGovernanceManager::CGovernanceManager() :
     nTimeLastDiff(0),
     nCachedBlockHeight(0),
@@ -69,7 +81,7 @@ bool CGovernanceManager::HaveVoteForHash(const uint256& nHash) const
     LOCK(cs);
 
     CGovernanceObject* pGovobj = nullptr;
-    return cmapVoteToObject.Get(nHash, pGovobj) && pGovobj->GetVoteFile().HasVote(nHash);
+    return cmapVoteToObject.Get(nHash, pGovobj) && pGovobj->HasVote(nHash);
 }
 
 int CGovernanceManager::GetVoteCount() const
@@ -83,7 +95,7 @@ bool CGovernanceManager::SerializeVoteForHash(const uint256& nHash, CDataStream&
     LOCK(cs);
 
     CGovernanceObject* pGovobj = nullptr;
-    return cmapVoteToObject.Get(nHash, pGovobj) && pGovobj->GetVoteFile().SerializeVoteToStream(nHash, ss);
+    return cmapVoteToObject.Get(nHash, pGovobj) && pGovobj->SerializeVoteToStream(nHash, ss);
 }
 
 void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
@@ -125,6 +137,52 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
         LogPrint("gobject", "MNGOVERNANCESYNC -- syncing governance objects to our peer at %s\n", pfrom->addr.ToString());
     }
 
+    // ANOTHER USER IS ASKING US FOR THE VOTES THEY ARE MISSING
+    else if (strCommand == NetMsgType::MNGOVERNANCEVOTESKETCH) {
+        // Same as MNGOVERNANCESYNC, this is a heavy one so don't answer before we are fully synced
+        if (!masternodeSync.IsSynced()) return;
+
+        std::vector<CGovernanceVoteSketch> vecSketches;
+        vRecv >> vecSketches;
+
+        SyncVotesBySketches(pfrom, vecSketches, connman);
+    }
+
+    // VOTES WE ASKED FOR WITH MNGOVERNANCEVOTESKETCH HAVE ARRIVED
+    else if (strCommand == NetMsgType::MNGOVERNANCEVOTES) {
+        std::vector<CGovernanceVote> vecVotes;
+        vRecv >> vecVotes;
+
+        {
+            LOCK(cs);
+            auto it = mapVoteSketchRequests.find(pfrom->GetId());
+            if (it == mapVoteSketchRequests.end() || it->second < GetTime()) {
+                LogPrint("gobject", "MNGOVERNANCEVOTES -- Received unrequested votes, peer = %d\n", pfrom->GetId());
+                return;
+            }
+        }
+
+        if (vecVotes.size() > MAX_VOTES_PER_MESSAGE) {
+            LOCK(cs_main);
+            LogPrint("gobject", "MNGOVERNANCEVOTES -- Too many votes in one message, peer = %d\n", pfrom->GetId());
+            Misbehaving(pfrom->GetId(), 20);
+            return;
+        }
+
+        {
+            LOCK(cs_main);
+            for (const auto& vote : vecVotes) {
+                connman.RemoveAskFor(vote.GetHash());
+            }
+        }
+
+        LogPrint("gobject", "MNGOVERNANCEVOTES -- Received %d votes, peer = %d\n", vecVotes.size(), pfrom->GetId());
+
+        for (const auto& vote : vecVotes) {
+            AddPendingVote(pfrom, vote, connman);
+        }
+    }
+
     // A NEW GOVERNANCE OBJECT HAS ARRIVED
     else if (strCommand == NetMsgType::MNGOVERNANCEOBJECT) {
         // MAKE SURE WE HAVE A VALID REFERENCE TO THE TIP BEFORE CONTINUING
@@ -251,22 +309,170 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
             return;
         }
 
+        AddPendingVote(pfrom, vote, connman);
+    }
+}
+
+void CGovernanceManager::StartWorkerThread()
+{
+    // can't start new thread if we have one running already
+    if (workThread.joinable()) {
+        assert(false);
+    }
+
+    workInterrupt.reset();
+    workThread = std::thread(&TraceThread<std::function<void()> >, "govvotes", std::function<void()>(std::bind(&CGovernanceManager::WorkThreadMain, this)));
+}
+
+void CGovernanceManager::StopWorkerThread()
+{
+    // make sure to call InterruptWorkerThread() first
+    if (!workInterrupt) {
+        assert(false);
+    }
+
+    if (workThread.joinable()) {
+        workThread.join();
+    }
+}
+
+void CGovernanceManager::InterruptWorkerThread()
+{
+    workInterrupt();
+}
+
+void CGovernanceManager::WorkThreadMain()
+{
+    while (!workInterrupt) {
+        if (!ProcessPendingVotes(*g_connman)) {
+            if (!workInterrupt.sleep_for(std::chrono::milliseconds(100))) {
+                return;
+            }
+        }
+    }
+}
+
+void CGovernanceManager::AddPendingVote(CNode* pfrom, const CGovernanceVote& vote, CConnman& connman)
+{
+    uint256 nHash = vote.GetHash();
+
+    {
+        LOCK(cs);
+        if (mapObjects.count(vote.GetParentHash())) {
+            if (mapPendingVotes.size() >= MAX_PENDING_VOTES) {
+                LogPrint("gobject", "CGovernanceManager::%s -- too many pending votes, dropping vote %s, peer=%d\n", __func__, nHash.ToString(), pfrom->GetId());
+                return;
+            }
+            mapPendingVotes.emplace(std::piecewise_construct, std::forward_as_tuple(nHash), std::forward_as_tuple(pfrom->GetId(), vote));
+            return;
+        }
+    }
+
+    // Nothing to verify for votes of unknown objects, they are orphaned (and the object is requested) right away
+    CGovernanceException exception;
+    if (ProcessVote(pfrom, vote, exception, connman)) {
+        LogPrint("gobject", "CGovernanceManager::%s -- %s new\n", __func__, nHash.ToString());
+        masternodeSync.BumpAssetLastTime("CGovernanceManager::AddPendingVote");
+        vote.Relay(connman);
+        // SEND NOTIFICATION TO SCRIPT/ZMQ
+        GetMainSignals().NotifyGovernanceVote(vote);
+    } else {
+        LogPrint("gobject", "CGovernanceManager::%s -- Rejected vote, error = %s\n", __func__, exception.what());
+        if ((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), exception.GetNodePenalty());
+        }
+    }
+}
+
+bool CGovernanceManager::ProcessPendingVotes(CConnman& connman)
+{
+    std::vector<std::pair<NodeId, CGovernanceVote> > vecPendingVotes;
+    CGovernanceVoteBatchVerifier verifier;
+
+    {
+        LOCK(cs);
+        if (mapPendingVotes.empty()) {
+            return false;
+        }
+
+        // pending votes stay in mapPendingVotes until they are processed, so that they are not requested again
+        for (auto it = mapPendingVotes.begin(); it != mapPendingVotes.end() && vecPendingVotes.size() < MAX_VOTES_PER_ROUND; ++it) {
+            vecPendingVotes.emplace_back(it->second);
+        }
+
+        for (const auto& p : vecPendingVotes) {
+            const auto& vote = p.second;
+            if (cmapVoteToObject.HasKey(vote.GetHash()) || cmapInvalidVotes.HasKey(vote.GetHash())) {
+                // ProcessVote handles these without verification
+                continue;
+            }
+            object_m_it it = mapObjects.find(vote.GetParentHash());
+            if (it == mapObjects.end()) {
+                continue;
+            }
+            bool onlyVotingKeyAllowed = it->second.GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL && vote.GetSignal() == VOTE_SIGNAL_FUNDING;
+            verifier.PushVote(vote, onlyVotingKeyAllowed);
+        }
+    }
+
+    // no locks are held while signatures are verified
+    int64_t nStart = GetTimeMicros();
+    verifier.Verify();
+    int64_t nVerifyTime = GetTimeMicros() - nStart;
+
+    int nNewVotes = 0;
+    for (const auto& p : vecPendingVotes) {
+        NodeId nodeId = p.first;
+        const auto& vote = p.second;
+        uint256 nHash = vote.GetHash();
+
+        if (verifier.setInvalidVotes.count(nHash)) {
+            LogPrintf("CGovernanceManager::%s -- Invalid vote, MN outpoint = %s, governance object hash = %s, vote hash = %s, peer=%d\n", __func__,
+                vote.GetMasternodeOutpoint().ToStringShort(), vote.GetParentHash().ToString(), nHash.ToString(), nodeId);
+            {
+                LOCK(cs);
+                AddInvalidVote(vote);
+            }
+            if (masternodeSync.IsSynced()) {
+                LOCK(cs_main);
+                Misbehaving(nodeId, 20);
+            }
+            continue;
+        }
+
+        auto itValid = verifier.mapValidVotes.find(nHash);
         CGovernanceException exception;
-        if (ProcessVote(pfrom, vote, exception, connman)) {
-            LogPrint("gobject", "MNGOVERNANCEOBJECTVOTE -- %s new\n", strHash);
-            masternodeSync.BumpAssetLastTime("MNGOVERNANCEOBJECTVOTE");
+        if (ProcessVote(nullptr, vote, exception, connman, itValid != verifier.mapValidVotes.end() ? itValid->second : uint256())) {
+            LogPrint("gobject", "CGovernanceManager::%s -- %s new\n", __func__, nHash.ToString());
             vote.Relay(connman);
+            // SEND NOTIFICATION TO SCRIPT/ZMQ
+            GetMainSignals().NotifyGovernanceVote(vote);
+            nNewVotes++;
         } else {
-            LogPrint("gobject", "MNGOVERNANCEOBJECTVOTE -- Rejected vote, error = %s\n", exception.what());
+            LogPrint("gobject", "CGovernanceManager::%s -- Rejected vote, error = %s\n", __func__, exception.what());
             if ((exception.GetNodePenalty() != 0) && masternodeSync.IsSynced()) {
                 LOCK(cs_main);
-                Misbehaving(pfrom->GetId(), exception.GetNodePenalty());
+                Misbehaving(nodeId, exception.GetNodePenalty());
             }
-            return;
         }
-        // SEND NOTIFICATION TO SCRIPT/ZMQ
-        GetMainSignals().NotifyGovernanceVote(vote);
     }
+
+    if (nNewVotes > 0) {
+        masternodeSync.BumpAssetLastTime("CGovernanceManager::ProcessPendingVotes");
+    }
+
+    {
+        LOCK(cs);
+        for (const auto& p : vecPendingVotes) {
+            mapPendingVotes.erase(p.second.GetHash());
+        }
+    }
+
+    LogPrint("gobject", "CGovernanceManager::%s -- processed %d votes (%d verified, %d invalid, %d new) in %dus\n", __func__,
+        vecPendingVotes.size(), verifier.GetVoteCount(), verifier.setInvalidVotes.size(), nNewVotes, nVerifyTime);
+
+    return true;
 }
 
 void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernanceException& exception, CConnman& connman)
@@ -286,6 +492,7 @@ void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernance
             fRemove = true;
         } else if (govobj.ProcessVote(nullptr, vote, exception, connman)) {
             vote.Relay(connman);
+            setDirtyObjects.emplace(nHash);
             fRemove = true;
         }
         if (fRemove) {
@@ -324,6 +531,13 @@ void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman
         return;
     }
 
+    if (governanceDb) {
+        CDBBatch batch(governanceDb->GetRawDB());
+        WriteObjectToDb(batch, objpair.first->second);
+        governanceDb->WriteBatch(batch);
+    }
+    setDirtyObjects.emplace(nHash);
+
     // SHOULD WE ADD THIS OBJECT TO ANY OTHER MANANGERS?
 
     LogPrint("gobject", "CGovernanceManager::AddGovernanceObject -- Before trigger block, GetDataAsPlainString = %s, nObjectType = %d\n",
@@ -364,109 +578,179 @@ void CGovernanceManager::UpdateCachesAndClean()
 
     std::vector<uint256> vecDirtyHashes = mmetaman.GetAndClearDirtyGovernanceObjectHashes();
 
-    LOCK2(cs_main, cs);
+    size_t nDirtyCount;
+    {
+        LOCK(cs);
 
-    for (const uint256& nHash : vecDirtyHashes) {
-        object_m_it it = mapObjects.find(nHash);
-        if (it == mapObjects.end()) {
-            continue;
+        for (const uint256& nHash : vecDirtyHashes) {
+            object_m_it it = mapObjects.find(nHash);
+            if (it == mapObjects.end()) {
+                continue;
+            }
+            it->second.ClearMasternodeVotes();
+            it->second.fDirtyCache = true;
+            setDirtyObjects.emplace(nHash);
+        }
+        nDirtyCount = setDirtyObjects.size();
+    }
+
+    // cs_main is only needed to update the local validity of changed objects
+    if (nDirtyCount != 0) {
+        LOCK2(cs_main, cs);
+        ScopedLockBool guard(cs, fRateChecksEnabled, false);
+
+        for (const uint256& nHash : setDirtyObjects) {
+            object_m_it it = mapObjects.find(nHash);
+            if (it == mapObjects.end()) {
+                continue;
+            }
+            CGovernanceObject& govobj = it->second;
+
+            // IF CACHE IS NOT DIRTY, WHY DO THIS?
+            if (govobj.IsSetDirtyCache()) {
+                // UPDATE LOCAL VALIDITY AGAINST CRYPTO DATA
+                govobj.UpdateLocalValidity();
+
+                // UPDATE SENTINEL SIGNALING VARIABLES
+                govobj.UpdateSentinelVariables();
+            }
+
+            ScheduleObjectCheck(govobj);
         }
-        it->second.ClearMasternodeVotes();
-        it->second.fDirtyCache = true;
+        setDirtyObjects.clear();
     }
 
+    LOCK(cs);
+
     ScopedLockBool guard(cs, fRateChecksEnabled, false);
 
     // Clean up any expired or invalid triggers
     triggerman.CleanAndRemove();
 
-    object_m_it it = mapObjects.begin();
     int64_t nNow = GetAdjustedTime();
 
-    while (it != mapObjects.end()) {
-        CGovernanceObject* pObj = &((*it).second);
+    // Collect due checks first, as checking an object might schedule another check for it
+    std::vector<uint256> vecDueHashes;
+    while (!setScheduledObjectChecks.empty() && setScheduledObjectChecks.begin()->first <= nNow) {
+        vecDueHashes.emplace_back(setScheduledObjectChecks.begin()->second);
+        setScheduledObjectChecks.erase(setScheduledObjectChecks.begin());
+    }
 
-        if (!pObj) {
-            ++it;
-            continue;
+    size_t nErasedCount = mapObjects.size();
+    for (const uint256& nHash : vecDueHashes) {
+        object_m_it it = mapObjects.find(nHash);
+        if (it != mapObjects.end()) {
+            CheckObject(it, nNow);
         }
+    }
+    nErasedCount -= mapObjects.size();
 
-        uint256 nHash = it->first;
-        std::string strHash = nHash.ToString();
+    // forget about expired deleted objects
+    while (!mapErasedObjectsExpiry.empty() && mapErasedObjectsExpiry.begin()->first < nNow) {
+        mapErasedGovernanceObjects.erase(mapErasedObjectsExpiry.begin()->second);
+        mapErasedObjectsExpiry.erase(mapErasedObjectsExpiry.begin());
+    }
 
-        // IF CACHE IS NOT DIRTY, WHY DO THIS?
-        if (pObj->IsSetDirtyCache()) {
-            // UPDATE LOCAL VALIDITY AGAINST CRYPTO DATA
-            pObj->UpdateLocalValidity();
+    LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- updated %d objects, checked %d objects, erased %d objects\n",
+        nDirtyCount, vecDueHashes.size(), nErasedCount);
+}
 
-            // UPDATE SENTINEL SIGNALING VARIABLES
-            pObj->UpdateSentinelVariables();
-        }
+void CGovernanceManager::ScheduleObjectCheck(const CGovernanceObject& govobj)
+{
+    AssertLockHeld(cs);
+
+    int64_t nCheckTime;
+    if (govobj.IsSetCachedDelete() || govobj.IsSetExpired()) {
+        nCheckTime = govobj.GetDeletionTime() + GOVERNANCE_DELETION_DELAY;
+    } else if (govobj.GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
+        // check again when the proposal expires, or right away if it isn't valid anymore
+        CProposalValidator validator(govobj.GetDataAsHexString(), true);
+        int64_t nEndEpoch = 0;
+        nCheckTime = validator.Validate() && validator.GetEndEpoch(nEndEpoch) ? nEndEpoch : 0;
+    } else {
+        // NOTE: triggers are handled via triggerman
+        return;
+    }
 
-        // IF DELETE=TRUE, THEN CLEAN THE MESS UP!
+    setScheduledObjectChecks.emplace(nCheckTime, govobj.GetHash());
+}
 
-        int64_t nTimeSinceDeletion = nNow - pObj->GetDeletionTime();
+void CGovernanceManager::CheckObject(object_m_it it, int64_t nNow)
+{
+    AssertLockHeld(cs);
 
-        LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- Checking object for deletion: %s, deletion time = %d, time since deletion = %d, delete flag = %d, expired flag = %d\n",
-            strHash, pObj->GetDeletionTime(), nTimeSinceDeletion, pObj->IsSetCachedDelete(), pObj->IsSetExpired());
+    CGovernanceObject* pObj = &it->second;
 
-        if ((pObj->IsSetCachedDelete() || pObj->IsSetExpired()) &&
-            (nTimeSinceDeletion >= GOVERNANCE_DELETION_DELAY)) {
-            LogPrintf("CGovernanceManager::UpdateCachesAndClean -- erase obj %s\n", (*it).first.ToString());
-            mmetaman.RemoveGovernanceObject(pObj->GetHash());
+    // IF DELETE=TRUE, THEN CLEAN THE MESS UP!
 
-            // Remove vote references
-            const object_ref_cm_t::list_t& listItems = cmapVoteToObject.GetItemList();
-            object_ref_cm_t::list_cit lit = listItems.begin();
-            while (lit != listItems.end()) {
-                if (lit->value == pObj) {
-                    uint256 nKey = lit->key;
-                    ++lit;
-                    cmapVoteToObject.Erase(nKey);
-                } else {
-                    ++lit;
-                }
-            }
+    int64_t nTimeSinceDeletion = nNow - pObj->GetDeletionTime();
 
-            int64_t nTimeExpired{0};
+    LogPrint("gobject", "CGovernanceManager::CheckObject -- Checking object for deletion: %s, deletion time = %d, time since deletion = %d, delete flag = %d, expired flag = %d\n",
+        it->first.ToString(), pObj->GetDeletionTime(), nTimeSinceDeletion, pObj->IsSetCachedDelete(), pObj->IsSetExpired());
 
-            if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
-                // keep hashes of deleted proposals forever
-                nTimeExpired = std::numeric_limits<int64_t>::max();
-            } else {
-                int64_t nSuperblockCycleSeconds = Params().GetConsensus().nSuperblockCycle * Params().GetConsensus().nPowTargetSpacing;
-                nTimeExpired = pObj->GetCreationTime() + 2 * nSuperblockCycleSeconds + GOVERNANCE_DELETION_DELAY;
-            }
+    if ((pObj->IsSetCachedDelete() || pObj->IsSetExpired()) &&
+        (nTimeSinceDeletion >= GOVERNANCE_DELETION_DELAY)) {
+        EraseObject(it);
+        return;
+    }
 
-            mapErasedGovernanceObjects.insert(std::make_pair(nHash, nTimeExpired));
-            mapObjects.erase(it++);
-        } else {
-            // NOTE: triggers are handled via triggerman
-            if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
-                CProposalValidator validator(pObj->GetDataAsHexString(), true);
-                if (!validator.Validate()) {
-                    LogPrintf("CGovernanceManager::UpdateCachesAndClean -- set for deletion expired obj %s\n", strHash);
-                    pObj->fCachedDelete = true;
-                    if (pObj->nDeletionTime == 0) {
-                        pObj->nDeletionTime = nNow;
-                    }
-                }
+    // NOTE: triggers are handled via triggerman
+    if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL && !pObj->IsSetCachedDelete()) {
+        CProposalValidator validator(pObj->GetDataAsHexString(), true);
+        if (!validator.Validate()) {
+            LogPrintf("CGovernanceManager::CheckObject -- set for deletion expired obj %s\n", it->first.ToString());
+            pObj->fCachedDelete = true;
+            if (pObj->nDeletionTime == 0) {
+                pObj->nDeletionTime = nNow;
             }
-            ++it;
         }
     }
 
-    // forget about expired deleted objects
-    hash_time_m_it s_it = mapErasedGovernanceObjects.begin();
-    while (s_it != mapErasedGovernanceObjects.end()) {
-        if (s_it->second < nNow) {
-            mapErasedGovernanceObjects.erase(s_it++);
+    ScheduleObjectCheck(*pObj);
+}
+
+void CGovernanceManager::EraseObject(object_m_it it)
+{
+    AssertLockHeld(cs);
+
+    uint256 nHash = it->first;
+    CGovernanceObject* pObj = &it->second;
+
+    LogPrintf("CGovernanceManager::EraseObject -- erase obj %s\n", nHash.ToString());
+    mmetaman.RemoveGovernanceObject(nHash);
+
+    // Remove vote references
+    const object_ref_cm_t::list_t& listItems = cmapVoteToObject.GetItemList();
+    object_ref_cm_t::list_cit lit = listItems.begin();
+    while (lit != listItems.end()) {
+        if (lit->value == pObj) {
+            uint256 nKey = lit->key;
+            ++lit;
+            cmapVoteToObject.Erase(nKey);
         } else {
-            ++s_it;
+            ++lit;
         }
     }
 
-    LogPrintf("CGovernanceManager::UpdateCachesAndClean -- %s\n", ToString());
+    int64_t nTimeExpired{0};
+
+    if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
+        // keep hashes of deleted proposals forever
+        nTimeExpired = std::numeric_limits<int64_t>::max();
+    } else {
+        int64_t nSuperblockCycleSeconds = Params().GetConsensus().nSuperblockCycle * Params().GetConsensus().nPowTargetSpacing;
+        nTimeExpired = pObj->GetCreationTime() + 2 * nSuperblockCycleSeconds + GOVERNANCE_DELETION_DELAY;
+    }
+
+    if (mapErasedGovernanceObjects.emplace(nHash, nTimeExpired).second && nTimeExpired != std::numeric_limits<int64_t>::max()) {
+        mapErasedObjectsExpiry.emplace(nTimeExpired, nHash);
+    }
+    if (governanceDb) {
+        CDBBatch batch(governanceDb->GetRawDB());
+        governanceDb->EraseObject(batch, nHash);
+        governanceDb->WriteBatch(batch);
+    }
+    mapObjects.erase(it);
 }
 
 CGovernanceObject* CGovernanceManager::FindGovernanceObject(const uint256& nHash)
@@ -566,6 +850,8 @@ void CGovernanceManager::DoMaintenance(CConnman& connman)
     // CHECK AND REMOVE - REPROCESS GOVERNANCE OBJECTS
 
     UpdateCachesAndClean();
+
+    FlushToDb();
 }
 
 bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
@@ -587,7 +873,7 @@ bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
         break;
     } 
     case MSG_GOVERNANCE_OBJECT_VOTE: {
-        if (cmapVoteToObject.HasKey(inv.hash)) {
+        if (cmapVoteToObject.HasKey(inv.hash) || mapPendingVotes.count(inv.hash)) {
             LogPrint("gobject", "CGovernanceManager::ConfirmInventoryRequest already have governance vote, returning false\n");
             return false;
         }
@@ -670,6 +956,88 @@ void CGovernanceManager::SyncSingleObjVotes(CNode* pnode, const uint256& nProp,
     LogPrintf("CGovernanceManager::%s -- sent %d votes to peer=%d\n", __func__, nVoteCount, pnode->id);
 }
 
+void CGovernanceManager::SyncVotesBySketches(CNode* pnode, std::vector<CGovernanceVoteSketch>& vecSketches, CConnman& connman)
+{
+    // do not provide any data until our node is synced
+    if (!masternodeSync.IsSynced()) return;
+
+    if (netfulfilledman.HasFulfilledRequest(pnode->addr, NetMsgType::MNGOVERNANCEVOTESKETCH)) {
+        LOCK(cs_main);
+        // Asking for the votes of many objects multiple times in a short period of time is no good
+        LogPrint("gobject", "CGovernanceManager::%s -- peer already asked me for vote sketches\n", __func__);
+        Misbehaving(pnode->GetId(), 20);
+        return;
+    }
+    netfulfilledman.AddFulfilledRequest(pnode->addr, NetMsgType::MNGOVERNANCEVOTESKETCH);
+
+    if (vecSketches.size() > MAX_VOTE_SKETCHES_PER_MESSAGE) {
+        LOCK(cs_main);
+        LogPrint("gobject", "CGovernanceManager::%s -- too many vote sketches in one message, peer=%d\n", __func__, pnode->id);
+        Misbehaving(pnode->GetId(), 20);
+        return;
+    }
+
+    for (const auto& sketch : vecSketches) {
+        if (!sketch.filter.IsWithinSizeConstraints()) {
+            LOCK(cs_main);
+            LogPrint("gobject", "CGovernanceManager::%s -- vote sketch filter too large, peer=%d\n", __func__, pnode->id);
+            Misbehaving(pnode->GetId(), 100);
+            return;
+        }
+    }
+
+    CNetMsgMaker msgMaker(pnode->GetSendVersion());
+    std::vector<CGovernanceVote> vecVotes;
+    int nVoteCount = 0;
+    int nSkippedCount = 0;
+
+    LOCK(cs);
+
+    for (auto& sketch : vecSketches) {
+        object_m_it it = mapObjects.find(sketch.nParentHash);
+        if (it == mapObjects.end()) {
+            continue;
+        }
+        CGovernanceObject& govobj = it->second;
+        if (govobj.IsSetCachedDelete() || govobj.IsSetExpired()) {
+            continue;
+        }
+
+        // compare before loading the vote file, so that up to date objects don't pull their votes into memory
+        int nObjVoteCount;
+        uint256 nObjVoteSetHash;
+        govobj.GetVoteSetHash(nObjVoteCount, nObjVoteSetHash);
+        if (sketch.nVoteCount == nObjVoteCount && sketch.nVoteSetHash == nObjVoteSetHash) {
+            // peer already has all our votes for this object
+            nSkippedCount++;
+            continue;
+        }
+
+        sketch.filter.UpdateEmptyFull();
+        for (const auto& vote : govobj.GetVoteFile().GetVotes()) {
+            bool onlyVotingKeyAllowed = govobj.GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL && vote.GetSignal() == VOTE_SIGNAL_FUNDING;
+
+            if (sketch.filter.contains(vote.GetHash()) || !vote.IsValid(onlyVotingKeyAllowed)) {
+                continue;
+            }
+            vecVotes.emplace_back(vote);
+            ++nVoteCount;
+
+            if (vecVotes.size() == MAX_VOTES_PER_MESSAGE) {
+                connman.PushMessage(pnode, msgMaker.Make(NetMsgType::MNGOVERNANCEVOTES, vecVotes));
+                vecVotes.clear();
+            }
+        }
+    }
+
+    if (!vecVotes.empty()) {
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::MNGOVERNANCEVOTES, vecVotes));
+    }
+    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::SYNCSTATUSCOUNT, MASTERNODE_SYNC_GOVOBJ_VOTE, nVoteCount));
+    LogPrint("gobject", "CGovernanceManager::%s -- sent %d votes for %d sketches (%d up to date) to peer=%d\n", __func__,
+        nVoteCount, vecSketches.size(), nSkippedCount, pnode->id);
+}
+
 void CGovernanceManager::SyncObjects(CNode* pnode, CConnman& connman) const
 {
     // do not provide any data until our node is synced
@@ -809,7 +1177,7 @@ bool CGovernanceManager::MasternodeRateCheck(const CGovernanceObject& govobj, bo
     return false;
 }
 
-bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman)
+bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman, const uint256& nVerifiedKeyHash)
 {
     ENTER_CRITICAL_SECTION(cs);
     uint256 nHashVote = vote.GetHash();
@@ -858,7 +1226,10 @@ bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote,
         return false;
     }
 
-    bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman) && cmapVoteToObject.Insert(nHashVote, &govobj);
+    bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman, nVerifiedKeyHash) && cmapVoteToObject.Insert(nHashVote, &govobj);
+    if (fOk) {
+        setDirtyObjects.emplace(nHashGovobj);
+    }
     LEAVE_CRITICAL_SECTION(cs);
     return fOk;
 }
@@ -871,6 +1242,9 @@ void CGovernanceManager::CheckMasternodeOrphanVotes(CConnman& connman)
 
     for (auto& objPair : mapObjects) {
         objPair.second.CheckOrphanVotes(connman);
+        if (objPair.second.IsSetDirtyCache()) {
+            setDirtyObjects.emplace(objPair.first);
+        }
     }
 }
 
@@ -1011,6 +1385,29 @@ void CGovernanceManager::RequestGovernanceObject(CNode* pfrom, const uint256& nH
     connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::MNGOVERNANCESYNC, nHash, filter));
 }
 
+void CGovernanceManager::RequestGovernanceObjectVotesBySketches(CNode* pnode, const std::vector<uint256>& vecHashes, CConnman& connman)
+{
+    std::vector<CGovernanceVoteSketch> vecSketches;
+    {
+        LOCK(cs);
+        for (const auto& nHash : vecHashes) {
+            object_m_it it = mapObjects.find(nHash);
+            if (it == mapObjects.end()) {
+                continue;
+            }
+            vecSketches.emplace_back(nHash, it->second.GetVoteFile());
+        }
+        if (vecSketches.empty()) {
+            return;
+        }
+        mapVoteSketchRequests[pnode->GetId()] = GetTime() + VOTE_SKETCH_REQUEST_TIMEOUT;
+    }
+
+    LogPrint("gobject", "CGovernanceManager::%s -- sending %d vote sketches to peer=%d\n", __func__, vecSketches.size(), pnode->id);
+    CNetMsgMaker msgMaker(pnode->GetSendVersion());
+    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::MNGOVERNANCEVOTESKETCH, vecSketches));
+}
+
 int CGovernanceManager::RequestGovernanceObjectVotes(CNode* pnode, CConnman& connman)
 {
     if (pnode->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) return -3;
@@ -1077,6 +1474,40 @@ int CGovernanceManager::RequestGovernanceObjectVotes(const std::vector<CNode*>&
     std::random_shuffle(vTriggerObjHashes.begin(), vTriggerObjHashes.end(), insecure_rand);
     std::random_shuffle(vOtherObjHashes.begin(), vOtherObjHashes.end(), insecure_rand);
 
+    // Peers which understand vote sketches are asked for the missing votes of many objects with a single message, each
+    // object is only asked from one of them per call. Objects not covered this way are requested one by one below.
+    if (GetBoolArg("-governancevotesketch", DEFAULT_GOVERNANCE_VOTE_SKETCH)) {
+        std::set<uint256> setAsked;
+        for (const auto& pnode : vNodesCopy) {
+            // see below
+            if (pnode->fMasternode || (fMasternodeMode && pnode->fInbound)) continue;
+            if (pnode->nVersion < GOVERNANCE_VOTE_SKETCH_PROTO_VERSION) continue;
+            // peers only answer one sketch message per fulfilled request period, the rest is asked for one by one
+            if (netfulfilledman.HasFulfilledRequest(pnode->addr, "governance-vote-sketch")) continue;
+
+            std::vector<uint256> vecHashes;
+            for (const auto* pvecHashes : {&vTriggerObjHashes, &vOtherObjHashes}) {
+                for (const auto& nHash : *pvecHashes) {
+                    if (vecHashes.size() >= MAX_VOTE_SKETCHES_PER_MESSAGE) break;
+                    if (setAsked.count(nHash) || mapAskedRecently[nHash].count(pnode->addr)) continue;
+                    vecHashes.emplace_back(nHash);
+                }
+            }
+            if (vecHashes.empty()) continue;
+
+            RequestGovernanceObjectVotesBySketches(pnode, vecHashes, connman);
+            netfulfilledman.AddFulfilledRequest(pnode->addr, "governance-vote-sketch");
+            for (const auto& nHash : vecHashes) {
+                mapAskedRecently[nHash][pnode->addr] = nNow + nTimeout;
+                setAsked.emplace(nHash);
+            }
+        }
+
+        auto fAsked = [&](const uint256& nHash) { return setAsked.count(nHash) != 0; };
+        vTriggerObjHashes.erase(std::remove_if(vTriggerObjHashes.begin(), vTriggerObjHashes.end(), fAsked), vTriggerObjHashes.end());
+        vOtherObjHashes.erase(std::remove_if(vOtherObjHashes.begin(), vOtherObjHashes.end(), fAsked), vOtherObjHashes.end());
+    }
+
     for (int i = 0; i < nMaxObjRequestsPerNode; ++i) {
         uint256 nHashGovobj;
 
@@ -1156,6 +1587,13 @@ void CGovernanceManager::RebuildIndexes()
     cmapVoteToObject.Clear();
     for (auto& objPair : mapObjects) {
         CGovernanceObject& govobj = objPair.second;
+        if (!govobj.fVoteFileLoaded && governanceDb) {
+            // only read the keys, so that the votes themselves are not loaded before they're needed
+            governanceDb->ForEachVoteHash(objPair.first, [&](const uint256& nVoteHash) {
+                cmapVoteToObject.Insert(nVoteHash, &govobj);
+            });
+            continue;
+        }
         std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
         for (size_t i = 0; i < vecVotes.size(); ++i) {
             cmapVoteToObject.Insert(vecVotes[i].GetHash(), &govobj);
@@ -1179,6 +1617,7 @@ void CGovernanceManager::AddCachedTriggers()
             if (govobj.nDeletionTime == 0) {
                 govobj.nDeletionTime = GetAdjustedTime();
             }
+            setDirtyObjects.emplace(objpair.first);
         }
     }
 }
@@ -1190,10 +1629,137 @@ void CGovernanceManager::InitOnLoad()
     LogPrintf("Preparing masternode indexes and governance triggers...\n");
     RebuildIndexes();
     AddCachedTriggers();
+
+    // everything loaded has to be checked once, afterwards only changed objects are
+    for (const auto& objPair : mapObjects) {
+        setDirtyObjects.emplace(objPair.first);
+    }
+    mapErasedObjectsExpiry.clear();
+    for (const auto& erasedPair : mapErasedGovernanceObjects) {
+        if (erasedPair.second != std::numeric_limits<int64_t>::max()) {
+            mapErasedObjectsExpiry.emplace(erasedPair.second, erasedPair.first);
+        }
+    }
     LogPrintf("Masternode indexes and governance triggers prepared  %dms\n", GetTimeMillis() - nStart);
     LogPrintf("     %s\n", ToString());
 }
 
+bool CGovernanceManager::LoadFromDb()
+{
+    if (!governanceDb || !governanceDb->HasCurrentVersion()) {
+        return false;
+    }
+
+    LOCK(cs);
+
+    int64_t nStart = GetTimeMillis();
+
+    Clear();
+
+    governanceDb->ForEachObject([&](CGovernanceObject& govobj) {
+        CGovernanceObject& objref = mapObjects.emplace(govobj.GetHash(), govobj).first->second;
+        objref.fVoteFileLoaded = false;
+        objref.nStoredDeletionTime = objref.nDeletionTime;
+        objref.fStoredExpired = objref.fExpired;
+    });
+
+    size_t nVoteRecords = 0;
+    governanceDb->ForEachVoteRecord([&](const uint256& nParentHash, const COutPoint& mnOutpoint, const vote_rec_t& voteRecord) {
+        auto it = mapObjects.find(nParentHash);
+        if (it == mapObjects.end()) {
+            return;
+        }
+        it->second.mapCurrentMNVotes.emplace(mnOutpoint, voteRecord);
+        nVoteRecords++;
+    });
+
+    governanceDb->ReadState("erased", mapErasedGovernanceObjects);
+    governanceDb->ReadState("invalidvotes", cmapInvalidVotes);
+    governanceDb->ReadState("orphanvotes", cmmapOrphanVotes);
+    governanceDb->ReadState("lastobjects", mapLastMasternodeObject);
+    governanceDb->ReadState("mnlist", lastMNListForVotingKeys);
+
+    LogPrintf("CGovernanceManager::%s -- loaded %d objects and %d vote records, %dms\n", __func__,
+        mapObjects.size(), nVoteRecords, GetTimeMillis() - nStart);
+    return true;
+}
+
+void CGovernanceManager::WriteToDb()
+{
+    if (!governanceDb) {
+        return;
+    }
+
+    LOCK(cs);
+
+    int64_t nStart = GetTimeMillis();
+    size_t nVotes = 0;
+
+    CDBBatch batch(governanceDb->GetRawDB());
+    for (auto& p : mapObjects) {
+        CGovernanceObject& govobj = p.second;
+        WriteObjectToDb(batch, govobj);
+        for (const auto& vote : govobj.GetVoteFile().GetVotes()) {
+            governanceDb->WriteVote(batch, vote);
+            nVotes++;
+        }
+        for (const auto& voteRecordPair : govobj.mapCurrentMNVotes) {
+            governanceDb->WriteVoteRecord(batch, p.first, voteRecordPair.first, voteRecordPair.second);
+        }
+        if (batch.SizeEstimate() >= (1 << 24)) {
+            governanceDb->WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    WriteStateToDb(batch);
+    governanceDb->WriteBatch(batch);
+
+    // the version is written last, so that an interrupted import is simply redone
+    governanceDb->WriteCurrentVersion();
+
+    LogPrintf("CGovernanceManager::%s -- wrote %d objects and %d votes, %dms\n", __func__,
+        mapObjects.size(), nVotes, GetTimeMillis() - nStart);
+}
+
+void CGovernanceManager::FlushToDb()
+{
+    if (!governanceDb) {
+        return;
+    }
+
+    LOCK(cs);
+
+    CDBBatch batch(governanceDb->GetRawDB());
+    for (auto& p : mapObjects) {
+        CGovernanceObject& govobj = p.second;
+        if (govobj.nDeletionTime != govobj.nStoredDeletionTime || govobj.fExpired != govobj.fStoredExpired) {
+            WriteObjectToDb(batch, govobj);
+        }
+    }
+    WriteStateToDb(batch);
+    governanceDb->WriteBatch(batch);
+}
+
+void CGovernanceManager::WriteObjectToDb(CDBBatch& batch, CGovernanceObject& govobj)
+{
+    AssertLockHeld(cs);
+
+    governanceDb->WriteObject(batch, govobj);
+    govobj.nStoredDeletionTime = govobj.nDeletionTime;
+    govobj.fStoredExpired = govobj.fExpired;
+}
+
+void CGovernanceManager::WriteStateToDb(CDBBatch& batch)
+{
+    AssertLockHeld(cs);
+
+    governanceDb->WriteState(batch, "erased", mapErasedGovernanceObjects);
+    governanceDb->WriteState(batch, "invalidvotes", cmapInvalidVotes);
+    governanceDb->WriteState(batch, "orphanvotes", cmmapOrphanVotes);
+    governanceDb->WriteState(batch, "lastobjects", mapLastMasternodeObject);
+    governanceDb->WriteState(batch, "mnlist", lastMNListForVotingKeys);
+}
+
 std::string CGovernanceManager::ToString() const
 {
     LOCK(cs);
@@ -1320,6 +1886,17 @@ void CGovernanceManager::CleanOrphanObjects()
             cmmapOrphanVotes.Erase(prevIt->key, prevIt->value);
         }
     }
+
+    // forget vote sketch requests which were not answered in time
+    int64_t nTime = GetTime();
+    auto itSketch = mapVoteSketchRequests.begin();
+    while (itSketch != mapVoteSketchRequests.end()) {
+        if (itSketch->second < nTime) {
+            mapVoteSketchRequests.erase(itSketch++);
+        } else {
+            ++itSketch;
+        }
+    }
 }
 
 void CGovernanceManager::RemoveInvalidVotes()
@@ -1328,40 +1905,82 @@ void CGovernanceManager::RemoveInvalidVotes()
         return;
     }
 
-    LOCK(cs);
+    // The votes of changed MNs are collected while holding cs, but their signatures are verified after releasing it,
+    // as the verifier waits for the BLS worker pool. Votes are pairs of the vote and whether the voting key is used
+    std::vector<std::pair<CGovernanceVote, bool> > vecVotes;
+    {
+        LOCK(cs);
 
-    auto curMNList = deterministicMNManager->GetListAtChainTip();
-    auto diff = lastMNListForVotingKeys.BuildDiff(curMNList);
+        auto curMNList = deterministicMNManager->GetListAtChainTip();
+        auto diff = lastMNListForVotingKeys.BuildDiff(curMNList);
 
-    std::vector<COutPoint> changedKeyMNs;
-    for (const auto& p : diff.updatedMNs) {
-        auto oldDmn = lastMNListForVotingKeys.GetMNByInternalId(p.first);
-        if ((p.second.fields & CDeterministicMNStateDiff::Field_keyIDVoting) && p.second.state.keyIDVoting != oldDmn->pdmnState->keyIDVoting) {
-            changedKeyMNs.emplace_back(oldDmn->collateralOutpoint);
-        } else if ((p.second.fields & CDeterministicMNStateDiff::Field_pubKeyOperator) && p.second.state.pubKeyOperator != oldDmn->pdmnState->pubKeyOperator) {
-            changedKeyMNs.emplace_back(oldDmn->collateralOutpoint);
+        std::set<COutPoint> changedKeyMNs;
+        for (const auto& p : diff.updatedMNs) {
+            auto oldDmn = lastMNListForVotingKeys.GetMNByInternalId(p.first);
+            if ((p.second.fields & CDeterministicMNStateDiff::Field_keyIDVoting) && p.second.state.keyIDVoting != oldDmn->pdmnState->keyIDVoting) {
+                changedKeyMNs.emplace(oldDmn->collateralOutpoint);
+            } else if ((p.second.fields & CDeterministicMNStateDiff::Field_pubKeyOperator) && p.second.state.pubKeyOperator != oldDmn->pdmnState->pubKeyOperator) {
+                changedKeyMNs.emplace(oldDmn->collateralOutpoint);
+            }
+        }
+        for (const auto& id : diff.removedMns) {
+            auto oldDmn = lastMNListForVotingKeys.GetMNByInternalId(id);
+            changedKeyMNs.emplace(oldDmn->collateralOutpoint);
+        }
+
+        // store current MN list for the next run so that we can determine which keys changed
+        lastMNListForVotingKeys = curMNList;
+
+        if (changedKeyMNs.empty()) {
+            return;
         }
-    }
-    for (const auto& id : diff.removedMns) {
-        auto oldDmn = lastMNListForVotingKeys.GetMNByInternalId(id);
-        changedKeyMNs.emplace_back(oldDmn->collateralOutpoint);
-    }
 
-    for (const auto& outpoint : changedKeyMNs) {
         for (auto& p : mapObjects) {
-            auto removed = p.second.RemoveInvalidVotes(outpoint);
-            if (removed.empty()) {
-                continue;
-            }
-            for (auto& voteHash : removed) {
-                cmapVoteToObject.Erase(voteHash);
-                cmapInvalidVotes.Erase(voteHash);
-                cmmapOrphanVotes.Erase(voteHash);
-                setRequestedVotes.erase(voteHash);
+            bool fProposal = p.second.GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL;
+            for (auto& vote : p.second.GetVotesOfMasternodes(changedKeyMNs)) {
+                bool useVotingKey = fProposal && vote.GetSignal() == VOTE_SIGNAL_FUNDING;
+                vecVotes.emplace_back(std::move(vote), useVotingKey);
             }
         }
     }
 
-    // store current MN list for the next run so that we can determine which keys changed
-    lastMNListForVotingKeys = curMNList;
+    if (vecVotes.empty()) {
+        return;
+    }
+
+    // the votes of all changed MNs are revalidated at once, so that their signatures are batch verified
+    CGovernanceVoteBatchVerifier verifier;
+    for (const auto& p : vecVotes) {
+        verifier.PushVote(p.first, p.second);
+    }
+    verifier.Verify();
+
+    std::map<uint256, std::vector<CGovernanceVote> > mapInvalidVotes;
+    for (const auto& p : vecVotes) {
+        // votes of removed masternodes are not verified at all
+        if (!verifier.mapValidVotes.count(p.first.GetHash())) {
+            mapInvalidVotes[p.first.GetParentHash()].emplace_back(p.first);
+        }
+    }
+
+    LOCK(cs);
+
+    for (const auto& p : mapInvalidVotes) {
+        // the object might have been removed in the meantime
+        object_m_it it = mapObjects.find(p.first);
+        if (it == mapObjects.end()) {
+            continue;
+        }
+        auto removed = it->second.RemoveInvalidVotes(p.second);
+        if (removed.empty()) {
+            continue;
+        }
+        setDirtyObjects.emplace(p.first);
+        for (auto& voteHash : removed) {
+            cmapVoteToObject.Erase(voteHash);
+            cmapInvalidVotes.Erase(voteHash);
+            cmmapOrphanVotes.Erase(voteHash);
+            setRequestedVotes.erase(voteHash);
+        }
+    }
 }
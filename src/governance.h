@@ -14,13 +14,17 @@
 #include "governance-vote.h"
 #include "net.h"
 #include "sync.h"
+#include "threadinterrupt.h"
 #include "timedata.h"
 #include "util.h"
 
 #include "evo/deterministicmns.h"
 
+#include <thread>
+
 #include <univalue.h>
 
+class CDBBatch;
 class CGovernanceManager;
 class CGovernanceTriggerManager;
 class CGovernanceObject;
@@ -38,6 +42,39 @@ struct ExpirationInfo {
 
 typedef std::pair<CGovernanceObject, ExpirationInfo> object_info_pair_t;
 
+static const bool DEFAULT_GOVERNANCE_VOTE_SKETCH = true;
+
+/**
+ * Compact summary of the votes we know for a governance object, sent to peers in MNGOVERNANCEVOTESKETCH.
+ *
+ * If count and set hash match the peer's votes, the peer skips the object without looking at its votes. Otherwise it
+ * sends back all votes which are not in the filter. The filter is sized for the actual number of votes instead of
+ * nGovernanceFilterElements, so an object with few votes only costs a few bytes.
+ */
+class CGovernanceVoteSketch
+{
+public:
+    uint256 nParentHash;
+    int32_t nVoteCount{0};
+    uint256 nVoteSetHash;
+    CBloomFilter filter;
+
+public:
+    CGovernanceVoteSketch() {}
+    CGovernanceVoteSketch(const uint256& nParentHashIn, const CGovernanceObjectVoteFile& fileVotes);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(nParentHash);
+        READWRITE(nVoteCount);
+        READWRITE(nVoteSetHash);
+        READWRITE(filter);
+    }
+};
+
 static const int RATE_BUFFER_SIZE = 5;
 
 class CRateCheckBuffer
@@ -228,6 +265,12 @@ private:
     static const int MAX_TIME_FUTURE_DEVIATION;
     static const int RELIABLE_PROPAGATION_TIME;
 
+    static const size_t MAX_VOTE_SKETCHES_PER_MESSAGE = 1000;
+    static const size_t MAX_VOTES_PER_MESSAGE = 1000;
+    static const size_t MAX_PENDING_VOTES = 100000;
+    static const size_t MAX_VOTES_PER_ROUND = 4096;
+    static const int VOTE_SKETCH_REQUEST_TIMEOUT = 60;
+
     int64_t nTimeLastDiff;
 
     // keep track of current block height
@@ -264,6 +307,26 @@ private:
     // used to check for changed voting keys
     CDeterministicMNList lastMNListForVotingKeys;
 
+    // objects which changed since the last maintenance, their cached variables are recalculated and their next
+    // check is rescheduled by UpdateCachesAndClean
+    hash_s_t setDirtyObjects;
+
+    // time ordered queue of objects to be checked for deletion or expiration, entries might be outdated
+    std::set<std::pair<int64_t, uint256> > setScheduledObjectChecks;
+
+    // expiration times of entries in mapErasedGovernanceObjects, entries which never expire are not added
+    std::multimap<int64_t, uint256> mapErasedObjectsExpiry;
+
+    // peers we sent vote sketches to and until when we accept MNGOVERNANCEVOTES from them
+    std::map<NodeId, int64_t> mapVoteSketchRequests;
+
+    // votes received from peers, their signatures are verified in batches by the worker thread before they are
+    // processed
+    std::map<uint256, std::pair<NodeId, CGovernanceVote> > mapPendingVotes;
+
+    std::thread workThread;
+    CThreadInterrupt workInterrupt;
+
     class ScopedLockBool
     {
         bool& ref;
@@ -300,10 +363,15 @@ public:
     bool ConfirmInventoryRequest(const CInv& inv);
 
     void SyncSingleObjVotes(CNode* pnode, const uint256& nProp, const CBloomFilter& filter, CConnman& connman);
+    void SyncVotesBySketches(CNode* pnode, std::vector<CGovernanceVoteSketch>& vecSketches, CConnman& connman);
     void SyncObjects(CNode* pnode, CConnman& connman) const;
 
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
 
+    void StartWorkerThread();
+    void StopWorkerThread();
+    void InterruptWorkerThread();
+
     void DoMaintenance(CConnman& connman);
 
     CGovernanceObject* FindGovernanceObject(const uint256& nHash);
@@ -316,6 +384,13 @@ public:
 
     void UpdateCachesAndClean();
 
+    /// Marks the object to have its cached variables recalculated and its next check rescheduled
+    void MarkObjectDirty(const uint256& nHash)
+    {
+        LOCK(cs);
+        setDirtyObjects.emplace(nHash);
+    }
+
     void CheckAndRemove() { UpdateCachesAndClean(); }
 
     void Clear()
@@ -329,6 +404,11 @@ public:
         cmapInvalidVotes.Clear();
         cmmapOrphanVotes.Clear();
         mapLastMasternodeObject.clear();
+        setDirtyObjects.clear();
+        setScheduledObjectChecks.clear();
+        mapErasedObjectsExpiry.clear();
+        mapVoteSketchRequests.clear();
+        mapPendingVotes.clear();
     }
 
     std::string ToString() const;
@@ -360,6 +440,16 @@ public:
         READWRITE(lastMNListForVotingKeys);
     }
 
+    /**
+     * Loads objects and vote records from the governance db, votes are loaded on demand.
+     * Returns false if the db does not contain any data yet.
+     */
+    bool LoadFromDb();
+    /// Writes everything to the governance db, used when importing governance.dat of older versions
+    void WriteToDb();
+    /// Writes caches and objects which changed since they were written to the governance db
+    void FlushToDb();
+
     void UpdatedBlockTip(const CBlockIndex* pindex, CConnman& connman);
     int64_t GetLastDiffTime() const { return nTimeLastDiff; }
     void UpdateLastDiffTime(int64_t nTimeIn) { nTimeLastDiff = nTimeIn; }
@@ -421,6 +511,7 @@ public:
 
 private:
     void RequestGovernanceObject(CNode* pfrom, const uint256& nHash, CConnman& connman, bool fUseFilter = false);
+    void RequestGovernanceObjectVotesBySketches(CNode* pnode, const std::vector<uint256>& vecHashes, CConnman& connman);
 
     void AddInvalidVote(const CGovernanceVote& vote)
     {
@@ -432,7 +523,13 @@ private:
         cmmapOrphanVotes.Insert(vote.GetHash(), vote_time_pair_t(vote, GetAdjustedTime() + GOVERNANCE_ORPHAN_EXPIRATION_TIME));
     }
 
-    bool ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman);
+    bool ProcessVote(CNode* pfrom, const CGovernanceVote& vote, CGovernanceException& exception, CConnman& connman, const uint256& nVerifiedKeyHash = uint256());
+
+    /// Queues a vote received from a peer for signature verification, votes for unknown objects are orphaned right away
+    void AddPendingVote(CNode* pfrom, const CGovernanceVote& vote, CConnman& connman);
+    /// Verifies the signatures of the next round of pending votes and processes the valid ones
+    bool ProcessPendingVotes(CConnman& connman);
+    void WorkThreadMain();
 
     /// Called to indicate a requested object has been received
     bool AcceptObjectMessage(const uint256& nHash);
@@ -444,6 +541,13 @@ private:
 
     void CheckOrphanVotes(CGovernanceObject& govobj, CGovernanceException& exception, CConnman& connman);
 
+    void ScheduleObjectCheck(const CGovernanceObject& govobj);
+    void CheckObject(object_m_it it, int64_t nNow);
+    void EraseObject(object_m_it it);
+
+    void WriteObjectToDb(CDBBatch& batch, CGovernanceObject& govobj);
+    void WriteStateToDb(CDBBatch& batch);
+
     void RebuildIndexes();
 
     void AddCachedTriggers();
@@ -48,6 +48,7 @@
 #include "dsnotificationinterface.h"
 #include "flat-database.h"
 #include "governance.h"
+#include "governance-db.h"
 #include "instantx.h"
 #ifdef ENABLE_WALLET
 #include "keepass.h"
@@ -211,6 +212,8 @@ void Interrupt(boost::thread_group& threadGroup)
     InterruptREST();
     InterruptTorControl();
     llmq::InterruptLLMQSystem();
+    governance.InterruptWorkerThread();
+    privateSendServer.InterruptWorkerThread();
     if (g_connman)
         g_connman->Interrupt();
     threadGroup.interrupt_all();
@@ -235,6 +238,9 @@ void PrepareShutdown()
     StopREST();
     StopRPC();
     StopHTTPServer();
+    // the governance worker verifies votes on the BLS worker pool, so stop it first
+    governance.StopWorkerThread();
+    privateSendServer.StopWorkerThread();
     llmq::StopLLMQSystem();
 
     // fRPCInWarmup should be `false` if we completed the loading sequence
@@ -264,8 +270,7 @@ void PrepareShutdown()
         // STORE DATA CACHES INTO SERIALIZED DAT FILES
         CFlatDB<CMasternodeMetaMan> flatdb1("mncache.dat", "magicMasternodeCache");
         flatdb1.Dump(mmetaman);
-        CFlatDB<CGovernanceManager> flatdb3("governance.dat", "magicGovernanceCache");
-        flatdb3.Dump(governance);
+        governance.FlushToDb();
         CFlatDB<CNetFulfilledRequestManager> flatdb4("netfulfilled.dat", "magicFulfilledCache");
         flatdb4.Dump(netfulfilledman);
         if(fEnableInstantSend)
@@ -311,6 +316,8 @@ void PrepareShutdown()
         delete evoDb;
         evoDb = NULL;
     }
+    delete governanceDb;
+    governanceDb = NULL;
 #ifdef ENABLE_WALLET
     if (pwalletMain)
         pwalletMain->Flush(true);
@@ -569,7 +576,10 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS));
         strUsage += HelpMessageOpt("-logthreadnames", strprintf("Add thread names to debug messages (default: %u)", DEFAULT_LOGTHREADNAMES));
         strUsage += HelpMessageOpt("-mocktime=<n>", "Replace actual time with <n> seconds since epoch (default: 0)");
-        strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit size of signature cache to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-dmnlistcachesize=<n>", strprintf("Number of recently requested historic masternode lists to keep in memory (default: %u)", CDeterministicMNManager::DEFAULT_LISTS_LRU_SIZE));
+        strUsage += HelpMessageOpt("-dmnsnapshotperiod=<n>", strprintf("Write a full masternode list snapshot to disk every <n> blocks (default: %u)", CDeterministicMNManager::DEFAULT_SNAPSHOT_LIST_PERIOD));
+        strUsage += HelpMessageOpt("-governancevotesketch", strprintf("Request missing governance votes from peers with vote set sketches instead of one request per object (default: %u)", DEFAULT_GOVERNANCE_VOTE_SKETCH));
+        strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
         strUsage += HelpMessageOpt("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE));
     }
     strUsage += HelpMessageOpt("-minrelaytxfee=<amt>", strprintf(_("Fees (in %s/kB) smaller than this are considered zero fee for relaying, mining and transaction creation (default: %s)"),
@@ -1482,6 +1492,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     LogPrintf("Using at most %i automatic connections (%i file descriptors available)\n", nMaxConnections, nFD);
 
     InitSignatureCache();
+    InitScriptExecutionCache();
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
@@ -1757,6 +1768,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     nCoinCacheUsage = nTotalCache; // the rest goes to in-memory cache
     int64_t nMempoolSizeMax = GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     int64_t nEvoDbCache = 1024 * 1024 * 16; // TODO
+    int64_t nGovernanceDbCache = 1024 * 1024 * 8;
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
@@ -1909,6 +1921,10 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     fFeeEstimatesInitialized = true;
 
     // ********************************************************* Step 8: load wallet
+
+    // the wallet computes PrivateSend rounds of its coins while loading and rescanning
+    CPrivateSend::InitStandardDenominations();
+
 #ifdef ENABLE_WALLET
     if (!CWallet::InitLoadWallet())
         return false;
@@ -1992,8 +2008,6 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     LogPrintf("PrivateSend denoms: %d\n", privateSendClient.nPrivateSendDenoms);
 #endif // ENABLE_WALLET
 
-    CPrivateSend::InitStandardDenominations();
-
     // ********************************************************* Step 10b: setup InstantSend
 
     fEnableInstantSend = GetBoolArg("-enableinstantsend", 1);
@@ -2003,6 +2017,14 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     // LOAD SERIALIZED DAT FILES INTO DATA CACHES FOR INTERNAL USE
 
     bool fIgnoreCacheFiles = fLiteMode || fReindex || fReindexChainState;
+    if (!fLiteMode) {
+        delete governanceDb;
+        governanceDb = new CGovernanceDb(nGovernanceDbCache, false, fReindex || fReindexChainState);
+        if (fIgnoreCacheFiles) {
+            // mark the wiped db as current, so that an old governance.dat is not imported on the next start
+            governance.WriteToDb();
+        }
+    }
     if (!fIgnoreCacheFiles) {
         boost::filesystem::path pathDB = GetDataDir();
         std::string strDBName;
@@ -2014,11 +2036,18 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             return InitError(_("Failed to load masternode cache from") + "\n" + (pathDB / strDBName).string());
         }
 
-        strDBName = "governance.dat";
         uiInterface.InitMessage(_("Loading governance cache..."));
-        CFlatDB<CGovernanceManager> flatdb3(strDBName, "magicGovernanceCache");
-        if(!flatdb3.Load(governance)) {
-            return InitError(_("Failed to load governance cache from") + "\n" + (pathDB / strDBName).string());
+        if (!governance.LoadFromDb()) {
+            // import governance.dat of previous versions once. The file is not written anymore, but it is left in
+            // place: after a downgrade it still holds the state at import time and the rest is synced again
+            strDBName = "governance.dat";
+            if (boost::filesystem::exists(pathDB / strDBName)) {
+                CFlatDB<CGovernanceManager> flatdb3(strDBName, "magicGovernanceCache");
+                if(!flatdb3.Load(governance)) {
+                    return InitError(_("Failed to load governance cache from") + "\n" + (pathDB / strDBName).string());
+                }
+            }
+            governance.WriteToDb();
         }
         governance.InitOnLoad();
 
@@ -2062,6 +2091,13 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     llmq::StartLLMQSystem();
 
+    if (!fLiteMode) {
+        governance.StartWorkerThread();
+        if (fMasternodeMode) {
+            privateSendServer.StartWorkerThread();
+        }
+    }
+
     // ********************************************************* Step 11: import blocks
 
     if (!CheckDiskSpace())
@@ -0,0 +1,74 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef JEMCASH_LATENCYHISTOGRAM_H
+#define JEMCASH_LATENCYHISTOGRAM_H
+
+#include "univalue.h"
+
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Histogram of latencies with power-of-two millisecond buckets. Bucket i counts latencies below 2^i ms (and not below
+ * 2^(i-1) ms), the last bucket counts everything above. Thread-safe.
+ */
+class CLatencyHistogram
+{
+public:
+    static const size_t BUCKET_COUNT = 16;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<uint64_t> buckets;
+    uint64_t nCount{0};
+    int64_t nTotalTime{0};
+    int64_t nMaxTime{0};
+
+public:
+    CLatencyHistogram() : buckets(BUCKET_COUNT, 0) {}
+
+    void Add(int64_t nMicros)
+    {
+        if (nMicros < 0) {
+            nMicros = 0;
+        }
+        size_t i = 0;
+        while (i < BUCKET_COUNT - 1 && (nMicros / 1000) >= ((int64_t)1 << i)) {
+            i++;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        buckets[i]++;
+        nCount++;
+        nTotalTime += nMicros;
+        nMaxTime = std::max(nMaxTime, nMicros);
+    }
+
+    void ToJson(UniValue& obj) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        obj.setObject();
+        obj.push_back(Pair("count", nCount));
+        obj.push_back(Pair("avg", nCount ? nTotalTime * 0.001 / nCount : 0.0));
+        obj.push_back(Pair("max", nMaxTime * 0.001));
+
+        UniValue bucketsArr(UniValue::VARR);
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            UniValue b(UniValue::VOBJ);
+            if (i < BUCKET_COUNT - 1) {
+                b.push_back(Pair("lt", (int64_t)1 << i));
+            } else {
+                b.push_back(Pair("gte", (int64_t)1 << (i - 1)));
+            }
+            b.push_back(Pair("count", buckets[i]));
+            bucketsArr.push_back(b);
+        }
+        obj.push_back(Pair("buckets", bucketsArr));
+    }
+};
+
+#endif // JEMCASH_LATENCYHISTOGRAM_H
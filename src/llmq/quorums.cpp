@@ -26,6 +26,7 @@ namespace llmq
 
 static const std::string DB_QUORUM_SK_SHARE = "q_Qsk";
 static const std::string DB_QUORUM_QUORUM_VVEC = "q_Qqvvec";
+static const std::string DB_QUORUM_PUBKEY_SHARES = "q_Qpks";
 
 CQuorumManager* quorumManager;
 
@@ -84,6 +85,9 @@ CBLSPublicKey CQuorum::GetPubKeyShare(size_t memberIdx) const
     if (quorumVvec == nullptr || memberIdx >= members.size() || !qc.validMembers[memberIdx]) {
         return CBLSPublicKey();
     }
+    if (pubKeySharesReady) {
+        return pubKeyShares[memberIdx];
+    }
     auto& m = members[memberIdx];
     return blsCache.BuildPubKeyShare(m->proTxHash, quorumVvec, CBLSId::FromHash(m->proTxHash));
 }
@@ -130,12 +134,20 @@ bool CQuorum::ReadContributions(CEvoDB& evoDb)
     // member of the quorum but observed the whole DKG process to have the quorum verification vector.
     evoDb.Read(std::make_pair(DB_QUORUM_SK_SHARE, dbKey), skShare);
 
+    // Also optional, missing when the node was stopped before the shares were recovered
+    std::vector<CBLSPublicKey> pks;
+    if (evoDb.Read(std::make_pair(DB_QUORUM_PUBKEY_SHARES, dbKey), pks) && pks.size() == members.size()) {
+        pubKeyShares = std::move(pks);
+        pubKeySharesReady = true;
+        pubKeySharesWritten = true;
+    }
+
     return true;
 }
 
 void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this)
 {
-    if (_this->quorumVvec == nullptr) {
+    if (_this->quorumVvec == nullptr || _this->pubKeySharesReady) {
         return;
     }
 
@@ -146,11 +158,35 @@ void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this)
     // when then later some other thread tries to get keys, it will be much faster
     _this->cachePopulatorThread = std::thread([_this, t]() {
         RenameThread("dash-q-cachepop");
-        for (size_t i = 0; i < _this->members.size() && !_this->stopCachePopulatorThread && !ShutdownRequested(); i++) {
-            if (_this->qc.validMembers[i]) {
-                _this->GetPubKeyShare(i);
-            }
+
+        // The shares are recovered in parallel on threads owned by this one and not on the BLS worker pool, as the
+        // pool is stopped on shutdown before the quorums (and thus this thread) are destroyed
+        std::vector<CBLSPublicKey> pks(_this->members.size());
+        size_t threadCount = std::max(1, std::min(GetNumCores(), 4));
+        std::vector<std::thread> recoveryThreads;
+        for (size_t t = 0; t < threadCount; t++) {
+            recoveryThreads.emplace_back([&_this, &pks, threadCount, t]() {
+                for (size_t i = t; i < _this->members.size(); i += threadCount) {
+                    if (_this->stopCachePopulatorThread || ShutdownRequested()) {
+                        return;
+                    }
+                    if (_this->qc.validMembers[i]) {
+                        pks[i].PublicKeyShare(*_this->quorumVvec, CBLSId::FromHash(_this->members[i]->proTxHash));
+                    }
+                }
+            });
+        }
+        for (auto& thread : recoveryThreads) {
+            thread.join();
         }
+        if (_this->stopCachePopulatorThread || ShutdownRequested()) {
+            return;
+        }
+
+        // written to evodb later by CQuorumManager::WritePubKeyShares
+        _this->pubKeyShares = std::move(pks);
+        _this->pubKeySharesReady = true;
+
         LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- done. time=%d\n", t.count());
     });
 }
@@ -164,6 +200,8 @@ CQuorumManager::CQuorumManager(CEvoDB& _evoDb, CBLSWorker& _blsWorker, CDKGSessi
 
 void CQuorumManager::UpdatedBlockTip(const CBlockIndex* pindexNew, bool fInitialDownload)
 {
+    WritePubKeyShares();
+
     if (!masternodeSync.IsBlockchainSynced()) {
         return;
     }
@@ -228,6 +266,25 @@ void CQuorumManager::EnsureQuorumConnections(Consensus::LLMQType llmqType, const
     }
 }
 
+void CQuorumManager::WritePubKeyShares()
+{
+    std::vector<CQuorumPtr> quorumsToWrite;
+    {
+        LOCK(quorumsCacheCs);
+        for (auto& p : quorumsCache) {
+            auto& quorum = p.second;
+            if (quorum->pubKeySharesReady && !quorum->pubKeySharesWritten) {
+                quorum->pubKeySharesWritten = true;
+                quorumsToWrite.emplace_back(quorum);
+            }
+        }
+    }
+
+    for (auto& quorum : quorumsToWrite) {
+        evoDb.GetRawDB().Write(std::make_pair(DB_QUORUM_PUBKEY_SHARES, MakeQuorumKey(*quorum)), quorum->pubKeyShares);
+    }
+}
+
 bool CQuorumManager::BuildQuorumFromCommitment(const CFinalCommitment& qc, const CBlockIndex* pindexQuorum, const uint256& minedBlockHash, std::shared_ptr<CQuorum>& quorum) const
 {
     assert(pindexQuorum);
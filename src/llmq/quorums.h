@@ -46,14 +46,21 @@ public:
     CBLSSecretKey skShare;
 
 private:
-    // Recovery of public key shares is very slow, so we start a background thread that pre-populates a cache so that
-    // the public key shares are ready when needed later
+    // Recovery of public key shares is very slow, so we start a background thread that recovers the shares of all
+    // members, so that they are ready when needed later. CQuorumManager then persists them, so that they don't need to
+    // be recovered again after a restart
     mutable CBLSWorkerCache blsCache;
     std::atomic<bool> stopCachePopulatorThread;
     std::thread cachePopulatorThread;
 
+    // Indexed by member index. Only written before pubKeySharesReady is set and never modified afterwards
+    std::vector<CBLSPublicKey> pubKeyShares;
+    std::atomic<bool> pubKeySharesReady;
+    // protected by CQuorumManager::quorumsCacheCs
+    bool pubKeySharesWritten;
+
 public:
-    CQuorum(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker) : params(_params), blsCache(_blsWorker), stopCachePopulatorThread(false) {}
+    CQuorum(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker) : params(_params), blsCache(_blsWorker), stopCachePopulatorThread(false), pubKeySharesReady(false), pubKeySharesWritten(false) {}
     ~CQuorum();
     void Init(const CFinalCommitment& _qc, const CBlockIndex* _pindexQuorum, const uint256& _minedBlockHash, const std::vector<CDeterministicMNCPtr>& _members);
 
@@ -107,6 +114,8 @@ public:
 private:
     // all private methods here are cs_main-free
     void EnsureQuorumConnections(Consensus::LLMQType llmqType, const CBlockIndex *pindexNew);
+    // Persists the public key shares which were recovered by cache populator threads since the last call
+    void WritePubKeyShares();
 
     bool BuildQuorumFromCommitment(const CFinalCommitment& qc, const CBlockIndex* pindexQuorum, const uint256& minedBlockHash, std::shared_ptr<CQuorum>& quorum) const;
     bool BuildQuorumContributions(const CFinalCommitment& fqc, std::shared_ptr<CQuorum>& quorum) const;
@@ -10,10 +10,12 @@
 
 #include "chain.h"
 #include "masternode-sync.h"
+#include "memusage.h"
 #include "net_processing.h"
 #include "scheduler.h"
 #include "spork.h"
 #include "txmempool.h"
+#include "util.h"
 #include "validation.h"
 
 namespace llmq
@@ -28,8 +30,217 @@ std::string CChainLockSig::ToString() const
     return strprintf("CChainLockSig(nHeight=%d, blockHash=%s)", nHeight, blockHash.ToString());
 }
 
+CChainLocksTxTracker::CChainLocksTxTracker(int64_t nWindowIn, size_t nMaxEntriesIn) :
+    nWindow(nWindowIn),
+    nMaxEntries(nMaxEntriesIn),
+    // one more bucket than needed to cover the window, so that the newest bucket never overlaps the oldest one
+    buckets((nWindowIn + BUCKET_SECONDS - 1) / BUCKET_SECONDS + 1)
+{
+}
+
+bool CChainLocksTxTracker::AddTx(const uint256& txid, int64_t nFirstSeenTime)
+{
+    if (txs.count(txid) || !MakeRoom(1)) {
+        return false;
+    }
+    auto bucket = GetBucket(nFirstSeenTime);
+    if (!bucket) {
+        return false;
+    }
+    txs.emplace(txid, TxEntry{nFirstSeenTime, false});
+    bucket->txids.emplace_back(txid);
+    nEntries++;
+    return true;
+}
+
+void CChainLocksTxTracker::SetTxLocked(const uint256& txid)
+{
+    auto it = txs.find(txid);
+    if (it != txs.end()) {
+        it->second.fLocked = true;
+    }
+}
+
+bool CChainLocksTxTracker::GetTx(const uint256& txid, int64_t& nFirstSeenTimeRet, bool& fLockedRet) const
+{
+    auto it = txs.find(txid);
+    if (it == txs.end()) {
+        return false;
+    }
+    nFirstSeenTimeRet = it->second.nFirstSeenTime;
+    fLockedRet = it->second.fLocked;
+    return true;
+}
+
+bool CChainLocksTxTracker::IsTxSafe(const uint256& txid, int64_t nTime) const
+{
+    auto it = txs.find(txid);
+    if (it == txs.end()) {
+        return IsComplete(nTime);
+    }
+    return it->second.fLocked || nTime - it->second.nFirstSeenTime >= nWindow;
+}
+
+bool CChainLocksTxTracker::AddBlock(const uint256& blockHash, int64_t nTime, int64_t nConnectedTimeMicros)
+{
+    if (blocks.count(blockHash) || !MakeRoom(1)) {
+        return false;
+    }
+    auto bucket = GetBucket(nTime);
+    if (!bucket) {
+        return false;
+    }
+    blocks.emplace(blockHash, BlockEntry{nTime, nConnectedTimeMicros, std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>()});
+    bucket->blockHashes.emplace_back(blockHash);
+    nEntries++;
+    return true;
+}
+
+bool CChainLocksTxTracker::AddBlockTx(const uint256& blockHash, const uint256& txid)
+{
+    auto it = blocks.find(blockHash);
+    if (it == blocks.end()) {
+        return false;
+    }
+    if (it->second.txids->count(txid)) {
+        return false;
+    }
+    bool fHasRoom = MakeRoom(1);
+    // making room might have dropped the block
+    it = blocks.find(blockHash);
+    if (it == blocks.end()) {
+        return false;
+    }
+    if (!fHasRoom) {
+        // an incomplete block must not look safe, it has to be read from disk again
+        nEntries -= 1 + it->second.txids->size();
+        blocks.erase(it);
+        return false;
+    }
+    it->second.txids->emplace(txid);
+    nEntries++;
+    return true;
+}
+
+bool CChainLocksTxTracker::GetBlock(const uint256& blockHash, TxIdsPtr& txidsRet, int64_t& nConnectedTimeMicrosRet) const
+{
+    auto it = blocks.find(blockHash);
+    if (it == blocks.end()) {
+        return false;
+    }
+    txidsRet = it->second.txids;
+    nConnectedTimeMicrosRet = it->second.nConnectedTimeMicros;
+    return true;
+}
+
+void CChainLocksTxTracker::Expire(int64_t nTime)
+{
+    nLastTime = std::max(nLastTime, nTime);
+    for (auto& bucket : buckets) {
+        if (bucket.nSlot != -1 && IsExpired(bucket.nSlot)) {
+            ClearBucket(bucket);
+        }
+    }
+}
+
+bool CChainLocksTxTracker::IsComplete(int64_t nTime) const
+{
+    return nIncompleteUntil <= nTime - nWindow;
+}
+
+size_t CChainLocksTxTracker::GetMemoryUsage() const
+{
+    size_t usage = memusage::DynamicUsage(txs) + memusage::DynamicUsage(blocks) + memusage::DynamicUsage(buckets);
+    for (auto& p : blocks) {
+        usage += memusage::DynamicUsage(p.second.txids) + memusage::DynamicUsage(*p.second.txids);
+    }
+    for (auto& bucket : buckets) {
+        usage += memusage::DynamicUsage(bucket.txids) + memusage::DynamicUsage(bucket.blockHashes);
+    }
+    return usage;
+}
+
+bool CChainLocksTxTracker::IsExpired(int64_t nSlot) const
+{
+    // only expire a bucket when even its newest entries are older than the window
+    return (nSlot + 1) * BUCKET_SECONDS <= nLastTime - nWindow;
+}
+
+CChainLocksTxTracker::Bucket* CChainLocksTxTracker::GetBucket(int64_t nTime)
+{
+    nLastTime = std::max(nLastTime, nTime);
+
+    int64_t nSlot = nTime / BUCKET_SECONDS;
+    if (IsExpired(nSlot)) {
+        return nullptr;
+    }
+    auto& bucket = buckets[nSlot % buckets.size()];
+    if (bucket.nSlot != nSlot) {
+        if (bucket.nSlot > nSlot) {
+            return nullptr;
+        }
+        // the previous slot of this bucket is expired already
+        ClearBucket(bucket);
+        bucket.nSlot = nSlot;
+    }
+    return &bucket;
+}
+
+void CChainLocksTxTracker::ClearBucket(Bucket& bucket)
+{
+    for (auto& txid : bucket.txids) {
+        auto it = txs.find(txid);
+        if (it != txs.end() && it->second.nFirstSeenTime / BUCKET_SECONDS == bucket.nSlot) {
+            txs.erase(it);
+            nEntries--;
+        }
+    }
+    for (auto& blockHash : bucket.blockHashes) {
+        auto it = blocks.find(blockHash);
+        if (it != blocks.end() && it->second.nTime / BUCKET_SECONDS == bucket.nSlot) {
+            nEntries -= 1 + it->second.txids->size();
+            blocks.erase(it);
+        }
+    }
+    bucket.nSlot = -1;
+    bucket.txids.clear();
+    bucket.txids.shrink_to_fit();
+    bucket.blockHashes.clear();
+    bucket.blockHashes.shrink_to_fit();
+}
+
+bool CChainLocksTxTracker::MakeRoom(size_t nCount)
+{
+    int64_t nCurrentSlot = nLastTime / BUCKET_SECONDS;
+    while (nEntries + nCount > nMaxEntries) {
+        // drop the oldest bucket, but never the current one
+        Bucket* oldest = nullptr;
+        for (auto& bucket : buckets) {
+            if (bucket.nSlot != -1 && bucket.nSlot < nCurrentSlot && (!oldest || bucket.nSlot < oldest->nSlot)) {
+                oldest = &bucket;
+            }
+        }
+        if (!oldest) {
+            SetIncompleteUntil(nCurrentSlot);
+            return false;
+        }
+        LogPrint("chainlocks", "CChainLocksTxTracker::%s -- too many entries (%d), dropping bucket of slot %d early\n", __func__,
+                 nEntries, oldest->nSlot);
+        SetIncompleteUntil(oldest->nSlot);
+        ClearBucket(*oldest);
+        nEvictedBuckets++;
+    }
+    return true;
+}
+
+void CChainLocksTxTracker::SetIncompleteUntil(int64_t nSlot)
+{
+    nIncompleteUntil = std::max(nIncompleteUntil, (nSlot + 1) * BUCKET_SECONDS);
+}
+
 CChainLocksHandler::CChainLocksHandler(CScheduler* _scheduler) :
-    scheduler(_scheduler)
+    scheduler(_scheduler),
+    txTracker(WAIT_FOR_ISLOCK_TIMEOUT, MAX_TRACKED_TXS)
 {
 }
 
@@ -39,18 +250,76 @@ CChainLocksHandler::~CChainLocksHandler()
 
 void CChainLocksHandler::Start()
 {
+    {
+        LOCK2(cs_main, cs);
+        tipIndex = chainActive.Tip();
+        isDIP0008Active = tipIndex && VersionBitsState(tipIndex->pprev, Params().GetConsensus(), Consensus::DEPLOYMENT_DIP0008, versionbitscache) == THRESHOLD_ACTIVE;
+    }
+
     quorumSigningManager->RegisterRecoveredSigsListener(this);
+
+    // can't start new thread if we have one running already
+    if (workThread.joinable()) {
+        assert(false);
+    }
+
+    workInterrupt.reset();
+    workThread = std::thread(&TraceThread<std::function<void()> >, "chainlocks", std::function<void()>(std::bind(&CChainLocksHandler::WorkThreadMain, this)));
+
+    // expiring tracked TXs only needs cs, but there is no need to do it on the signing thread
     scheduler->scheduleEvery([&]() {
-        CheckActiveState();
-        EnforceBestChainLock();
-        // regularly retry signing the current chaintip as it might have failed before due to missing ixlocks
-        TrySignChainTip();
-    }, 5000);
+        Cleanup();
+    }, CLEANUP_INTERVAL);
 }
 
 void CChainLocksHandler::Stop()
 {
     quorumSigningManager->UnregisterRecoveredSigsListener(this);
+
+    // make sure to call InterruptWorkerThread() first
+    if (!workInterrupt) {
+        assert(false);
+    }
+
+    if (workThread.joinable()) {
+        workThread.join();
+    }
+}
+
+void CChainLocksHandler::InterruptWorkerThread()
+{
+    workInterrupt();
+    // take the mutex so that the worker can't miss the wake up between checking the interrupt and waiting
+    std::lock_guard<std::mutex> lock(workMutex);
+    workCond.notify_one();
+}
+
+void CChainLocksHandler::ScheduleWork()
+{
+    std::lock_guard<std::mutex> lock(workMutex);
+    workPending = true;
+    workCond.notify_one();
+}
+
+void CChainLocksHandler::WorkThreadMain()
+{
+    while (!workInterrupt) {
+        {
+            std::unique_lock<std::mutex> lock(workMutex);
+            workCond.wait_for(lock, std::chrono::milliseconds(WORK_INTERVAL), [&]() {
+                return workPending || (bool)workInterrupt;
+            });
+            workPending = false;
+        }
+        if (workInterrupt) {
+            return;
+        }
+
+        CheckActiveState();
+        EnforceBestChainLock();
+        // this also regularly retries signing the current chaintip as it might have failed before due to missing ixlocks
+        TrySignChainTip();
+    }
 }
 
 bool CChainLocksHandler::AlreadyHave(const CInv& inv)
@@ -152,12 +421,15 @@ void CChainLocksHandler::ProcessNewChainLock(NodeId from, const llmq::CChainLock
         const CBlockIndex* pindex = blockIt->second;
         bestChainLockWithKnownBlock = bestChainLock;
         bestChainLockBlockIndex = pindex;
+
+        CChainLocksTxTracker::TxIdsPtr txids;
+        int64_t nConnectedTimeMicros;
+        if (txTracker.GetBlock(clsig.blockHash, txids, nConnectedTimeMicros) && nConnectedTimeMicros != 0) {
+            chainLockLatency.Add(GetTimeMicros() - nConnectedTimeMicros);
+        }
     }
 
-    scheduler->scheduleFromNow([&]() {
-        CheckActiveState();
-        EnforceBestChainLock();
-    }, 0);
+    ScheduleWork();
 
     LogPrint("chainlocks", "CChainLocksHandler::%s -- processed new CLSIG (%s), peer=%d\n",
               __func__, clsig.ToString(), from);
@@ -187,37 +459,20 @@ void CChainLocksHandler::AcceptedBlockHeader(const CBlockIndex* pindexNew)
 
 void CChainLocksHandler::UpdatedBlockTip(const CBlockIndex* pindexNew)
 {
-    // don't call TrySignChainTip directly but instead let the scheduler call it. This way we ensure that cs_main is
+    // don't call TrySignChainTip directly but instead let the worker thread call it. This way we ensure that cs_main is
     // never locked and TrySignChainTip is not called twice in parallel. Also avoids recursive calls due to
     // EnforceBestChainLock switching chains.
-    LOCK(cs);
-    if (tryLockChainTipScheduled) {
-        return;
-    }
-    tryLockChainTipScheduled = true;
-    scheduler->scheduleFromNow([&]() {
-        CheckActiveState();
-        EnforceBestChainLock();
-        TrySignChainTip();
-        LOCK(cs);
-        tryLockChainTipScheduled = false;
-    }, 0);
+    ScheduleWork();
 }
 
 void CChainLocksHandler::CheckActiveState()
 {
-    bool fDIP0008Active;
-    {
-        LOCK(cs_main);
-        fDIP0008Active = VersionBitsState(chainActive.Tip()->pprev, Params().GetConsensus(), Consensus::DEPLOYMENT_DIP0008, versionbitscache) == THRESHOLD_ACTIVE;
-    }
-
     LOCK(cs);
     bool oldIsEnforced = isEnforced;
     isSporkActive = sporkManager.IsSporkActive(SPORK_19_CHAINLOCKS_ENABLED);
     // TODO remove this after DIP8 is active
     bool fEnforcedBySpork = (Params().NetworkIDString() == CBaseChainParams::TESTNET) && (sporkManager.GetSporkValue(SPORK_19_CHAINLOCKS_ENABLED) == 1);
-    isEnforced = (fDIP0008Active && isSporkActive) || fEnforcedBySpork;
+    isEnforced = (isDIP0008Active && isSporkActive) || fEnforcedBySpork;
 
     if (!oldIsEnforced && isEnforced) {
         // ChainLocks got activated just recently, but it's possible that it was already running before, leaving
@@ -231,8 +486,6 @@ void CChainLocksHandler::CheckActiveState()
 
 void CChainLocksHandler::TrySignChainTip()
 {
-    Cleanup();
-
     if (!fMasternodeMode) {
         return;
     }
@@ -241,24 +494,20 @@ void CChainLocksHandler::TrySignChainTip()
         return;
     }
 
-    const CBlockIndex* pindex;
-    {
-        LOCK(cs_main);
-        pindex = chainActive.Tip();
-    }
-
-    if (!pindex->pprev) {
-        return;
-    }
-
     // DIP8 defines a process called "Signing attempts" which should run before the CLSIG is finalized
     // To simplify the initial implementation, we skip this process and directly try to create a CLSIG
     // This will fail when multiple blocks compete, but we accept this for the initial implementation.
     // Later, we'll add the multiple attempts process.
 
+    const CBlockIndex* pindex;
     {
         LOCK(cs);
 
+        pindex = tipIndex;
+        if (!pindex || !pindex->pprev) {
+            return;
+        }
+
         if (!isSporkActive) {
             return;
         }
@@ -307,17 +556,28 @@ void CChainLocksHandler::TrySignChainTip()
                 continue;
             }
 
-            for (auto& txid : *txids) {
-                int64_t txAge = 0;
-                {
-                    LOCK(cs);
-                    auto it = txFirstSeenTime.find(txid);
-                    if (it != txFirstSeenTime.end()) {
-                        txAge = GetAdjustedTime() - it->second;
+            // only TXs which were not ixlocked yet and are not old enough need a closer look
+            std::vector<std::pair<uint256, int64_t>> txsToCheck;
+            {
+                LOCK(cs);
+                int64_t curTime = GetAdjustedTime();
+                for (auto& txid : *txids) {
+                    if (txTracker.IsTxSafe(txid, curTime)) {
+                        continue;
                     }
+                    // untracked TXs are treated as new while txTracker is incomplete
+                    int64_t txFirstSeenTime = curTime;
+                    bool txLocked;
+                    txTracker.GetTx(txid, txFirstSeenTime, txLocked);
+                    txsToCheck.emplace_back(txid, curTime - txFirstSeenTime);
                 }
+            }
 
-                if (txAge < WAIT_FOR_ISLOCK_TIMEOUT && !quorumInstantSendManager->IsLocked(txid)) {
+            for (auto& p : txsToCheck) {
+                auto& txid = p.first;
+                int64_t txAge = p.second;
+                // the ixlock might have arrived while the block was connected
+                if (!quorumInstantSendManager->IsLocked(txid)) {
                     LogPrint("chainlocks", "CChainLocksHandler::%s -- not signing block %s due to TX %s not being ixlocked and not old enough. age=%d\n", __func__,
                               pindexWalk->GetBlockHash().ToString(), txid.ToString(), txAge);
                     return;
@@ -352,6 +612,15 @@ void CChainLocksHandler::SyncTransaction(const CTransaction& tx, const CBlockInd
         handleTx = false;
     }
 
+    if (pindex) {
+        // TXs of connected blocks are passed in with the connected block and TXs of disconnected blocks are passed in
+        // with the new tip. Keep our own view of the tip up to date in both cases
+        LOCK(cs);
+        if (tipIndex != pindex && (posInBlock != CMainSignals::SYNC_TRANSACTION_NOT_IN_BLOCK || (tipIndex && tipIndex->pprev == pindex))) {
+            UpdateTip(pindex);
+        }
+    }
+
     if (!masternodeSync.IsBlockchainSynced()) {
         if (handleTx && posInBlock == CMainSignals::SYNC_TRANSACTION_NOT_IN_BLOCK) {
             auto info = mempool.info(tx.GetHash());
@@ -359,79 +628,115 @@ void CChainLocksHandler::SyncTransaction(const CTransaction& tx, const CBlockInd
                 return;
             }
             LOCK(cs);
-            txFirstSeenTime.emplace(tx.GetHash(), info.nTime);
+            txTracker.AddTx(tx.GetHash(), std::min(info.nTime, GetAdjustedTime()));
         }
+        LOCK(cs);
+        txTrackingStartTime = 0;
         return;
     }
 
+    // don't call into the InstantSend manager while holding cs
+    bool isLocked = handleTx && pindex && posInBlock != CMainSignals::SYNC_TRANSACTION_NOT_IN_BLOCK && quorumInstantSendManager->IsLocked(tx.GetHash());
+
     LOCK(cs);
 
+    int64_t curTime = GetAdjustedTime();
     if (handleTx) {
-        int64_t curTime = GetAdjustedTime();
-        txFirstSeenTime.emplace(tx.GetHash(), curTime);
+        txTracker.AddTx(tx.GetHash(), curTime);
+        if (isLocked) {
+            txTracker.SetTxLocked(tx.GetHash());
+        }
     }
 
     // We listen for SyncTransaction so that we can collect all TX ids of all included TXs of newly received blocks
     // We need this information later when we try to sign a new tip, so that we can determine if all included TXs are
     // safe.
     if (pindex && posInBlock != CMainSignals::SYNC_TRANSACTION_NOT_IN_BLOCK) {
-        auto it = blockTxs.find(pindex->GetBlockHash());
-        if (it == blockTxs.end()) {
-            // we want this to be run even if handleTx == false, so that the coinbase TX triggers creation of an empty entry
-            it = blockTxs.emplace(pindex->GetBlockHash(), std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>()).first;
+        if (txTrackingStartTime == 0) {
+            txTrackingStartTime = curTime;
         }
+        // we want this to be run even if handleTx == false, so that the coinbase TX triggers creation of an empty entry
+        txTracker.AddBlock(pindex->GetBlockHash(), curTime, GetTimeMicros());
         if (handleTx) {
-            auto& txs = *it->second;
-            txs.emplace(tx.GetHash());
+            txTracker.AddBlockTx(pindex->GetBlockHash(), tx.GetHash());
         }
     }
 }
 
-CChainLocksHandler::BlockTxs::mapped_type CChainLocksHandler::GetBlockTxs(const uint256& blockHash)
+void CChainLocksHandler::UpdateTip(const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs);
+
+    tipIndex = pindex;
+    isDIP0008Active = VersionBitsState(pindex->pprev, Params().GetConsensus(), Consensus::DEPLOYMENT_DIP0008, versionbitscache) == THRESHOLD_ACTIVE;
+}
+
+void CChainLocksHandler::NotifyTransactionLock(const CTransaction& tx)
+{
+    // legacy InstantSend locks are notified as well, but only LLMQ based ixlocks make TXs safe
+    if (!quorumInstantSendManager->IsLocked(tx.GetHash())) {
+        return;
+    }
+
+    LOCK(cs);
+    txTracker.SetTxLocked(tx.GetHash());
+}
+
+CChainLocksTxTracker::TxIdsPtr CChainLocksHandler::GetBlockTxs(const uint256& blockHash)
 {
     AssertLockNotHeld(cs);
     AssertLockNotHeld(cs_main);
 
-    CChainLocksHandler::BlockTxs::mapped_type ret;
+    CChainLocksTxTracker::TxIdsPtr ret;
 
     {
         LOCK(cs);
-        auto it = blockTxs.find(blockHash);
-        if (it != blockTxs.end()) {
-            ret = it->second;
+        int64_t nConnectedTimeMicros;
+        if (txTracker.GetBlock(blockHash, ret, nConnectedTimeMicros)) {
+            return ret;
+        }
+        int64_t curTime = GetAdjustedTime();
+        if (txTrackingStartTime != 0 && curTime - txTrackingStartTime >= WAIT_FOR_ISLOCK_TIMEOUT && txTracker.IsComplete(curTime)) {
+            // Every block connected within the window is tracked by now, so this one is old enough
+            return nullptr;
         }
     }
-    if (!ret) {
-        // This should only happen when freshly started.
-        // If running for some time, SyncTransaction should have been called before which fills blockTxs.
-        LogPrint("chainlocks", "CChainLocksHandler::%s -- blockTxs for %s not found. Trying ReadBlockFromDisk\n", __func__,
-                 blockHash.ToString());
 
-        uint32_t blockTime;
-        {
-            LOCK(cs_main);
-            auto pindex = mapBlockIndex.at(blockHash);
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-                return nullptr;
-            }
-
-            ret = std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>();
-            for (auto& tx : block.vtx) {
-                if (tx->IsCoinBase() || tx->vin.empty()) {
-                    continue;
-                }
-                ret->emplace(tx->GetHash());
-            }
+    // This should only happen when freshly started.
+    // If running for some time, SyncTransaction should have been called before which fills txTracker.
+    LogPrint("chainlocks", "CChainLocksHandler::%s -- TXs of block %s not tracked. Trying ReadBlockFromDisk\n", __func__,
+             blockHash.ToString());
 
-            blockTime = block.nTime;
+    uint32_t blockTime;
+    {
+        LOCK(cs_main);
+        auto pindex = mapBlockIndex.at(blockHash);
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            return nullptr;
         }
 
-        LOCK(cs);
-        blockTxs.emplace(blockHash, ret);
-        for (auto& txid : *ret) {
-            txFirstSeenTime.emplace(txid, blockTime);
+        ret = std::make_shared<std::unordered_set<uint256, StaticSaltedHasher>>();
+        for (auto& tx : block.vtx) {
+            if (tx->IsCoinBase() || tx->vin.empty()) {
+                continue;
+            }
+            ret->emplace(tx->GetHash());
         }
+
+        blockTime = block.nTime;
+    }
+
+    LOCK(cs);
+    int64_t curTime = GetAdjustedTime();
+    txTracker.AddBlock(blockHash, curTime, 0);
+    for (auto& txid : *ret) {
+        txTracker.AddBlockTx(blockHash, txid);
+        // TXs older than the window are not tracked at all. We don't know if the others were ixlocked, let
+        // TrySignChainTip ask the InstantSend manager. Block times can be in the future, which must not expire the
+        // whole window at once
+        txTracker.AddTx(txid, std::min<int64_t>(blockTime, curTime));
     }
     return ret;
 }
@@ -445,24 +750,36 @@ bool CChainLocksHandler::IsTxSafeForMining(const uint256& txid)
         return true;
     }
 
-    int64_t txAge = 0;
     {
         LOCK(cs);
         if (!isSporkActive) {
             return true;
         }
-        auto it = txFirstSeenTime.find(txid);
-        if (it != txFirstSeenTime.end()) {
-            txAge = GetAdjustedTime() - it->second;
+        if (txTracker.IsTxSafe(txid, GetAdjustedTime())) {
+            return true;
         }
     }
 
-    if (txAge < WAIT_FOR_ISLOCK_TIMEOUT && !quorumInstantSendManager->IsLocked(txid)) {
+    if (!quorumInstantSendManager->IsLocked(txid)) {
         return false;
     }
     return true;
 }
 
+void CChainLocksHandler::GetChainLockLatency(UniValue& obj)
+{
+    chainLockLatency.ToJson(obj);
+}
+
+void CChainLocksHandler::GetTxTrackerStats(size_t& nTxsRet, size_t& nBlocksRet, size_t& nUsageRet, uint64_t& nEvictedRet)
+{
+    LOCK(cs);
+    nTxsRet = txTracker.GetTxCount();
+    nBlocksRet = txTracker.GetBlockCount();
+    nUsageRet = txTracker.GetMemoryUsage();
+    nEvictedRet = txTracker.GetEvictedBucketCount();
+}
+
 // WARNING: cs_main and cs should not be held!
 // This should also not be called from validation signals, as this might result in recursive calls
 void CChainLocksHandler::EnforceBestChainLock()
@@ -484,6 +801,13 @@ void CChainLocksHandler::EnforceBestChainLock()
             // we don't have the header/block, so we can't do anything right now
             return;
         }
+
+        if (tipIndex && tipIndex->GetAncestor(currentBestChainLockBlockIndex->nHeight) == currentBestChainLockBlockIndex &&
+            lastNotifyChainLockBlockIndex == currentBestChainLockBlockIndex) {
+            // the active chain already contains the ChainLocked block and listeners know about it, so there is
+            // nothing to invalidate, activate or notify
+            return;
+        }
     }
 
     bool activateNeeded;
@@ -525,7 +849,7 @@ void CChainLocksHandler::EnforceBestChainLock()
 
     const CBlockIndex* pindexNotify = nullptr;
     {
-        LOCK(cs_main);
+        LOCK2(cs_main, cs);
         if (lastNotifyChainLockBlockIndex != currentBestChainLockBlockIndex &&
             chainActive.Tip()->GetAncestor(currentBestChainLockBlockIndex->nHeight) == currentBestChainLockBlockIndex) {
             lastNotifyChainLockBlockIndex = currentBestChainLockBlockIndex;
@@ -658,16 +982,10 @@ void CChainLocksHandler::Cleanup()
         return;
     }
 
-    {
-        LOCK(cs);
-        if (GetTimeMillis() - lastCleanupTime < CLEANUP_INTERVAL) {
-            return;
-        }
-    }
-
-    // need mempool.cs due to GetTransaction calls
-    LOCK2(cs_main, mempool.cs);
     LOCK(cs);
+    if (GetTimeMillis() - lastCleanupTime < CLEANUP_INTERVAL) {
+        return;
+    }
 
     for (auto it = seenChainLocks.begin(); it != seenChainLocks.end(); ) {
         if (GetTimeMillis() - it->second >= CLEANUP_SEEN_TIMEOUT) {
@@ -677,37 +995,8 @@ void CChainLocksHandler::Cleanup()
         }
     }
 
-    for (auto it = blockTxs.begin(); it != blockTxs.end(); ) {
-        auto pindex = mapBlockIndex.at(it->first);
-        if (InternalHasChainLock(pindex->nHeight, pindex->GetBlockHash())) {
-            for (auto& txid : *it->second) {
-                txFirstSeenTime.erase(txid);
-            }
-            it = blockTxs.erase(it);
-        } else if (InternalHasConflictingChainLock(pindex->nHeight, pindex->GetBlockHash())) {
-            it = blockTxs.erase(it);
-        } else {
-            ++it;
-        }
-    }
-    for (auto it = txFirstSeenTime.begin(); it != txFirstSeenTime.end(); ) {
-        CTransactionRef tx;
-        uint256 hashBlock;
-        if (!GetTransaction(it->first, tx, Params().GetConsensus(), hashBlock)) {
-            // tx has vanished, probably due to conflicts
-            it = txFirstSeenTime.erase(it);
-        } else if (!hashBlock.IsNull()) {
-            auto pindex = mapBlockIndex.at(hashBlock);
-            if (chainActive.Tip()->GetAncestor(pindex->nHeight) == pindex && chainActive.Height() - pindex->nHeight >= 6) {
-                // tx got confirmed >= 6 times, so we can stop keeping track of it
-                it = txFirstSeenTime.erase(it);
-            } else {
-                ++it;
-            }
-        } else {
-            ++it;
-        }
-    }
+    // TXs and blocks which are older than WAIT_FOR_ISLOCK_TIMEOUT don't need to be tracked anymore
+    txTracker.Expire(GetAdjustedTime());
 
     lastCleanupTime = GetTimeMillis();
 }
@@ -10,8 +10,14 @@
 
 #include "net.h"
 #include "chainparams.h"
+#include "latencyhistogram.h"
+#include "threadinterrupt.h"
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 class CBlockIndex;
@@ -41,6 +47,87 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * Keeps track of when TXs were first seen and which TXs are included in recently connected blocks, for as long as TXs
+ * still need an ixlock to be considered safe. Entries are grouped into a ring of time buckets and expire bucket by
+ * bucket, which costs only as much as the number of expired entries.
+ * The number of tracked TXs is capped. If the cap is reached, the oldest buckets are dropped early and new entries are
+ * rejected once only the current bucket is left. Untracked TXs and blocks are only old enough if nothing was dropped or
+ * rejected within the window, see IsComplete().
+ * Not thread-safe, needs to be protected by the owner.
+ */
+class CChainLocksTxTracker
+{
+public:
+    static const int64_t BUCKET_SECONDS = 60;
+
+    typedef std::shared_ptr<std::unordered_set<uint256, StaticSaltedHasher>> TxIdsPtr;
+
+private:
+    struct TxEntry {
+        int64_t nFirstSeenTime;
+        bool fLocked;
+    };
+    struct BlockEntry {
+        int64_t nTime;
+        int64_t nConnectedTimeMicros;
+        TxIdsPtr txids;
+    };
+    struct Bucket {
+        int64_t nSlot{-1};
+        std::vector<uint256> txids;
+        std::vector<uint256> blockHashes;
+    };
+
+    const int64_t nWindow;
+    const size_t nMaxEntries;
+
+    std::vector<Bucket> buckets;
+    // newest time passed in so far
+    int64_t nLastTime{0};
+    // entries seen before this time might have been dropped or rejected
+    int64_t nIncompleteUntil{0};
+
+    std::unordered_map<uint256, TxEntry, StaticSaltedHasher> txs;
+    std::unordered_map<uint256, BlockEntry, StaticSaltedHasher> blocks;
+    // tracked TXs plus TXs of tracked blocks
+    size_t nEntries{0};
+    uint64_t nEvictedBuckets{0};
+
+public:
+    CChainLocksTxTracker(int64_t nWindow, size_t nMaxEntriesIn);
+
+    // Does nothing if the TX is tracked already or too old to be tracked
+    bool AddTx(const uint256& txid, int64_t nFirstSeenTime);
+    void SetTxLocked(const uint256& txid);
+    // Returns false if the TX is not tracked
+    bool GetTx(const uint256& txid, int64_t& nFirstSeenTimeRet, bool& fLockedRet) const;
+    // Is the TX ixlocked or known since longer than the window? Untracked TXs are only safe if IsComplete(nTime)
+    bool IsTxSafe(const uint256& txid, int64_t nTime) const;
+
+    // nConnectedTimeMicros is 0 for blocks which were not connected while we were running
+    bool AddBlock(const uint256& blockHash, int64_t nTime, int64_t nConnectedTimeMicros);
+    bool AddBlockTx(const uint256& blockHash, const uint256& txid);
+    bool GetBlock(const uint256& blockHash, TxIdsPtr& txidsRet, int64_t& nConnectedTimeMicrosRet) const;
+
+    // Drops all entries which are older than the tracked time window
+    void Expire(int64_t nTime);
+    // Returns false if entries of the last nWindow seconds were dropped or rejected because of the cap
+    bool IsComplete(int64_t nTime) const;
+
+    size_t GetTxCount() const { return txs.size(); }
+    size_t GetBlockCount() const { return blocks.size(); }
+    uint64_t GetEvictedBucketCount() const { return nEvictedBuckets; }
+    size_t GetMemoryUsage() const;
+
+private:
+    bool IsExpired(int64_t nSlot) const;
+    Bucket* GetBucket(int64_t nTime);
+    void ClearBucket(Bucket& bucket);
+    bool MakeRoom(size_t nCount);
+    void SetIncompleteUntil(int64_t nSlot);
+};
+
 class CChainLocksHandler : public CRecoveredSigsListener
 {
     static const int64_t CLEANUP_INTERVAL = 1000 * 30;
@@ -49,10 +136,23 @@ class CChainLocksHandler : public CRecoveredSigsListener
     // how long to wait for ixlocks until we consider a block with non-ixlocked TXs to be safe to sign
     static const int64_t WAIT_FOR_ISLOCK_TIMEOUT = 10 * 60;
 
+    // ~100 bytes per TX, so this caps txTracker at ~20MB
+    static const size_t MAX_TRACKED_TXS = 200000;
+
+    static const int64_t WORK_INTERVAL = 5000;
+
 private:
     CScheduler* scheduler;
     CCriticalSection cs;
-    bool tryLockChainTipScheduled{false};
+
+    // CheckActiveState, EnforceBestChainLock and TrySignChainTip run on a dedicated thread, which is woken up when a new
+    // tip or CLSIG arrives and otherwise retries every WORK_INTERVAL ms
+    std::thread workThread;
+    CThreadInterrupt workInterrupt;
+    std::mutex workMutex;
+    std::condition_variable workCond;
+    bool workPending{false};
+
     bool isSporkActive{false};
     bool isEnforced{false};
 
@@ -67,10 +167,16 @@ private:
     uint256 lastSignedRequestId;
     uint256 lastSignedMsgHash;
 
+    // Our own view of the chain tip, updated from SyncTransaction (cs_main is held by the caller there). This way
+    // signing and enforcing ChainLocks doesn't need cs_main
+    const CBlockIndex* tipIndex{nullptr};
+    bool isDIP0008Active{false};
+
     // We keep track of txids from recently received blocks so that we can check if all TXs got ixlocked
-    typedef std::unordered_map<uint256, std::shared_ptr<std::unordered_set<uint256, StaticSaltedHasher>>> BlockTxs;
-    BlockTxs blockTxs;
-    std::unordered_map<uint256, int64_t> txFirstSeenTime;
+    CChainLocksTxTracker txTracker;
+    // Blocks connected since then are in txTracker (until they expire), 0 while not synced
+    int64_t txTrackingStartTime{0};
+    CLatencyHistogram chainLockLatency;
 
     std::map<uint256, int64_t> seenChainLocks;
 
@@ -82,6 +188,7 @@ public:
 
     void Start();
     void Stop();
+    void InterruptWorkerThread();
 
     bool AlreadyHave(const CInv& inv);
     bool GetChainLockByHash(const uint256& hash, CChainLockSig& ret);
@@ -91,6 +198,7 @@ public:
     void AcceptedBlockHeader(const CBlockIndex* pindexNew);
     void UpdatedBlockTip(const CBlockIndex* pindexNew);
     void SyncTransaction(const CTransaction &tx, const CBlockIndex *pindex, int posInBlock);
+    void NotifyTransactionLock(const CTransaction& tx);
     void CheckActiveState();
     void TrySignChainTip();
     void EnforceBestChainLock();
@@ -101,6 +209,10 @@ public:
 
     bool IsTxSafeForMining(const uint256& txid);
 
+    // Time from connecting a block until its ChainLock was received or recovered
+    void GetChainLockLatency(UniValue& obj);
+    void GetTxTrackerStats(size_t& nTxsRet, size_t& nBlocksRet, size_t& nUsageRet, uint64_t& nEvictedRet);
+
 private:
     // these require locks to be held already
     bool InternalHasChainLock(int nHeight, const uint256& blockHash);
@@ -108,7 +220,13 @@ private:
 
     void DoInvalidateBlock(const CBlockIndex* pindex, bool activateBestChain);
 
-    BlockTxs::mapped_type GetBlockTxs(const uint256& blockHash);
+    // requires cs_main and cs
+    void UpdateTip(const CBlockIndex* pindex);
+
+    CChainLocksTxTracker::TxIdsPtr GetBlockTxs(const uint256& blockHash);
+
+    void ScheduleWork();
+    void WorkThreadMain();
 
     void Cleanup();
 };
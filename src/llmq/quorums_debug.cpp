@@ -101,6 +101,16 @@ UniValue CDKGDebugSessionStatus::ToJson(int detailLevel) const
     push(receivedJustifications, "receivedJustifications");
     push(receivedPrematureCommitments, "receivedPrematureCommitments");
 
+    UniValue phaseTimesArr(UniValue::VARR);
+    for (const auto& p : phaseTimes) {
+        UniValue t(UniValue::VOBJ);
+        t.push_back(Pair("phase", (int)p.first));
+        t.push_back(Pair("actionTime", p.second.first));
+        t.push_back(Pair("messagesTime", p.second.second));
+        phaseTimesArr.push_back(t);
+    }
+    ret.push_back(Pair("phaseTimes", phaseTimesArr));
+
     if (detailLevel == 2) {
         UniValue arr(UniValue::VARR);
         for (const auto& dmn : dmnMembers) {
@@ -174,6 +184,7 @@ void CDKGDebugManager::InitLocalSessionStatus(Consensus::LLMQType llmqType, cons
     session.statusBitset = 0;
     session.members.clear();
     session.members.resize((size_t)params.size);
+    session.phaseTimes.clear();
 }
 
 void CDKGDebugManager::UpdateLocalStatus(std::function<bool(CDKGDebugStatus& status)>&& func)
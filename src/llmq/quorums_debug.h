@@ -9,6 +9,7 @@
 #include "sync.h"
 #include "univalue.h"
 
+#include <map>
 #include <set>
 
 class CDataStream;
@@ -68,6 +69,10 @@ public:
 
     std::vector<CDKGDebugMemberStatus> members;
 
+    // per phase: time in ms spent in the local phase action (e.g. VerifyAndComplain) and in processing of the
+    // incoming messages of the phase
+    std::map<uint8_t, std::pair<int64_t, int64_t>> phaseTimes;
+
 public:
     CDKGDebugSessionStatus() : statusBitset(0) {}
 
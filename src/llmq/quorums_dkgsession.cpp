@@ -25,6 +25,9 @@
 namespace llmq
 {
 
+// number of received contributions that are verified together in the background
+static const size_t CONTRIBUTION_VERIFICATION_BATCH_SIZE = 32;
+
 // Supported error types:
 // - contribution-omit
 // - contribution-lie
@@ -88,6 +91,14 @@ CDKGMember::CDKGMember(CDeterministicMNCPtr _dmn, size_t _idx) :
 
 }
 
+CDKGSession::~CDKGSession()
+{
+    // background verifications reference the vvecs and contributions owned by this session
+    for (auto& v : contributionVerifications) {
+        v.result.wait();
+    }
+}
+
 bool CDKGSession::Init(const CBlockIndex* _pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash)
 {
     if (mns.size() < params.minSize) {
@@ -338,15 +349,14 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
 
     logger.Batch("decrypted our contribution share. time=%d", t2.count());
 
-    bool verifyPending = false;
     receivedSkContributions[member->idx] = skContribution;
     pendingContributionVerifications.emplace_back(member->idx);
-    if (pendingContributionVerifications.size() >= 32) {
-        verifyPending = true;
-    }
-
-    if (verifyPending) {
-        VerifyPendingContributions();
+    if (pendingContributionVerifications.size() >= CONTRIBUTION_VERIFICATION_BATCH_SIZE) {
+        // start verification in the background while more contributions arrive, so that not all the work is left
+        // for the phase boundary
+        VerifyPendingContributions(false);
+    } else {
+        CollectContributionVerifications(false);
     }
 }
 
@@ -355,53 +365,72 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
 // The resulting aggregated vvec is then used to recover a public key share
 // The public key share must match the public key belonging to the aggregated secret key contributions
 // See CBLSWorker::VerifyContributionShares for more details.
-void CDKGSession::VerifyPendingContributions()
+// Verification is performed by the BLS worker pool. If wait is false, this does not block and results are
+// collected later.
+void CDKGSession::VerifyPendingContributions(bool wait)
 {
-    CDKGLogger logger(*this, __func__);
-
-    cxxtimer::Timer t1(true);
-
     std::vector<size_t> pend = std::move(pendingContributionVerifications);
-    if (pend.empty()) {
-        return;
-    }
-
-    std::vector<size_t> memberIndexes;
-    std::vector<BLSVerificationVectorPtr> vvecs;
-    BLSSecretKeyVector skContributions;
+    pendingContributionVerifications.clear();
 
+    ContributionVerification v;
     for (const auto& idx : pend) {
         auto& m = members[idx];
         if (m->bad || m->weComplain) {
             continue;
         }
-        memberIndexes.emplace_back(idx);
-        vvecs.emplace_back(receivedVvecs[idx]);
-        skContributions.emplace_back(receivedSkContributions[idx]);
+        v.memberIndexes.emplace_back(idx);
+        v.vvecs.emplace_back(receivedVvecs[idx]);
+        v.skContributions.emplace_back(receivedSkContributions[idx]);
     }
 
-    auto result = blsWorker.VerifyContributionShares(myId, vvecs, skContributions);
-    if (result.size() != memberIndexes.size()) {
-        logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+    if (!v.memberIndexes.empty()) {
+        contributionVerifications.emplace_back(std::move(v));
+        auto& v2 = contributionVerifications.back();
+        v2.nStartTime = GetTimeMillis();
+        v2.result = blsWorker.AsyncVerifyContributionShares(myId, v2.vvecs, v2.skContributions, true, true);
+    }
+
+    CollectContributionVerifications(wait);
+}
+
+void CDKGSession::CollectContributionVerifications(bool wait)
+{
+    if (contributionVerifications.empty()) {
         return;
     }
 
-    for (size_t i = 0; i < memberIndexes.size(); i++) {
-        if (!result[i]) {
-            auto& m = members[memberIndexes[i]];
-            logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
-            m->weComplain = true;
-            quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
-                status.weComplain = true;
-                return true;
-            });
-        } else {
-            size_t memberIdx = memberIndexes[i];
-            dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, skContributions[i]);
+    CDKGLogger logger(*this, __func__);
+
+    while (!contributionVerifications.empty()) {
+        auto& v = contributionVerifications.front();
+        if (!wait && v.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            break;
         }
-    }
 
-    logger.Batch("verified %d pending contributions. time=%d", pend.size(), t1.count());
+        auto result = v.result.get();
+        if (result.size() != v.memberIndexes.size()) {
+            logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), v.memberIndexes.size());
+            contributionVerifications.pop_front();
+            continue;
+        }
+
+        for (size_t i = 0; i < v.memberIndexes.size(); i++) {
+            auto& m = members[v.memberIndexes[i]];
+            if (!result[i]) {
+                logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
+                m->weComplain = true;
+                quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
+                    status.weComplain = true;
+                    return true;
+                });
+            } else {
+                dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, m->dmn->proTxHash, v.skContributions[i]);
+            }
+        }
+
+        logger.Batch("verified %d pending contributions. time=%d", v.memberIndexes.size(), GetTimeMillis() - v.nStartTime);
+        contributionVerifications.pop_front();
+    }
 }
 
 void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
@@ -410,7 +439,7 @@ void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
         return;
     }
 
-    VerifyPendingContributions();
+    VerifyPendingContributions(true);
 
     CDKGLogger logger(*this, __func__);
 
@@ -929,20 +958,23 @@ void CDKGSession::SendCommitment(CDKGPendingMessages& pendingMessages)
         return;
     }
 
+    // aggregate our secret key share on the worker pool while the quorum vvec is being built
+    auto skShareFuture = blsWorker.AsyncAggregateSecretKeys(skContributions, 0, skContributions.size(), true);
     BLSVerificationVectorPtr vvec = cache.BuildQuorumVerificationVector(::SerializeHash(memberIndexes), vvecs);
+    t1.stop();
+
+    cxxtimer::Timer t2(true);
+    CBLSSecretKey skShare = skShareFuture.get();
+    t2.stop();
+
     if (vvec == nullptr) {
         logger.Batch("failed to build quorum verification vector");
         return;
     }
-    t1.stop();
-
-    cxxtimer::Timer t2(true);
-    CBLSSecretKey skShare = cache.AggregateSecretKeys(::SerializeHash(memberIndexes), skContributions);
     if (!skShare.IsValid()) {
         logger.Batch("failed to build own secret share");
         return;
     }
-    t2.stop();
 
     logger.Batch("pubKeyShare=%s", skShare.GetPublicKey().ToString());
 
@@ -1224,16 +1256,23 @@ std::vector<CFinalCommitment> CDKGSession::FinalizeCommitments()
             thresholdSigs.emplace_back(qc.quorumSig);
         }
 
+        // both are expensive for large quorums and independent of each other
         cxxtimer::Timer t1(true);
-        fqc.membersSig = CBLSSignature::AggregateSecure(aggSigs, aggPks, commitmentHash);
-        t1.stop();
+        auto membersSigFuture = blsWorker.AsyncExec([&]() {
+            fqc.membersSig = CBLSSignature::AggregateSecure(aggSigs, aggPks, commitmentHash);
+        });
 
         cxxtimer::Timer t2(true);
-        if (!fqc.quorumSig.Recover(thresholdSigs, signerIds)) {
+        bool recovered = fqc.quorumSig.Recover(thresholdSigs, signerIds);
+        t2.stop();
+
+        membersSigFuture.get();
+        t1.stop();
+
+        if (!recovered) {
             logger.Batch("failed to recover quorum sig");
             continue;
         }
-        t2.stop();
 
         finalCommitments.emplace_back(fqc);
 
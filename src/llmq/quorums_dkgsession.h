@@ -16,6 +16,9 @@
 
 #include "llmq/quorums_utils.h"
 
+#include <future>
+#include <list>
+
 class UniValue;
 
 namespace llmq
@@ -279,12 +282,24 @@ private:
 
     std::vector<size_t> pendingContributionVerifications;
 
+    // Batches of contribution shares which are being verified in the background while more contributions arrive.
+    // Results are collected in order by the phase handler thread (see CollectContributionVerifications)
+    struct ContributionVerification {
+        std::vector<size_t> memberIndexes;
+        std::vector<BLSVerificationVectorPtr> vvecs;
+        BLSSecretKeyVector skContributions;
+        std::future<std::vector<bool>> result;
+        int64_t nStartTime;
+    };
+    std::list<ContributionVerification> contributionVerifications;
+
     // filled by ReceivePrematureCommitment and used by FinalizeCommitments
     std::set<uint256> validCommitments;
 
 public:
     CDKGSession(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker, CDKGSessionManager& _dkgManager) :
         params(_params), blsWorker(_blsWorker), cache(_blsWorker), dkgManager(_dkgManager) {}
+    ~CDKGSession();
 
     bool Init(const CBlockIndex* pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash);
 
@@ -308,7 +323,8 @@ public:
     void SendContributions(CDKGPendingMessages& pendingMessages);
     bool PreVerifyMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan) const;
     void ReceiveMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan);
-    void VerifyPendingContributions();
+    void VerifyPendingContributions(bool wait);
+    void CollectContributionVerifications(bool wait);
 
     // Phase 2: complaint
     void VerifyAndComplain(CDKGPendingMessages& pendingMessages);
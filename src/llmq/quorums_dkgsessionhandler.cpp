@@ -101,6 +101,11 @@ CDKGSessionHandler::CDKGSessionHandler(const Consensus::LLMQParams& _params, ctp
 }
 
 CDKGSessionHandler::~CDKGSessionHandler()
+{
+    StopThread();
+}
+
+void CDKGSessionHandler::StopThread()
 {
     stopRequested = true;
     if (phaseHandlerThread.joinable()) {
@@ -259,9 +264,33 @@ void CDKGSessionHandler::HandlePhase(QuorumPhase curPhase,
                                      const StartPhaseFunc& startPhaseFunc,
                                      const WhileWaitFunc& runWhileWaiting)
 {
-    SleepBeforePhase(curPhase, expectedQuorumHash, randomSleepFactor, runWhileWaiting);
+    // measure how much CPU time the phase needs, so that we can see how close we get to the phase deadlines
+    int64_t nMessagesTime = 0;
+    auto timedRunWhileWaiting = [&]() {
+        int64_t nStart = GetTimeMicros();
+        bool ret = runWhileWaiting();
+        nMessagesTime += GetTimeMicros() - nStart;
+        return ret;
+    };
+
+    SleepBeforePhase(curPhase, expectedQuorumHash, randomSleepFactor, timedRunWhileWaiting);
+    int64_t nActionStart = GetTimeMicros();
     startPhaseFunc();
-    WaitForNextPhase(curPhase, nextPhase, expectedQuorumHash, runWhileWaiting);
+    int64_t nActionTime = GetTimeMicros() - nActionStart;
+    WaitForNextPhase(curPhase, nextPhase, expectedQuorumHash, timedRunWhileWaiting);
+
+    RecordPhaseTimes(curPhase, nActionTime, nMessagesTime);
+}
+
+void CDKGSessionHandler::RecordPhaseTimes(QuorumPhase phase, int64_t nActionTime, int64_t nMessagesTime)
+{
+    LogPrint("llmq-dkg", "CDKGSessionHandler::%s -- llmq=%s, phase=%d, actionTime=%dms, messagesTime=%dms\n", __func__,
+             params.name, (int)phase, nActionTime / 1000, nMessagesTime / 1000);
+
+    quorumDKGDebugManager->UpdateLocalSessionStatus(params.type, [&](CDKGDebugSessionStatus& status) {
+        status.phaseTimes[(uint8_t)phase] = std::make_pair(nActionTime / 1000, nMessagesTime / 1000);
+        return true;
+    });
 }
 
 // returns a set of NodeIds which sent invalid messages
@@ -537,7 +566,9 @@ void CDKGSessionHandler::HandleDKGRound()
     };
     HandlePhase(QuorumPhase_Commit, QuorumPhase_Finalize, curQuorumHash, 0.1, fCommitStart, fCommitWait);
 
+    int64_t nFinalizeStart = GetTimeMicros();
     auto finalCommitments = curSession->FinalizeCommitments();
+    RecordPhaseTimes(QuorumPhase_Finalize, GetTimeMicros() - nFinalizeStart, 0);
     for (const auto& fqc : finalCommitments) {
         quorumBlockProcessor->AddMinableCommitment(fqc);
     }
@@ -556,6 +587,9 @@ void CDKGSessionHandler::PhaseHandlerThread()
             LogPrint("llmq-dkg", "CDKGSessionHandler::%s -- aborted current DKG session for llmq=%s\n", __func__, params.name);
         }
     }
+
+    // Don't leave contribution verifications behind, they run on the BLS worker which is stopped after this thread
+    curSession->CollectContributionVerifications(true);
 }
 
 }
@@ -121,6 +121,9 @@ public:
     CDKGSessionHandler(const Consensus::LLMQParams& _params, ctpl::thread_pool& _messageHandlerPool, CBLSWorker& blsWorker, CDKGSessionManager& _dkgManager);
     ~CDKGSessionHandler();
 
+    /// Abort the current phase and join the phase handler thread. Must happen before the BLS worker is stopped
+    void StopThread();
+
     void UpdatedBlockTip(const CBlockIndex *pindexNew);
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
 
@@ -135,6 +138,7 @@ private:
     void WaitForNewQuorum(const uint256& oldQuorumHash);
     void SleepBeforePhase(QuorumPhase curPhase, const uint256& expectedQuorumHash, double randomSleepFactor, const WhileWaitFunc& runWhileWaiting);
     void HandlePhase(QuorumPhase curPhase, QuorumPhase nextPhase, const uint256& expectedQuorumHash, double randomSleepFactor, const StartPhaseFunc& startPhaseFunc, const WhileWaitFunc& runWhileWaiting);
+    void RecordPhaseTimes(QuorumPhase phase, int64_t nActionTime, int64_t nMessagesTime);
     void HandleDKGRound();
     void PhaseHandlerThread();
 };
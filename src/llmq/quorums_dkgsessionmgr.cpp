@@ -45,6 +45,10 @@ void CDKGSessionManager::StartMessageHandlerPool()
 
 void CDKGSessionManager::StopMessageHandlerPool()
 {
+    // the phase handlers wait for results of the BLS worker, so they must be done before it's stopped
+    for (auto& p : dkgSessionHandlers) {
+        p.second.StopThread();
+    }
     messageHandlerPool.stop(true);
 }
 
@@ -33,7 +33,7 @@ void InitLLMQSystem(CEvoDB& evoDb, CScheduler* scheduler, bool unitTests, bool f
     quorumBlockProcessor = new CQuorumBlockProcessor(evoDb);
     quorumDKGSessionManager = new CDKGSessionManager(*llmqDb, *blsWorker);
     quorumManager = new CQuorumManager(evoDb, *blsWorker, *quorumDKGSessionManager);
-    quorumSigSharesManager = new CSigSharesManager();
+    quorumSigSharesManager = new CSigSharesManager(*blsWorker);
     quorumSigningManager = new CSigningManager(*llmqDb, unitTests);
     chainLocksHandler = new CChainLocksHandler(scheduler);
     quorumInstantSendManager = new CInstantSendManager(*llmqDb);
@@ -110,6 +110,9 @@ void InterruptLLMQSystem()
     if (quorumSigSharesManager) {
         quorumSigSharesManager->InterruptWorkerThread();
     }
+    if (chainLocksHandler) {
+        chainLocksHandler->InterruptWorkerThread();
+    }
     if (quorumInstantSendManager) {
         quorumInstantSendManager->InterruptWorkerThread();
     }
@@ -3,12 +3,14 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "quorums_chainlocks.h"
+#include "quorums_init.h"
 #include "quorums_instantsend.h"
 #include "quorums_utils.h"
 
 #include "bls/bls_batchverifier.h"
 #include "chainparams.h"
 #include "coins.h"
+#include "memusage.h"
 #include "txmempool.h"
 #include "masternode-sync.h"
 #include "net_processing.h"
@@ -43,22 +45,131 @@ uint256 CInstantSendLock::GetRequestId() const
 
 ////////////////
 
+CInstantSendDb::CInstantSendDb(CDBWrapper& _db) :
+    db(_db)
+{
+    LoadIndex();
+}
+
+void CInstantSendDb::LoadIndex()
+{
+    int64_t nTime1 = GetTimeMicros();
+
+    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
+    auto firstKey = std::make_tuple(std::string("is_i"), uint256());
+
+    it->Seek(firstKey);
+
+    while (it->Valid()) {
+        decltype(firstKey) curKey;
+        if (!it->GetKey(curKey) || std::get<0>(curKey) != "is_i") {
+            break;
+        }
+
+        auto islock = std::make_shared<CInstantSendLock>();
+        if (!it->GetValue(*islock)) {
+            break;
+        }
+        AddToIndex(std::get<1>(curKey), islock);
+
+        it->Next();
+    }
+
+    int64_t nTime2 = GetTimeMicros();
+    LogPrintf("CInstantSendDb::%s -- loaded %d islocks, memory usage %d bytes, time %dms\n", __func__,
+              locksById.size(), GetIndexMemoryUsage(), (nTime2 - nTime1) / 1000);
+}
+
+void CInstantSendDb::AddToIndex(const uint256& hash, const CInstantSendLockPtr& islock)
+{
+    if (lockIdsByHash.count(hash)) {
+        return;
+    }
+
+    uint32_t id = nextLockId++;
+    locksById.emplace(id, IndexEntry{hash, islock});
+    lockIdsByHash.emplace(hash, id);
+    lockIdsByTxid[islock->txid] = id;
+    for (auto& in : islock->inputs) {
+        lockIdsByInput[in] = id;
+        lockIdsByParent.emplace(in.hash, id);
+    }
+}
+
+void CInstantSendDb::RemoveFromIndex(const uint256& hash)
+{
+    auto it = lockIdsByHash.find(hash);
+    if (it == lockIdsByHash.end()) {
+        return;
+    }
+    uint32_t id = it->second;
+    lockIdsByHash.erase(it);
+
+    auto it2 = locksById.find(id);
+    if (it2 == locksById.end()) {
+        return;
+    }
+    auto& islock = *it2->second.islock;
+
+    auto it3 = lockIdsByTxid.find(islock.txid);
+    if (it3 != lockIdsByTxid.end() && it3->second == id) {
+        lockIdsByTxid.erase(it3);
+    }
+    for (auto& in : islock.inputs) {
+        auto it4 = lockIdsByInput.find(in);
+        if (it4 != lockIdsByInput.end() && it4->second == id) {
+            lockIdsByInput.erase(it4);
+        }
+        auto range = lockIdsByParent.equal_range(in.hash);
+        for (auto it5 = range.first; it5 != range.second; ++it5) {
+            if (it5->second == id) {
+                lockIdsByParent.erase(it5);
+                break;
+            }
+        }
+    }
+
+    locksById.erase(it2);
+}
+
+CInstantSendLockPtr CInstantSendDb::GetInstantSendLockById(uint32_t id) const
+{
+    auto it = locksById.find(id);
+    if (it == locksById.end()) {
+        return nullptr;
+    }
+    return it->second.islock;
+}
+
+size_t CInstantSendDb::GetIndexMemoryUsage() const
+{
+    size_t usage = memusage::DynamicUsage(locksById) +
+                   memusage::DynamicUsage(lockIdsByHash) +
+                   memusage::DynamicUsage(lockIdsByTxid) +
+                   memusage::DynamicUsage(lockIdsByInput) +
+                   memusage::DynamicUsage(lockIdsByParent);
+    for (auto& p : locksById) {
+        usage += memusage::DynamicUsage(p.second.islock) + memusage::DynamicUsage(p.second.islock->inputs);
+    }
+    return usage;
+}
+
 void CInstantSendDb::WriteNewInstantSendLock(const uint256& hash, const CInstantSendLock& islock)
 {
     CDBBatch batch(db);
+    WriteNewInstantSendLock(batch, hash, islock);
+    db.WriteBatch(batch);
+}
+
+void CInstantSendDb::WriteNewInstantSendLock(CDBBatch& batch, const uint256& hash, const CInstantSendLock& islock)
+{
     batch.Write(std::make_tuple(std::string("is_i"), hash), islock);
     batch.Write(std::make_tuple(std::string("is_tx"), islock.txid), hash);
     for (auto& in : islock.inputs) {
         batch.Write(std::make_tuple(std::string("is_in"), in), hash);
     }
-    db.WriteBatch(batch);
 
-    auto p = std::make_shared<CInstantSendLock>(islock);
-    islockCache.insert(hash, p);
-    txidCache.insert(islock.txid, hash);
-    for (auto& in : islock.inputs) {
-        outpointCache.insert(in, hash);
-    }
+    AddToIndex(hash, std::make_shared<CInstantSendLock>(islock));
 }
 
 void CInstantSendDb::RemoveInstantSendLock(CDBBatch& batch, const uint256& hash, CInstantSendLockPtr islock)
@@ -76,11 +187,7 @@ void CInstantSendDb::RemoveInstantSendLock(CDBBatch& batch, const uint256& hash,
         batch.Erase(std::make_tuple(std::string("is_in"), in));
     }
 
-    islockCache.erase(hash);
-    txidCache.erase(islock->txid);
-    for (auto& in : islock->inputs) {
-        outpointCache.erase(in);
-    }
+    RemoveFromIndex(hash);
 }
 
 static std::tuple<std::string, uint32_t, uint256> BuildInversedISLockKey(const std::string& k, int nHeight, const uint256& islockHash)
@@ -93,6 +200,11 @@ void CInstantSendDb::WriteInstantSendLockMined(const uint256& hash, int nHeight)
     db.Write(BuildInversedISLockKey("is_m", nHeight, hash), true);
 }
 
+void CInstantSendDb::WriteInstantSendLockMined(CDBBatch& batch, const uint256& hash, int nHeight)
+{
+    batch.Write(BuildInversedISLockKey("is_m", nHeight, hash), true);
+}
+
 void CInstantSendDb::RemoveInstantSendLockMined(const uint256& hash, int nHeight)
 {
     db.Erase(BuildInversedISLockKey("is_m", nHeight, hash));
@@ -180,116 +292,65 @@ bool CInstantSendDb::HasArchivedInstantSendLock(const uint256& islockHash)
 
 size_t CInstantSendDb::GetInstantSendLockCount()
 {
-    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
-    auto firstKey = std::make_tuple(std::string("is_i"), uint256());
-
-    it->Seek(firstKey);
-
-    size_t cnt = 0;
-    while (it->Valid()) {
-        decltype(firstKey) curKey;
-        if (!it->GetKey(curKey) || std::get<0>(curKey) != "is_i") {
-            break;
-        }
-
-        cnt++;
-
-        it->Next();
-    }
-
-    return cnt;
+    return locksById.size();
 }
 
 CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByHash(const uint256& hash)
 {
-    CInstantSendLockPtr ret;
-    if (islockCache.get(hash, ret)) {
-        return ret;
-    }
-
-    ret = std::make_shared<CInstantSendLock>();
-    bool exists = db.Read(std::make_tuple(std::string("is_i"), hash), *ret);
-    if (!exists) {
-        ret = nullptr;
+    auto it = lockIdsByHash.find(hash);
+    if (it == lockIdsByHash.end()) {
+        return nullptr;
     }
-    islockCache.insert(hash, ret);
-    return ret;
+    return GetInstantSendLockById(it->second);
 }
 
 uint256 CInstantSendDb::GetInstantSendLockHashByTxid(const uint256& txid)
 {
-    uint256 islockHash;
-
-    bool found = txidCache.get(txid, islockHash);
-    if (found && islockHash.IsNull()) {
+    auto it = lockIdsByTxid.find(txid);
+    if (it == lockIdsByTxid.end()) {
         return uint256();
     }
-
-    if (!found) {
-        found = db.Read(std::make_tuple(std::string("is_tx"), txid), islockHash);
-        txidCache.insert(txid, islockHash);
-    }
-
-    if (!found) {
+    auto it2 = locksById.find(it->second);
+    if (it2 == locksById.end()) {
         return uint256();
     }
-    return islockHash;
+    return it2->second.hash;
 }
 
 CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByTxid(const uint256& txid)
 {
-    uint256 islockHash = GetInstantSendLockHashByTxid(txid);
-    if (islockHash.IsNull()) {
+    auto it = lockIdsByTxid.find(txid);
+    if (it == lockIdsByTxid.end()) {
         return nullptr;
     }
-    return GetInstantSendLockByHash(islockHash);
+    return GetInstantSendLockById(it->second);
 }
 
 CInstantSendLockPtr CInstantSendDb::GetInstantSendLockByInput(const COutPoint& outpoint)
 {
-    uint256 islockHash;
-    bool found = outpointCache.get(outpoint, islockHash);
-    if (found && islockHash.IsNull()) {
-        return nullptr;
-    }
-
-    if (!found) {
-        found = db.Read(std::make_tuple(std::string("is_in"), outpoint), islockHash);
-        outpointCache.insert(outpoint, islockHash);
-    }
-
-    if (!found) {
+    auto it = lockIdsByInput.find(outpoint);
+    if (it == lockIdsByInput.end()) {
         return nullptr;
     }
-    return GetInstantSendLockByHash(islockHash);
+    return GetInstantSendLockById(it->second);
 }
 
 std::vector<uint256> CInstantSendDb::GetInstantSendLocksByParent(const uint256& parent)
 {
-    auto it = std::unique_ptr<CDBIterator>(db.NewIterator());
-    auto firstKey = std::make_tuple(std::string("is_in"), COutPoint(parent, 0));
-    it->Seek(firstKey);
-
     std::vector<uint256> result;
 
-    while (it->Valid()) {
-        decltype(firstKey) curKey;
-        if (!it->GetKey(curKey) || std::get<0>(curKey) != "is_in") {
-            break;
-        }
-        auto& outpoint = std::get<1>(curKey);
-        if (outpoint.hash != parent) {
-            break;
+    auto range = lockIdsByParent.equal_range(parent);
+    for (auto it = range.first; it != range.second; ++it) {
+        auto it2 = locksById.find(it->second);
+        if (it2 != locksById.end()) {
+            result.emplace_back(it2->second.hash);
         }
-
-        uint256 islockHash;
-        if (!it->GetValue(islockHash)) {
-            break;
-        }
-        result.emplace_back(islockHash);
-        it->Next();
     }
 
+    // an islock may spend multiple outputs of the same parent
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
     return result;
 }
 
@@ -714,6 +775,7 @@ void CInstantSendManager::ProcessMessageInstantSendLock(CNode* pfrom, const llmq
             islock.txid.ToString(), hash.ToString(), pfrom->id);
 
     pendingInstantSendLocks.emplace(hash, std::make_pair(pfrom->id, std::move(islock)));
+    pendingInstantSendLockTimes.emplace(hash, GetTimeMicros());
 }
 
 bool CInstantSendManager::PreVerifyInstantSendLock(NodeId nodeId, const llmq::CInstantSendLock& islock, bool& retBan)
@@ -739,10 +801,12 @@ bool CInstantSendManager::PreVerifyInstantSendLock(NodeId nodeId, const llmq::CI
 bool CInstantSendManager::ProcessPendingInstantSendLocks()
 {
     decltype(pendingInstantSendLocks) pend;
+    decltype(pendingInstantSendLockTimes) pendTimes;
 
     {
         LOCK(cs);
         pend = std::move(pendingInstantSendLocks);
+        pendTimes = std::move(pendingInstantSendLockTimes);
     }
 
     if (pend.empty()) {
@@ -771,7 +835,7 @@ bool CInstantSendManager::ProcessPendingInstantSendLocks()
 
     if (quorumsRotated) {
         // first check against the current active set and don't ban
-        auto badISLocks = ProcessPendingInstantSendLocks(tipHeight, pend, false);
+        auto badISLocks = ProcessPendingInstantSendLocks(tipHeight, pend, pendTimes, false);
         if (!badISLocks.empty()) {
             LogPrintf("CInstantSendManager::%s -- detected LLMQ active set rotation, redoing verification on old active set\n", __func__);
 
@@ -784,20 +848,24 @@ bool CInstantSendManager::ProcessPendingInstantSendLocks()
                 }
             }
             // now check against the previous active set and perform banning if this fails
-            ProcessPendingInstantSendLocks(tipHeight - 1, pend, true);
+            ProcessPendingInstantSendLocks(tipHeight - 1, pend, pendTimes, true);
         }
     } else {
-        ProcessPendingInstantSendLocks(tipHeight, pend, true);
+        ProcessPendingInstantSendLocks(tipHeight, pend, pendTimes, true);
     }
 
     return true;
 }
 
-std::unordered_set<uint256> CInstantSendManager::ProcessPendingInstantSendLocks(int signHeight, const std::unordered_map<uint256, std::pair<NodeId, CInstantSendLock>>& pend, bool ban)
+// Shared by all calls of ProcessPendingInstantSendLocks, so that batch sizes adapt to the rate of invalid ISLOCKs
+static CBLSBatchSizeController islockBatchSizeController(1, 32);
+
+std::unordered_set<uint256> CInstantSendManager::ProcessPendingInstantSendLocks(int signHeight, const std::unordered_map<uint256, std::pair<NodeId, CInstantSendLock>>& pend,
+                                                                                const std::unordered_map<uint256, int64_t, StaticSaltedHasher>& receivedTimes, bool ban)
 {
     auto llmqType = Params().GetConsensus().llmqForInstantSend;
 
-    CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, true, 8);
+    CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, true);
     std::unordered_map<uint256, std::pair<CQuorumCPtr, CRecoveredSig>> recSigs;
 
     for (const auto& p : pend) {
@@ -845,7 +913,7 @@ std::unordered_set<uint256> CInstantSendManager::ProcessPendingInstantSendLocks(
         }
     }
 
-    batchVerifier.Verify();
+    batchVerifier.Verify(blsWorker, &islockBatchSizeController);
 
     std::unordered_set<uint256> badISLocks;
 
@@ -857,6 +925,7 @@ std::unordered_set<uint256> CInstantSendManager::ProcessPendingInstantSendLocks(
             Misbehaving(nodeId, 20);
         }
     }
+    std::vector<const std::pair<const uint256, std::pair<NodeId, CInstantSendLock>>*> goodISLocks;
     for (const auto& p : pend) {
         auto& hash = p.first;
         auto nodeId = p.second.first;
@@ -868,8 +937,42 @@ std::unordered_set<uint256> CInstantSendManager::ProcessPendingInstantSendLocks(
             badISLocks.emplace(hash);
             continue;
         }
+        goodISLocks.emplace_back(&p);
+    }
 
-        ProcessInstantSendLock(nodeId, hash, islock);
+    // Look up the locked TXs serially on this thread. GetTransaction holds cs_main, so doing this on the BLS worker pool
+    // wouldn't make it faster but would block the pool for everyone else
+    std::vector<std::pair<CTransactionRef, uint256>> txs(goodISLocks.size());
+    for (size_t i = 0; i < goodISLocks.size(); i++) {
+        // we ignore failure here as we must be able to propagate the lock even if we don't have the TX locally
+        GetTransaction(goodISLocks[i]->second.second.txid, txs[i].first, Params().GetConsensus(), txs[i].second);
+    }
+
+    {
+        LOCK(cs_main);
+        for (auto p : goodISLocks) {
+            g_connman->RemoveAskFor(p->first);
+        }
+    }
+
+    // All islocks of this round are written with a single batch before any of them is relayed
+    CDBBatch batch(db.GetRawDB());
+    std::vector<bool> accepted(goodISLocks.size());
+    for (size_t i = 0; i < goodISLocks.size(); i++) {
+        auto& p = *goodISLocks[i];
+        accepted[i] = AcceptInstantSendLock(p.second.first, p.first, p.second.second, txs[i].first, txs[i].second, batch);
+    }
+    db.GetRawDB().WriteBatch(batch);
+
+    for (size_t i = 0; i < goodISLocks.size(); i++) {
+        auto& hash = goodISLocks[i]->first;
+        auto nodeId = goodISLocks[i]->second.first;
+        auto& islock = goodISLocks[i]->second.second;
+
+        if (accepted[i]) {
+            auto it = receivedTimes.find(hash);
+            RelayInstantSendLock(hash, islock, txs[i].first, it != receivedTimes.end() ? it->second : 0);
+        }
 
         // See comment further on top. We pass a reconstructed recovered sig to the signing manager to avoid
         // double-verification of the sig.
@@ -898,60 +1001,76 @@ void CInstantSendManager::ProcessInstantSendLock(NodeId from, const uint256& has
 
     CTransactionRef tx;
     uint256 hashBlock;
-    const CBlockIndex* pindexMined = nullptr;
     // we ignore failure here as we must be able to propagate the lock even if we don't have the TX locally
-    if (GetTransaction(islock.txid, tx, Params().GetConsensus(), hashBlock)) {
-        if (!hashBlock.IsNull()) {
-            {
-                LOCK(cs_main);
-                pindexMined = mapBlockIndex.at(hashBlock);
-            }
+    GetTransaction(islock.txid, tx, Params().GetConsensus(), hashBlock);
 
-            // Let's see if the TX that was locked by this islock is already mined in a ChainLocked block. If yes,
-            // we can simply ignore the islock, as the ChainLock implies locking of all TXs in that chain
-            if (llmq::chainLocksHandler->HasChainLock(pindexMined->nHeight, pindexMined->GetBlockHash())) {
-                LogPrint("instantsend", "CInstantSendManager::%s -- txlock=%s, islock=%s: dropping islock as it already got a ChainLock in block %s, peer=%d\n", __func__,
-                         islock.txid.ToString(), hash.ToString(), hashBlock.ToString(), from);
-                return;
-            }
+    CDBBatch batch(db.GetRawDB());
+    if (!AcceptInstantSendLock(from, hash, islock, tx, hashBlock, batch)) {
+        return;
+    }
+    db.GetRawDB().WriteBatch(batch);
+
+    RelayInstantSendLock(hash, islock, tx, 0);
+}
+
+// Returns false if the islock is dropped
+bool CInstantSendManager::AcceptInstantSendLock(NodeId from, const uint256& hash, const CInstantSendLock& islock, const CTransactionRef& tx, const uint256& hashBlock, CDBBatch& batch)
+{
+    const CBlockIndex* pindexMined = nullptr;
+    if (tx && !hashBlock.IsNull()) {
+        {
+            LOCK(cs_main);
+            pindexMined = mapBlockIndex.at(hashBlock);
+        }
+
+        // Let's see if the TX that was locked by this islock is already mined in a ChainLocked block. If yes,
+        // we can simply ignore the islock, as the ChainLock implies locking of all TXs in that chain
+        if (llmq::chainLocksHandler->HasChainLock(pindexMined->nHeight, pindexMined->GetBlockHash())) {
+            LogPrint("instantsend", "CInstantSendManager::%s -- txlock=%s, islock=%s: dropping islock as it already got a ChainLock in block %s, peer=%d\n", __func__,
+                     islock.txid.ToString(), hash.ToString(), hashBlock.ToString(), from);
+            return false;
         }
     }
 
-    {
-        LOCK(cs);
+    LOCK(cs);
 
-        LogPrint("instantsend", "CInstantSendManager::%s -- txid=%s, islock=%s: processsing islock, peer=%d\n", __func__,
-                 islock.txid.ToString(), hash.ToString(), from);
+    LogPrint("instantsend", "CInstantSendManager::%s -- txid=%s, islock=%s: processsing islock, peer=%d\n", __func__,
+             islock.txid.ToString(), hash.ToString(), from);
 
-        creatingInstantSendLocks.erase(islock.GetRequestId());
-        txToCreatingInstantSendLocks.erase(islock.txid);
+    creatingInstantSendLocks.erase(islock.GetRequestId());
+    txToCreatingInstantSendLocks.erase(islock.txid);
 
-        CInstantSendLockPtr otherIsLock;
-        if (db.GetInstantSendLockByHash(hash)) {
-            return;
-        }
-        otherIsLock = db.GetInstantSendLockByTxid(islock.txid);
+    CInstantSendLockPtr otherIsLock;
+    if (db.GetInstantSendLockByHash(hash)) {
+        return false;
+    }
+    otherIsLock = db.GetInstantSendLockByTxid(islock.txid);
+    if (otherIsLock != nullptr) {
+        LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: duplicate islock, other islock=%s, peer=%d\n", __func__,
+                 islock.txid.ToString(), hash.ToString(), ::SerializeHash(*otherIsLock).ToString(), from);
+    }
+    for (auto& in : islock.inputs) {
+        otherIsLock = db.GetInstantSendLockByInput(in);
         if (otherIsLock != nullptr) {
-            LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: duplicate islock, other islock=%s, peer=%d\n", __func__,
-                     islock.txid.ToString(), hash.ToString(), ::SerializeHash(*otherIsLock).ToString(), from);
-        }
-        for (auto& in : islock.inputs) {
-            otherIsLock = db.GetInstantSendLockByInput(in);
-            if (otherIsLock != nullptr) {
-                LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: conflicting input in islock. input=%s, other islock=%s, peer=%d\n", __func__,
-                         islock.txid.ToString(), hash.ToString(), in.ToStringShort(), ::SerializeHash(*otherIsLock).ToString(), from);
-            }
-        }
-
-        db.WriteNewInstantSendLock(hash, islock);
-        if (pindexMined) {
-            db.WriteInstantSendLockMined(hash, pindexMined->nHeight);
+            LogPrintf("CInstantSendManager::%s -- txid=%s, islock=%s: conflicting input in islock. input=%s, other islock=%s, peer=%d\n", __func__,
+                     islock.txid.ToString(), hash.ToString(), in.ToStringShort(), ::SerializeHash(*otherIsLock).ToString(), from);
         }
+    }
 
-        // This will also add children TXs to pendingRetryTxs
-        RemoveNonLockedTx(islock.txid, true);
+    db.WriteNewInstantSendLock(batch, hash, islock);
+    if (pindexMined) {
+        db.WriteInstantSendLockMined(batch, hash, pindexMined->nHeight);
     }
 
+    // This will also add children TXs to pendingRetryTxs
+    RemoveNonLockedTx(islock.txid, true);
+
+    return true;
+}
+
+// Must only be called after the islock was written to the DB
+void CInstantSendManager::RelayInstantSendLock(const uint256& hash, const CInstantSendLock& islock, const CTransactionRef& tx, int64_t nTimeReceived)
+{
     CInv inv(MSG_ISLOCK, hash);
     if (tx != nullptr) {
         g_connman->RelayInvFiltered(inv, *tx);
@@ -964,6 +1083,10 @@ void CInstantSendManager::ProcessInstantSendLock(NodeId from, const uint256& has
     RemoveMempoolConflictsForLock(hash, islock);
     ResolveBlockConflicts(hash, islock);
     UpdateWalletTransaction(islock.txid, tx);
+
+    if (tx != nullptr && nTimeReceived != 0) {
+        islockLatency.Add(GetTimeMicros() - nTimeReceived);
+    }
 }
 
 void CInstantSendManager::UpdateWalletTransaction(const uint256& txid, const CTransactionRef& tx)
@@ -1498,11 +1621,23 @@ CInstantSendLockPtr CInstantSendManager::GetConflictingLock(const CTransaction&
     return nullptr;
 }
 
+void CInstantSendManager::GetInstantSendLockLatency(UniValue& obj)
+{
+    islockLatency.ToJson(obj);
+}
+
 size_t CInstantSendManager::GetInstantSendLockCount()
 {
+    LOCK(cs);
     return db.GetInstantSendLockCount();
 }
 
+size_t CInstantSendManager::GetInstantSendLockIndexMemoryUsage()
+{
+    LOCK(cs);
+    return db.GetIndexMemoryUsage();
+}
+
 void CInstantSendManager::WorkThreadMain()
 {
     while (!workInterrupt) {
@@ -8,7 +8,7 @@
 #include "quorums_signing.h"
 
 #include "coins.h"
-#include "unordered_lru_cache.h"
+#include "latencyhistogram.h"
 #include "primitives/transaction.h"
 
 #include <unordered_map>
@@ -40,22 +40,40 @@ public:
 
 typedef std::shared_ptr<CInstantSendLock> CInstantSendLockPtr;
 
+/**
+ * All active (not yet confirmed/archived) islocks are held in an in-memory index, so that lookups by hash, txid or
+ * input never need to hit the database. Inputs and txids map to compact lock ids instead of full islock hashes. The
+ * database still contains the active islocks so that the index can be rebuilt on startup, but is otherwise only read
+ * for cold state (mined heights and archived islocks).
+ * Not thread-safe, all calls are protected by CInstantSendManager::cs.
+ */
 class CInstantSendDb
 {
 private:
     CDBWrapper& db;
 
-    unordered_lru_cache<uint256, CInstantSendLockPtr, StaticSaltedHasher, 10000> islockCache;
-    unordered_lru_cache<uint256, uint256, StaticSaltedHasher, 10000> txidCache;
-    unordered_lru_cache<COutPoint, uint256, SaltedOutpointHasher, 10000> outpointCache;
+    struct IndexEntry {
+        uint256 hash;
+        CInstantSendLockPtr islock;
+    };
+    uint32_t nextLockId{0};
+    std::unordered_map<uint32_t, IndexEntry> locksById;
+    std::unordered_map<uint256, uint32_t, StaticSaltedHasher> lockIdsByHash;
+    std::unordered_map<uint256, uint32_t, StaticSaltedHasher> lockIdsByTxid;
+    std::unordered_map<COutPoint, uint32_t, SaltedOutpointHasher> lockIdsByInput;
+    // parent txid -> ids of islocks spending outputs of the parent
+    std::unordered_multimap<uint256, uint32_t, StaticSaltedHasher> lockIdsByParent;
 
 public:
-    CInstantSendDb(CDBWrapper& _db) : db(_db) {}
+    CInstantSendDb(CDBWrapper& _db);
 
     void WriteNewInstantSendLock(const uint256& hash, const CInstantSendLock& islock);
+    // The index is updated immediately, so the islock can be looked up before the batch is written
+    void WriteNewInstantSendLock(CDBBatch& batch, const uint256& hash, const CInstantSendLock& islock);
     void RemoveInstantSendLock(CDBBatch& batch, const uint256& hash, CInstantSendLockPtr islock);
 
     void WriteInstantSendLockMined(const uint256& hash, int nHeight);
+    void WriteInstantSendLockMined(CDBBatch& batch, const uint256& hash, int nHeight);
     void RemoveInstantSendLockMined(const uint256& hash, int nHeight);
     void WriteInstantSendLockArchived(CDBBatch& batch, const uint256& hash, int nHeight);
     std::unordered_map<uint256, CInstantSendLockPtr> RemoveConfirmedInstantSendLocks(int nUntilHeight);
@@ -70,6 +88,17 @@ public:
 
     std::vector<uint256> GetInstantSendLocksByParent(const uint256& parent);
     std::vector<uint256> RemoveChainedInstantSendLocks(const uint256& islockHash, const uint256& txid, int nHeight);
+
+    // Memory used by the in-memory islock index, including the islocks themselves
+    size_t GetIndexMemoryUsage() const;
+
+    CDBWrapper& GetRawDB() { return db; }
+
+private:
+    void LoadIndex();
+    void AddToIndex(const uint256& hash, const CInstantSendLockPtr& islock);
+    void RemoveFromIndex(const uint256& hash);
+    CInstantSendLockPtr GetInstantSendLockById(uint32_t id) const;
 };
 
 class CInstantSendManager : public CRecoveredSigsListener
@@ -98,6 +127,9 @@ private:
 
     // Incoming and not verified yet
     std::unordered_map<uint256, std::pair<NodeId, CInstantSendLock>> pendingInstantSendLocks;
+    // Arrival times of pending islocks, used to measure the time until the lock is notified to the wallet and ZMQ
+    std::unordered_map<uint256, int64_t, StaticSaltedHasher> pendingInstantSendLockTimes;
+    CLatencyHistogram islockLatency;
 
     // TXs which are neither IS locked nor ChainLocked. We use this to determine for which TXs we need to retry IS locking
     // of child TXs
@@ -137,8 +169,11 @@ public:
     void ProcessMessageInstantSendLock(CNode* pfrom, const CInstantSendLock& islock, CConnman& connman);
     bool PreVerifyInstantSendLock(NodeId nodeId, const CInstantSendLock& islock, bool& retBan);
     bool ProcessPendingInstantSendLocks();
-    std::unordered_set<uint256> ProcessPendingInstantSendLocks(int signHeight, const std::unordered_map<uint256, std::pair<NodeId, CInstantSendLock>>& pend, bool ban);
+    std::unordered_set<uint256> ProcessPendingInstantSendLocks(int signHeight, const std::unordered_map<uint256, std::pair<NodeId, CInstantSendLock>>& pend,
+                                                               const std::unordered_map<uint256, int64_t, StaticSaltedHasher>& receivedTimes, bool ban);
     void ProcessInstantSendLock(NodeId from, const uint256& hash, const CInstantSendLock& islock);
+    bool AcceptInstantSendLock(NodeId from, const uint256& hash, const CInstantSendLock& islock, const CTransactionRef& tx, const uint256& hashBlock, CDBBatch& batch);
+    void RelayInstantSendLock(const uint256& hash, const CInstantSendLock& islock, const CTransactionRef& tx, int64_t nTimeReceived);
     void UpdateWalletTransaction(const uint256& txid, const CTransactionRef& tx);
 
     void SyncTransaction(const CTransaction &tx, const CBlockIndex *pindex, int posInBlock);
@@ -161,6 +196,8 @@ public:
     bool GetInstantSendLockByHash(const uint256& hash, CInstantSendLock& ret);
 
     size_t GetInstantSendLockCount();
+    size_t GetInstantSendLockIndexMemoryUsage();
+    void GetInstantSendLockLatency(UniValue& obj);
 
     void WorkThreadMain();
 };
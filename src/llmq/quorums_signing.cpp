@@ -2,6 +2,7 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "quorums_init.h"
 #include "quorums_signing.h"
 #include "quorums_utils.h"
 #include "quorums_signing_shares.h"
@@ -582,6 +583,9 @@ void CSigningManager::ProcessPendingReconstructedRecoveredSigs()
     }
 }
 
+// Shared by all calls of ProcessPendingRecoveredSigs, so that batch sizes adapt to the rate of invalid recovered sigs
+static CBLSBatchSizeController recSigsBatchSizeController(1, 32);
+
 bool CSigningManager::ProcessPendingRecoveredSigs(CConnman& connman)
 {
     std::unordered_map<NodeId, std::list<CRecoveredSig>> recSigsByNode;
@@ -617,7 +621,7 @@ bool CSigningManager::ProcessPendingRecoveredSigs(CConnman& connman)
     }
 
     cxxtimer::Timer verifyTimer(true);
-    batchVerifier.Verify();
+    batchVerifier.Verify(blsWorker, &recSigsBatchSizeController);
     verifyTimer.stop();
 
     LogPrint("llmq", "CSigningManager::%s -- verified recovered sig(s). count=%d, vt=%d, nodes=%d\n", __func__, verifyCount, verifyTimer.count(), recSigsByNode.size());
@@ -182,7 +182,8 @@ void CSigSharesNodeState::RemoveSession(const uint256& signHash)
 
 //////////////////////
 
-CSigSharesManager::CSigSharesManager()
+CSigSharesManager::CSigSharesManager(CBLSWorker& _blsWorker) :
+    blsWorker(_blsWorker)
 {
     workInterrupt.reset();
 }
@@ -570,6 +571,9 @@ void CSigSharesManager::CollectPendingSigSharesToVerify(
     }
 }
 
+// Shared by the per quorum batches of all calls of ProcessPendingSigShares
+static CBLSBatchSizeController sigSharesBatchSizeController(4, 400);
+
 bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
 {
     std::unordered_map<NodeId, std::vector<CSigShare>> sigSharesByNodes;
@@ -582,7 +586,11 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
 
     // It's ok to perform insecure batched verification here as we verify against the quorum public key shares,
     // which are not craftable by individual entities, making the rogue public key attack impossible
-    CBLSBatchVerifier<NodeId, SigShareKey> batchVerifier(false, true);
+    // Shares of different quorums never share a message hash or a public key, so they are split into one batch per
+    // quorum which can then be verified in parallel on the BLS worker pool
+    typedef CBLSBatchVerifier<NodeId, SigShareKey> BatchVerifier;
+    std::map<std::pair<Consensus::LLMQType, uint256>, BatchVerifier> batchVerifiers;
+    std::map<std::pair<Consensus::LLMQType, uint256>, size_t> batchSizes;
 
     size_t verifyCount = 0;
     for (auto& p : sigSharesByNodes) {
@@ -602,7 +610,8 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
                 break;
             }
 
-            auto quorum = quorums.at(std::make_pair((Consensus::LLMQType)sigShare.llmqType, sigShare.quorumHash));
+            auto quorumKey = std::make_pair((Consensus::LLMQType)sigShare.llmqType, sigShare.quorumHash);
+            auto quorum = quorums.at(quorumKey);
             auto pubKeyShare = quorum->GetPubKeyShare(sigShare.quorumMember);
 
             if (!pubKeyShare.IsValid()) {
@@ -612,22 +621,75 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
                 assert(false);
             }
 
-            batchVerifier.PushMessage(nodeId, sigShare.GetKey(), sigShare.GetSignHash(), sigShare.sigShare.Get(), pubKeyShare);
+            auto it = batchVerifiers.find(quorumKey);
+            if (it == batchVerifiers.end()) {
+                it = batchVerifiers.emplace(std::piecewise_construct, std::forward_as_tuple(quorumKey), std::forward_as_tuple(false, true)).first;
+            }
+            it->second.PushMessage(nodeId, sigShare.GetKey(), sigShare.GetSignHash(), sigShare.sigShare.Get(), pubKeyShare);
+            batchSizes[quorumKey]++;
             verifyCount++;
         }
     }
 
+    std::map<std::pair<Consensus::LLMQType, uint256>, int64_t> batchTimes;
+    for (auto& p : batchVerifiers) {
+        batchTimes.emplace(p.first, 0);
+    }
+
     cxxtimer::Timer verifyTimer(true);
-    batchVerifier.Verify();
+    if (batchVerifiers.size() == 1) {
+        // not worth the overhead of dispatching to the worker pool
+        auto& p = *batchVerifiers.begin();
+        int64_t nTimeStart = GetTimeMicros();
+        p.second.Verify(&blsWorker, &sigSharesBatchSizeController);
+        batchTimes[p.first] = GetTimeMicros() - nTimeStart;
+    } else {
+        std::vector<std::future<void>> futures;
+        futures.reserve(batchVerifiers.size());
+        for (auto& p : batchVerifiers) {
+            auto& batchVerifier = p.second;
+            auto& batchTime = batchTimes.at(p.first);
+            futures.emplace_back(blsWorker.AsyncExec([&batchVerifier, &batchTime]() {
+                int64_t nTimeStart = GetTimeMicros();
+                // sub batches are verified on this thread as we're already running on the worker pool
+                batchVerifier.Verify(nullptr, &sigSharesBatchSizeController);
+                batchTime = GetTimeMicros() - nTimeStart;
+            }));
+        }
+        for (auto& f : futures) {
+            f.get();
+        }
+    }
     verifyTimer.stop();
 
-    LogPrint("llmq-sigs", "CSigSharesManager::%s -- verified sig shares. count=%d, vt=%d, nodes=%d\n", __func__, verifyCount, verifyTimer.count(), sigSharesByNodes.size());
+    // merge results back, a node is bad if any of its shares in any of the batches was bad
+    std::set<NodeId> badSources;
+    for (auto& p : batchVerifiers) {
+        badSources.insert(p.second.badSources.begin(), p.second.badSources.end());
+    }
+
+    {
+        LOCK(cs);
+        for (auto& p : batchTimes) {
+            auto& stats = verifyStats[p.first.first];
+            size_t batchSize = batchSizes.at(p.first);
+            stats.batchCount++;
+            stats.sigShareCount += batchSize;
+            stats.totalTime += p.second;
+            stats.maxBatchTime = std::max(stats.maxBatchTime, p.second);
+            stats.lastBatchTime = p.second;
+            stats.lastBatchSize = batchSize;
+        }
+        lastVerifyTime = verifyTimer.count<std::chrono::microseconds>();
+    }
+
+    LogPrint("llmq-sigs", "CSigSharesManager::%s -- verified sig shares. count=%d, vt=%d, nodes=%d, batches=%d\n", __func__, verifyCount, verifyTimer.count(), sigSharesByNodes.size(), batchVerifiers.size());
 
     for (auto& p : sigSharesByNodes) {
         auto nodeId = p.first;
         auto& v = p.second;
 
-        if (batchVerifier.badSources.count(nodeId)) {
+        if (badSources.count(nodeId)) {
             LogPrintf("CSigSharesManager::%s -- invalid sig shares from other node, banning peer=%d\n",
                      __func__, nodeId);
             // this will also cause re-requesting of the shares that were sent by this node
@@ -641,6 +703,13 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
     return true;
 }
 
+std::map<Consensus::LLMQType, CSigSharesVerifyStats> CSigSharesManager::GetVerifyStats(int64_t& lastVerifyTimeRet)
+{
+    LOCK(cs);
+    lastVerifyTimeRet = lastVerifyTime;
+    return verifyStats;
+}
+
 // It's ensured that no duplicates are passed to this method
 void CSigSharesManager::ProcessPendingSigSharesFromNode(NodeId nodeId,
         const std::vector<CSigShare>& sigShares,
@@ -6,6 +6,7 @@
 #define DASH_QUORUMS_SIGNING_SHARES_H
 
 #include "bls/bls.h"
+#include "bls/bls_worker.h"
 #include "chainparams.h"
 #include "net.h"
 #include "random.h"
@@ -328,6 +329,18 @@ public:
     void RemoveSession(const uint256& signHash);
 };
 
+// Verification statistics per LLMQ type, exposed through "quorum sigsharestats"
+struct CSigSharesVerifyStats
+{
+    uint64_t batchCount{0};
+    uint64_t sigShareCount{0};
+    // all times are in microseconds
+    int64_t totalTime{0};
+    int64_t maxBatchTime{0};
+    int64_t lastBatchTime{0};
+    size_t lastBatchSize{0};
+};
+
 class CSigSharesManager : public CRecoveredSigsListener
 {
     static const int64_t SESSION_NEW_SHARES_TIMEOUT = 60;
@@ -343,6 +356,8 @@ class CSigSharesManager : public CRecoveredSigsListener
 private:
     CCriticalSection cs;
 
+    CBLSWorker& blsWorker;
+
     std::thread workThread;
     CThreadInterrupt workInterrupt;
 
@@ -363,8 +378,12 @@ private:
     int64_t lastCleanupTime{0};
     std::atomic<uint32_t> recoveredSigsCounter{0};
 
+    // protected by cs
+    std::map<Consensus::LLMQType, CSigSharesVerifyStats> verifyStats;
+    int64_t lastVerifyTime{0};
+
 public:
-    CSigSharesManager();
+    CSigSharesManager(CBLSWorker& _blsWorker);
     ~CSigSharesManager();
 
     void StartWorkerThread();
@@ -382,6 +401,9 @@ public:
 
     void HandleNewRecoveredSig(const CRecoveredSig& recoveredSig);
 
+    // lastVerifyTimeRet is the wall time of the last verification pass, which covers all batches verified in parallel
+    std::map<Consensus::LLMQType, CSigSharesVerifyStats> GetVerifyStats(int64_t& lastVerifyTimeRet);
+
 private:
     // all of these return false when the currently processed message should be aborted (as each message actually contains multiple messages)
     bool ProcessMessageSigSesAnn(CNode* pfrom, const CSigSesAnn& ann, CConnman& connman);
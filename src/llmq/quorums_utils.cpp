@@ -7,17 +7,42 @@
 
 #include "chainparams.h"
 #include "random.h"
+#include "saltedhasher.h"
+#include "unordered_lru_cache.h"
 #include "validation.h"
 
 namespace llmq
 {
 
+// Quorum members only depend on the quorum block, so cached entries never become invalid, not even on reorgs
+static const size_t QUORUM_MEMBERS_CACHE_SIZE = 128;
+
+static CCriticalSection cs_quorumMembers;
+static unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, std::vector<CDeterministicMNCPtr>, StaticSaltedHasher, QUORUM_MEMBERS_CACHE_SIZE> quorumMembersCache;
+
 std::vector<CDeterministicMNCPtr> CLLMQUtils::GetAllQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum)
 {
+    auto cacheKey = std::make_pair(llmqType, pindexQuorum->GetBlockHash());
+    std::vector<CDeterministicMNCPtr> members;
+    {
+        LOCK(cs_quorumMembers);
+        if (quorumMembersCache.get(cacheKey, members)) {
+            return members;
+        }
+    }
+
+    // Calculate without holding cs_quorumMembers, GetListForBlock might need to take other locks
+    int64_t nTimeStart = GetTimeMicros();
     auto& params = Params().GetConsensus().llmqs.at(llmqType);
     auto allMns = deterministicMNManager->GetListForBlock(pindexQuorum);
     auto modifier = ::SerializeHash(std::make_pair((uint8_t) llmqType, pindexQuorum->GetBlockHash()));
-    return allMns.CalculateQuorum(params.size, modifier);
+    members = allMns.CalculateQuorum(params.size, modifier);
+    LogPrint("llmq", "CLLMQUtils::%s -- calculated members for quorum %s (llmqType=%d), %.2fms\n", __func__,
+             pindexQuorum->GetBlockHash().ToString(), llmqType, 0.001 * (GetTimeMicros() - nTimeStart));
+
+    LOCK(cs_quorumMembers);
+    quorumMembersCache.insert(cacheKey, members);
+    return members;
 }
 
 uint256 CLLMQUtils::BuildCommitmentHash(uint8_t llmqType, const uint256& blockHash, const std::vector<bool>& validMembers, const CBLSPublicKey& pubKey, const uint256& vvecHash)
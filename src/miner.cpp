@@ -39,6 +39,7 @@
 #include "llmq/quorums_chainlocks.h"
 
 #include <algorithm>
+#include <boost/bind.hpp>
 #include <boost/thread.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <queue>
@@ -59,6 +60,8 @@ uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockSize = 0;
 int64_t nLastCoinStakeSearchInterval = 0;
 
+CBlockTemplateManager blockTemplateManager;
+
 class ScoreCompare
 {
 public:
@@ -85,6 +88,112 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
     return nNewTime - nOldTime;
 }
 
+void CBlockTemplateManager::Connect(CTxMemPool& pool)
+{
+    LOCK(cs);
+    if (connAdded.connected()) {
+        return;
+    }
+    connAdded = pool.NotifyEntryAdded.connect(boost::bind(&CBlockTemplateManager::TransactionAddedToMempool, this, _1));
+    connRemoved = pool.NotifyEntryRemoved.connect(boost::bind(&CBlockTemplateManager::TransactionRemovedFromMempool, this, _1, _2));
+    connPrioritised = pool.NotifyEntryPrioritised.connect(boost::bind(&CBlockTemplateManager::TransactionPrioritised, this, _1));
+}
+
+void CBlockTemplateManager::Invalidate()
+{
+    LOCK(cs);
+    fValid = false;
+    vSelected.clear();
+    setDeferred.clear();
+    setAdded.clear();
+    nRemoved = 0;
+}
+
+void CBlockTemplateManager::TransactionAddedToMempool(CTransactionRef tx)
+{
+    LOCK(cs);
+    if (!fValid) {
+        return;
+    }
+    setAdded.emplace(tx->GetHash());
+    CheckPendingChanges();
+}
+
+void CBlockTemplateManager::TransactionRemovedFromMempool(CTransactionRef tx, MemPoolRemovalReason reason)
+{
+    LOCK(cs);
+    if (!fValid) {
+        return;
+    }
+    // Transactions which left the mempool are dropped from the cached selection
+    // when it's re-applied, so we only need to know that something changed
+    setAdded.erase(tx->GetHash());
+    nRemoved++;
+    CheckPendingChanges();
+}
+
+void CBlockTemplateManager::TransactionPrioritised(const uint256& hash)
+{
+    // Modified fees changed, so the package selection of the last template is stale
+    Invalidate();
+}
+
+void CBlockTemplateManager::CheckPendingChanges()
+{
+    AssertLockHeld(cs);
+    if (setAdded.size() + nRemoved > MAX_PENDING_CHANGES) {
+        fValid = false;
+        vSelected.clear();
+        setDeferred.clear();
+        setAdded.clear();
+        nRemoved = 0;
+    }
+}
+
+bool CBlockTemplateManager::GetIncrementalSelection(const uint256& _hashPrevBlock, unsigned int _nBlockMaxSize, const CFeeRate& _blockMinFeeRate,
+                                                    uint64_t _nBaseBlockSize, unsigned int _nBaseBlockSigOps,
+                                                    std::vector<uint256>& vSelectedRet, std::vector<uint256>& vCandidatesRet) const
+{
+    LOCK(cs);
+    if (!fValid) {
+        return false;
+    }
+    if (hashPrevBlock != _hashPrevBlock || nBlockMaxSize != _nBlockMaxSize || !(blockMinFeeRate == _blockMinFeeRate) ||
+        nBaseBlockSize != _nBaseBlockSize || nBaseBlockSigOps != _nBaseBlockSigOps) {
+        return false;
+    }
+    if (fLimited && (!setAdded.empty() || nRemoved != 0)) {
+        // The previous template did not include everything it could have, so any
+        // change in the mempool might result in a different optimal selection
+        return false;
+    }
+
+    vSelectedRet = vSelected;
+    vCandidatesRet.clear();
+    vCandidatesRet.reserve(setAdded.size() + setDeferred.size());
+    vCandidatesRet.insert(vCandidatesRet.end(), setAdded.begin(), setAdded.end());
+    vCandidatesRet.insert(vCandidatesRet.end(), setDeferred.begin(), setDeferred.end());
+    return true;
+}
+
+void CBlockTemplateManager::SetSelection(const uint256& _hashPrevBlock, unsigned int _nBlockMaxSize, const CFeeRate& _blockMinFeeRate,
+                                         uint64_t _nBaseBlockSize, unsigned int _nBaseBlockSigOps,
+                                         std::vector<uint256>&& _vSelected, bool _fLimited, std::set<uint256>&& _setDeferred)
+{
+    LOCK(cs);
+    hashPrevBlock = _hashPrevBlock;
+    nBlockMaxSize = _nBlockMaxSize;
+    blockMinFeeRate = _blockMinFeeRate;
+    nBaseBlockSize = _nBaseBlockSize;
+    nBaseBlockSigOps = _nBaseBlockSigOps;
+    vSelected = std::move(_vSelected);
+    fLimited = _fLimited;
+    setDeferred = std::move(_setDeferred);
+    setAdded.clear();
+    nRemoved = 0;
+    fValid = true;
+}
+
 BlockAssembler::Options::Options() {
     blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     nBlockMaxSize = DEFAULT_BLOCK_MAX_SIZE;
@@ -128,6 +237,9 @@ void BlockAssembler::resetBlock()
     // These counters do not include coinbase tx
     nBlockTx = 0;
     nFees = 0;
+
+    fPackagesLimited = false;
+    setDeferredTxs.clear();
 }
 
 std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CWallet *wallet, const CChainParams& chainparams, const CScript& scriptPubKeyIn, bool fProofOfStake)
@@ -220,7 +332,20 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CWallet *wallet,
 
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
-    addPackageTxs(nPackagesSelected, nDescendantsUpdated);
+
+    // Try to re-use the package selection of the previous template first
+    const size_t nFirstMempoolTx = pblock->vtx.size();
+    const uint64_t nBaseBlockSize = nBlockSize;
+    const unsigned int nBaseBlockSigOps = nBlockSigOps;
+    blockTemplateManager.Connect(mempool);
+    std::vector<uint256> vCachedTxs;
+    std::vector<uint256> vCandidateTxs;
+    bool fIncremental = blockTemplateManager.GetIncrementalSelection(pindexPrev->GetBlockHash(), nBlockMaxSize, blockMinFeeRate,
+                                                                     nBaseBlockSize, nBaseBlockSigOps, vCachedTxs, vCandidateTxs) &&
+                        addCachedPackageTxs(vCachedTxs, vCandidateTxs, nPackagesSelected, nDescendantsUpdated);
+    if (!fIncremental) {
+        addPackageTxs(nPackagesSelected, nDescendantsUpdated);
+    }
 
     int64_t nTime1 = GetTimeMicros();
 
@@ -276,7 +401,15 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CWallet *wallet,
     }
     int64_t nTime2 = GetTimeMicros();
 
-    LogPrint("bench", "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+    std::vector<uint256> vSelectedTxs;
+    vSelectedTxs.reserve(pblock->vtx.size() - nFirstMempoolTx);
+    for (size_t i = nFirstMempoolTx; i < pblock->vtx.size(); i++) {
+        vSelectedTxs.emplace_back(pblock->vtx[i]->GetHash());
+    }
+    blockTemplateManager.SetSelection(pindexPrev->GetBlockHash(), nBlockMaxSize, blockMinFeeRate, nBaseBlockSize, nBaseBlockSigOps,
+                                      std::move(vSelectedTxs), fPackagesLimited, std::move(setDeferredTxs));
+
+    LogPrint("bench", "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants, %s), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, fIncremental ? "incremental" : "full", 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
 
     return std::move(pblocktemplate);
 }
@@ -364,6 +497,27 @@ int BlockAssembler::UpdatePackagesForAdded(const CTxMemPool::setEntries& already
     return nDescendantsUpdated;
 }
 
+void BlockAssembler::AddCandidatesToModified(const std::vector<CTxMemPool::txiter>& vCandidates, indexed_modified_transaction_set &mapModifiedTx)
+{
+    uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+    std::string dummy;
+    for (const CTxMemPool::txiter it : vCandidates) {
+        if (inBlock.count(it) || mapModifiedTx.count(it))
+            continue;
+        CTxMemPoolModifiedEntry modEntry(it);
+        CTxMemPool::setEntries ancestors;
+        mempool.CalculateMemPoolAncestors(*it, ancestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+        for (const CTxMemPool::txiter ancestor : ancestors) {
+            if (!inBlock.count(ancestor))
+                continue;
+            modEntry.nSizeWithAncestors -= ancestor->GetTxSize();
+            modEntry.nModFeesWithAncestors -= ancestor->GetModifiedFee();
+            modEntry.nSigOpCountWithAncestors -= ancestor->GetSigOpCount();
+        }
+        mapModifiedTx.insert(modEntry);
+    }
+}
+
 // Skip entries in mapTx that are already in a block or are present
 // in mapModifiedTx (which implies that the mapTx ancestor state is
 // stale due to ancestor inclusion in the block)
@@ -402,7 +556,7 @@ void BlockAssembler::SortForBlock(const CTxMemPool::setEntries& package, CTxMemP
 // Each time through the loop, we compare the best transaction in
 // mapModifiedTxs with the next transaction in the mempool to decide what
 // transaction package to work on next.
-void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated)
+void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated, const std::vector<CTxMemPool::txiter>* pvCandidates)
 {
     // mapModifiedTx will store sorted packages after they are modified
     // because some of their txs are already in the block
@@ -410,13 +564,21 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     // Keep track of entries that failed inclusion, to avoid duplicate work
     CTxMemPool::setEntries failedTx;
 
-    // Start by adding all descendants of previously added txs to mapModifiedTx
-    // and modifying them for their already included ancestors
-    UpdatePackagesForAdded(inBlock, mapModifiedTx);
-
     CTxMemPool::indexed_transaction_set::index<ancestor_score>::type::iterator mi = mempool.mapTx.get<ancestor_score>().begin();
     CTxMemPool::txiter iter;
 
+    if (pvCandidates) {
+        // Only consider the candidates (and descendants of what gets added).
+        // Everything else in mapTx is either inBlock already or was rejected
+        // when the previous template was assembled, so skip the walk over mapTx.
+        AddCandidatesToModified(*pvCandidates, mapModifiedTx);
+        mi = mempool.mapTx.get<ancestor_score>().end();
+    } else {
+        // Start by adding all descendants of previously added txs to mapModifiedTx
+        // and modifying them for their already included ancestors
+        UpdatePackagesForAdded(inBlock, mapModifiedTx);
+    }
+
     // Limit the number of attempts to add transactions to the block when it is
     // close to full; this is just a simple heuristic to finish quickly if the
     // mempool has a lot of entries.
@@ -477,6 +639,7 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
         }
 
         if (!TestPackage(packageSize, packageSigOps)) {
+            fPackagesLimited = true;
             if (fUsingModified) {
                 // Since we always look at the best entry in mapModifiedTx,
                 // we must erase failed entries so that we can consider the
@@ -504,6 +667,8 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
 
         // Test if all tx's are Final and safe
         if (!TestPackageTransactions(ancestors)) {
+            // Might become safe later, so re-evaluate it on the next template
+            setDeferredTxs.emplace(iter->GetTx().GetHash());
             if (fUsingModified) {
                 mapModifiedTx.get<ancestor_score>().erase(modit);
                 failedTx.insert(iter);
@@ -531,6 +696,53 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     }
 }
 
+bool BlockAssembler::addCachedPackageTxs(const std::vector<uint256>& vCached, const std::vector<uint256>& vCandidates, int &nPackagesSelected, int &nDescendantsUpdated)
+{
+    // Resolve the previous selection before touching the block, so that we can
+    // still fall back to a full rebuild if it doesn't match the mempool anymore
+    std::vector<CTxMemPool::txiter> vKept;
+    CTxMemPool::setEntries setKept;
+    vKept.reserve(vCached.size());
+    for (const uint256& hash : vCached) {
+        CTxMemPool::txiter it = mempool.mapTx.find(hash);
+        if (it == mempool.mapTx.end()) {
+            // Left the mempool since the previous template. Descendants are
+            // removed together with it, so they are skipped here as well.
+            continue;
+        }
+        for (const CTxMemPool::txiter parent : mempool.GetMemPoolParents(it)) {
+            if (!setKept.count(parent)) {
+                return false;
+            }
+        }
+        vKept.emplace_back(it);
+        setKept.emplace(it);
+    }
+
+    // Finality and ChainLocks safety may have changed since the previous template
+    if (!TestPackageTransactions(setKept)) {
+        return false;
+    }
+
+    // The previous selection is in a valid block order already
+    for (const CTxMemPool::txiter it : vKept) {
+        AddToBlock(it);
+    }
+
+    std::vector<CTxMemPool::txiter> vCandidateIters;
+    vCandidateIters.reserve(vCandidates.size());
+    for (const uint256& hash : vCandidates) {
+        CTxMemPool::txiter it = mempool.mapTx.find(hash);
+        if (it != mempool.mapTx.end() && !inBlock.count(it)) {
+            vCandidateIters.emplace_back(it);
+        }
+    }
+    if (!vCandidateIters.empty()) {
+        addPackageTxs(nPackagesSelected, nDescendantsUpdated, &vCandidateIters);
+    }
+    return true;
+}
+
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
 {
     // Update nExtraNonce
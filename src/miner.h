@@ -7,10 +7,13 @@
 #define BITCOIN_MINER_H
 
 #include "primitives/block.h"
+#include "sync.h"
 #include "txmempool.h"
 
 #include <stdint.h>
 #include <memory>
+#include <set>
+#include <boost/signals2/connection.hpp>
 #include "boost/multi_index_container.hpp"
 #include "boost/multi_index/ordered_index.hpp"
 
@@ -135,6 +138,73 @@ struct update_for_parent_inclusion
     CTxMemPool::txiter iter;
 };
 
+/**
+ * Keeps the mempool package selection of the last assembled block template
+ * together with the mempool changes seen since then. As long as the tip and
+ * the assembler configuration did not change, BlockAssembler uses this to
+ * re-apply the previous selection and only run package selection over the
+ * transactions that were added since, instead of walking the whole mempool.
+ */
+class CBlockTemplateManager
+{
+public:
+    // Above this number of pending mempool changes a full rebuild is cheaper
+    static const size_t MAX_PENDING_CHANGES = 5000;
+
+private:
+    mutable CCriticalSection cs;
+
+    boost::signals2::scoped_connection connAdded;
+    boost::signals2::scoped_connection connRemoved;
+    boost::signals2::scoped_connection connPrioritised;
+
+    bool fValid{false};
+
+    // Context the cached selection was built in
+    uint256 hashPrevBlock;
+    unsigned int nBlockMaxSize{0};
+    CFeeRate blockMinFeeRate;
+    uint64_t nBaseBlockSize{0};
+    unsigned int nBaseBlockSigOps{0};
+
+    // Mempool transactions of the last template, in block order
+    std::vector<uint256> vSelected;
+    // Set if package selection rejected a package for size or sigops, which
+    // means that mempool changes could change the optimal selection
+    bool fLimited{false};
+    // Transactions that were rejected for being non-final or not yet safe
+    // for mining. They are re-evaluated on every incremental update.
+    std::set<uint256> setDeferred;
+
+    // Mempool changes since the selection was stored
+    std::set<uint256> setAdded;
+    size_t nRemoved{0};
+
+public:
+    /** Subscribe to the given mempool's add/remove/prioritise notifications (only once) */
+    void Connect(CTxMemPool& pool);
+    /** Drop the cached selection, forcing the next template to be fully rebuilt */
+    void Invalidate();
+
+    /** Returns true and fills vSelectedRet/vCandidatesRet if the cached selection
+     *  can be re-used for a template in the given context */
+    bool GetIncrementalSelection(const uint256& _hashPrevBlock, unsigned int _nBlockMaxSize, const CFeeRate& _blockMinFeeRate,
+                                 uint64_t _nBaseBlockSize, unsigned int _nBaseBlockSigOps,
+                                 std::vector<uint256>& vSelectedRet, std::vector<uint256>& vCandidatesRet) const;
+    /** Store the selection of a freshly assembled template and reset the pending changes */
+    void SetSelection(const uint256& _hashPrevBlock, unsigned int _nBlockMaxSize, const CFeeRate& _blockMinFeeRate,
+                      uint64_t _nBaseBlockSize, unsigned int _nBaseBlockSigOps,
+                      std::vector<uint256>&& _vSelected, bool _fLimited, std::set<uint256>&& _setDeferred);
+
+private:
+    void TransactionAddedToMempool(CTransactionRef tx);
+    void TransactionRemovedFromMempool(CTransactionRef tx, MemPoolRemovalReason reason);
+    void TransactionPrioritised(const uint256& hash);
+    void CheckPendingChanges();
+};
+
+extern CBlockTemplateManager blockTemplateManager;
+
 /** Generate a new block, without valid proof-of-work */
 class BlockAssembler
 {
@@ -155,6 +225,10 @@ private:
     CAmount nFees;
     CTxMemPool::setEntries inBlock;
 
+    // Package selection results, stored in blockTemplateManager
+    bool fPackagesLimited;
+    std::set<uint256> setDeferredTxs;
+
     // Chain context for the block
     int nHeight;
     int64_t nLockTimeCutoff;
@@ -183,8 +257,15 @@ private:
     // Methods for how to add transactions to a block.
     /** Add transactions based on feerate including unconfirmed ancestors
       * Increments nPackagesSelected / nDescendantsUpdated with corresponding
-      * statistics from the package selection (for logging statistics). */
-    void addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated);
+      * statistics from the package selection (for logging statistics).
+      * If pvCandidates is given, only packages of these transactions are
+      * considered instead of the whole mempool. */
+    void addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated, const std::vector<CTxMemPool::txiter>* pvCandidates = nullptr);
+    /** Re-apply the selection of the previous template (dropping transactions
+      * which left the mempool) and add packages for the given candidates.
+      * Returns false if the cached selection is inconsistent with the mempool,
+      * in which case nothing was added to the block. */
+    bool addCachedPackageTxs(const std::vector<uint256>& vCached, const std::vector<uint256>& vCandidates, int &nPackagesSelected, int &nDescendantsUpdated);
 
     // helper functions for addPackageTxs()
     /** Remove confirmed (inBlock) entries from given set */
@@ -205,6 +286,9 @@ private:
       * state updated assuming given transactions are inBlock. Returns number
       * of updated descendants. */
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set &mapModifiedTx);
+    /** Add the given candidates to mapModifiedTx with ancestor state updated
+      * for their ancestors which are already inBlock */
+    void AddCandidatesToModified(const std::vector<CTxMemPool::txiter>& vCandidates, indexed_modified_transaction_set &mapModifiedTx);
 };
 
 /** Modify the extranonce in a block */
@@ -2469,40 +2469,62 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
 
             // Recursively process any orphan transactions that depended on this one
             std::set<NodeId> setMisbehaving;
+            std::set<uint256> setDone;
             while (!vWorkQueue.empty()) {
-                auto itByPrev = mapOrphanTransactionsByPrev.find(vWorkQueue.front());
-                vWorkQueue.pop_front();
-                if (itByPrev == mapOrphanTransactionsByPrev.end())
-                    continue;
-                for (auto mi = itByPrev->second.begin();
-                     mi != itByPrev->second.end();
-                     ++mi)
-                {
-                    const CTransactionRef& porphanTx = (*mi)->second.tx;
-                    const CTransaction& orphanTx = *porphanTx;
+                // All orphans which spend the queued outputs are accepted as one batch, so that their scripts are
+                // verified in parallel. Their outputs make up the next batch.
+                std::vector<CTransactionRef> vOrphans;
+                std::vector<NodeId> vFromPeers;
+                for (const COutPoint& outpoint : vWorkQueue) {
+                    auto itByPrev = mapOrphanTransactionsByPrev.find(outpoint);
+                    if (itByPrev == mapOrphanTransactionsByPrev.end())
+                        continue;
+                    for (auto mi = itByPrev->second.begin();
+                         mi != itByPrev->second.end();
+                         ++mi)
+                    {
+                        NodeId fromPeer = (*mi)->second.fromPeer;
+                        if (setMisbehaving.count(fromPeer))
+                            continue;
+                        if (!setDone.insert((*mi)->first).second)
+                            continue;
+                        vOrphans.emplace_back((*mi)->second.tx);
+                        vFromPeers.emplace_back(fromPeer);
+                    }
+                }
+                vWorkQueue.clear();
+
+                // Use dummy CValidationStates so someone can't setup nodes to counter-DoS based on orphan
+                // resolution (that is, feeding people an invalid transaction based on LegitTxX in order to get
+                // anyone relaying LegitTxX banned)
+                std::vector<bool> vAccepted;
+                std::vector<CValidationState> vStatesDummy;
+                std::vector<bool> vMissingInputs;
+                AcceptToMemoryPoolBatch(mempool, vOrphans, std::vector<int64_t>(vOrphans.size(), GetTime()), true, vAccepted, vStatesDummy, vMissingInputs);
+
+                for (size_t i = 0; i < vOrphans.size(); i++) {
+                    const CTransaction& orphanTx = *vOrphans[i];
                     const uint256& orphanHash = orphanTx.GetHash();
-                    NodeId fromPeer = (*mi)->second.fromPeer;
-                    bool fMissingInputs2 = false;
-                    // Use a dummy CValidationState so someone can't setup nodes to counter-DoS based on orphan
-                    // resolution (that is, feeding people an invalid transaction based on LegitTxX in order to get
-                    // anyone relaying LegitTxX banned)
-                    CValidationState stateDummy;
-
+                    NodeId fromPeer = vFromPeers[i];
+                    const CValidationState& stateDummy = vStatesDummy[i];
 
-                    if (setMisbehaving.count(fromPeer))
-                        continue;
-                    if (AcceptToMemoryPool(mempool, stateDummy, porphanTx, true, &fMissingInputs2)) {
+                    if (vAccepted[i]) {
                         LogPrint("mempool", "   accepted orphan tx %s\n", orphanHash.ToString());
                         connman.RelayTransaction(orphanTx);
-                        for (unsigned int i = 0; i < orphanTx.vout.size(); i++) {
-                            vWorkQueue.emplace_back(orphanHash, i);
+                        for (unsigned int j = 0; j < orphanTx.vout.size(); j++) {
+                            vWorkQueue.emplace_back(orphanHash, j);
                         }
                         vEraseQueue.push_back(orphanHash);
                     }
-                    else if (!fMissingInputs2)
+                    else if (vMissingInputs[i])
+                    {
+                        // Still missing other parents, it's looked at again when one of them is accepted
+                        setDone.erase(orphanHash);
+                    }
+                    else
                     {
                         int nDos = 0;
-                        if (stateDummy.IsInvalid(nDos) && nDos > 0)
+                        if (stateDummy.IsInvalid(nDos) && nDos > 0 && !setMisbehaving.count(fromPeer))
                         {
                             // Punish peer that gave us an invalid orphan tx
                             Misbehaving(fromPeer, nDos);
@@ -2518,8 +2540,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                             recentRejects->insert(orphanHash);
                         }
                     }
-                    mempool.check(pcoinsTip);
                 }
+                mempool.check(pcoinsTip);
             }
 
             for (uint256 hash : vEraseQueue)
@@ -55,8 +55,8 @@ void CPrivateSendClientManager::ProcessMessage(CNode* pfrom, const std::string&
                     // LogPrint("privatesend", "DSQUEUE -- %s seen\n", dsq.ToString());
                     return;
                 }
-                if (q.fReady == dsq.fReady && q.masternodeOutpoint == dsq.masternodeOutpoint) {
-                    // no way the same mn can send another dsq with the same readiness this soon
+                if (dsq.OverlapsWith(q)) {
+                    // no way the same mn can send another dsq with the same readiness this soon, it announces one queue at a time
                     LogPrint("privatesend", "DSQUEUE -- Peer %d is sending WAY too many dsq messages for a masternode with collateral %s\n", pfrom->id, dsq.masternodeOutpoint.ToStringShort());
                     return;
                 }
@@ -82,7 +82,8 @@ void CPrivateSendClientManager::ProcessMessage(CNode* pfrom, const std::string&
             LOCK(cs_deqsessions);
             for (auto& session : deqSessions) {
                 CDeterministicMNCPtr mnMixing;
-                if (session.GetMixingMasternodeInfo(mnMixing) && mnMixing->pdmnState->addr == dmn->pdmnState->addr && session.GetState() == POOL_STATE_QUEUE) {
+                // the masternode can run several sessions, only submit into the one which is ready
+                if (session.GetMixingMasternodeInfo(mnMixing) && mnMixing->pdmnState->addr == dmn->pdmnState->addr && session.GetState() == POOL_STATE_QUEUE && session.nSessionDenom == dsq.nDenom) {
                     LogPrint("privatesend", "DSQUEUE -- PrivateSend queue (%s) is ready on masternode %s\n", dsq.ToString(), dmn->pdmnState->addr.ToString());
                     session.SubmitDenominate(connman);
                     return;
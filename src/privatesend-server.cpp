@@ -36,61 +36,12 @@ void CPrivateSendServer::ProcessMessage(CNode* pfrom, const std::string& strComm
             return;
         }
 
-        if (IsSessionReady()) {
-            // too many users in this session already, reject new ones
-            LogPrintf("DSACCEPT -- queue is already full!\n");
-            PushStatus(pfrom, STATUS_ACCEPTED, ERR_QUEUE_FULL, connman);
-            return;
-        }
-
         CPrivateSendAccept dsa;
         vRecv >> dsa;
 
         LogPrint("privatesend", "DSACCEPT -- nDenom %d (%s)  txCollateral %s", dsa.nDenom, CPrivateSend::GetDenominationsToString(dsa.nDenom), dsa.txCollateral.ToString());
 
-        auto mnList = deterministicMNManager->GetListAtChainTip();
-        auto dmn = mnList.GetValidMNByCollateral(activeMasternodeInfo.outpoint);
-        if (!dmn) {
-            PushStatus(pfrom, STATUS_REJECTED, ERR_MN_LIST, connman);
-            return;
-        }
-
-        if (vecSessionCollaterals.size() == 0) {
-            {
-                TRY_LOCK(cs_vecqueue, lockRecv);
-                if (!lockRecv) return;
-
-                for (const auto& q : vecPrivateSendQueue) {
-                    if (q.masternodeOutpoint == activeMasternodeInfo.outpoint) {
-                        // refuse to create another queue this often
-                        LogPrint("privatesend", "DSACCEPT -- last dsq is still in queue, refuse to mix\n");
-                        PushStatus(pfrom, STATUS_REJECTED, ERR_RECENT, connman);
-                        return;
-                    }
-                }
-            }
-
-            int64_t nLastDsq = mmetaman.GetMetaInfo(dmn->proTxHash)->GetLastDsq();
-            if (nLastDsq != 0 && nLastDsq + mnList.GetValidMNsCount() / 5 > mmetaman.GetDsqCount()) {
-                LogPrintf("DSACCEPT -- last dsq too recent, must wait: addr=%s\n", pfrom->addr.ToString());
-                PushStatus(pfrom, STATUS_REJECTED, ERR_RECENT, connman);
-                return;
-            }
-        }
-
-        PoolMessage nMessageID = MSG_NOERR;
-
-        bool fResult = nSessionID == 0 ? CreateNewSession(dsa, nMessageID, connman)
-                                       : AddUserToExistingSession(dsa, nMessageID);
-        if (fResult) {
-            LogPrintf("DSACCEPT -- is compatible, please submit!\n");
-            PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
-            return;
-        } else {
-            LogPrintf("DSACCEPT -- not compatible with existing transactions!\n");
-            PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
-            return;
-        }
+        ProcessDSACCEPT(pfrom, dsa, connman);
 
     } else if (strCommand == NetMsgType::DSQUEUE) {
         if (pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
@@ -112,8 +63,8 @@ void CPrivateSendServer::ProcessMessage(CNode* pfrom, const std::string& strComm
                     // LogPrint("privatesend", "DSQUEUE -- %s seen\n", dsq.ToString());
                     return;
                 }
-                if (q.fReady == dsq.fReady && q.masternodeOutpoint == dsq.masternodeOutpoint) {
-                    // no way the same mn can send another dsq with the same readiness this soon
+                if (dsq.OverlapsWith(q)) {
+                    // no way the same mn can send another dsq with the same readiness this soon, it announces one queue at a time
                     LogPrint("privatesend", "DSQUEUE -- Peer %d is sending WAY too many dsq messages for a masternode with collateral %s\n", pfrom->id, dsq.masternodeOutpoint.ToStringShort());
                     return;
                 }
@@ -161,169 +112,653 @@ void CPrivateSendServer::ProcessMessage(CNode* pfrom, const std::string& strComm
             return;
         }
 
-        //do we have enough users in the current session?
-        if (!IsSessionReady()) {
-            LogPrintf("DSVIN -- session not complete!\n");
-            PushStatus(pfrom, STATUS_REJECTED, ERR_SESSION, connman);
-            return;
-        }
-
         CPrivateSendEntry entry;
         vRecv >> entry;
 
         LogPrint("privatesend", "DSVIN -- txCollateral %s", entry.txCollateral->ToString());
 
+        ProcessDSVIN(pfrom, entry, connman);
+
+    } else if (strCommand == NetMsgType::DSSIGNFINALTX) {
+        if (pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
+            LogPrint("privatesend", "DSSIGNFINALTX -- peer=%d using obsolete version %i\n", pfrom->id, pfrom->nVersion);
+            connman.PushMessage(pfrom, CNetMsgMaker(pfrom->GetSendVersion()).Make(NetMsgType::REJECT, strCommand, REJECT_OBSOLETE, strprintf("Version must be %d or greater", MIN_PRIVATESEND_PEER_PROTO_VERSION)));
+            return;
+        }
+
+        std::vector<CTxIn> vecTxIn;
+        vRecv >> vecTxIn;
+
+        LogPrint("privatesend", "DSSIGNFINALTX -- vecTxIn.size() %s\n", vecTxIn.size());
+
+        ProcessDSSIGNFINALTX(pfrom, vecTxIn, connman);
+    }
+}
+
+void CPrivateSendServer::ProcessDSACCEPT(CNode* pfrom, CPrivateSendAccept& dsa, CConnman& connman)
+{
+    auto mnList = deterministicMNManager->GetListAtChainTip();
+    auto dmn = mnList.GetValidMNByCollateral(activeMasternodeInfo.outpoint);
+    if (!dmn) {
+        PushStatus(pfrom, STATUS_REJECTED, ERR_MN_LIST, connman);
+        return;
+    }
+
+    if (GetPeerSession(pfrom->GetId())) {
+        LogPrintf("DSACCEPT -- peer=%d is already part of a session\n", pfrom->GetId());
+        PushStatus(pfrom, STATUS_REJECTED, ERR_MODE, connman);
+        return;
+    }
+
+    PoolMessage nMessageID = MSG_NOERR;
+
+    if (!IsAcceptableDSA(dsa, nMessageID)) {
+        LogPrintf("DSACCEPT -- not compatible with existing transactions!\n");
+        PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
+        return;
+    }
+
+    // prefer sessions which are still waiting for participants with the same denom
+    for (const auto& session : GetSessions()) {
+        {
+            LOCK(session->GetLock());
+            if (session->GetState() != POOL_STATE_QUEUE || session->nSessionDenom != dsa.nDenom) continue;
+            if (!session->AddUserToExistingSession(dsa, nMessageID)) continue;
+            LogPrintf("DSACCEPT -- is compatible, please submit!\n");
+            session->PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
+        }
+        LOCK(cs_sessions);
+        mapPeerSessions[pfrom->GetId()] = session->GetSessionID();
+        return;
+    }
+
+    int nSessionID;
+    {
+        LOCK(cs_sessions);
+        if ((int)mapSessions.size() >= MAX_PRIVATESEND_SERVER_SESSIONS) {
+            // too many sessions running already, reject new ones
+            LogPrintf("DSACCEPT -- queue is already full!\n");
+            PushStatus(pfrom, STATUS_ACCEPTED, ERR_QUEUE_FULL, connman);
+            return;
+        }
+        do {
+            nSessionID = GetRandInt(999999) + 1;
+        } while (mapSessions.count(nSessionID));
+    }
+
+    // Only announce the new session if the network would accept our dsq, i.e. there is one public queue per masternode
+    // at a time. Otherwise the session is only joined by clients which picked this masternode on their own.
+    bool fRelayQueue = true;
+    {
+        LOCK(cs_vecqueue);
+        CPrivateSendQueue dsqNew(dsa.nDenom, activeMasternodeInfo.outpoint, GetAdjustedTime(), false);
+        for (const auto& q : vecPrivateSendQueue) {
+            if (dsqNew.OverlapsWith(q)) {
+                LogPrint("privatesend", "DSACCEPT -- last dsq is still in queue, not announcing session %d\n", nSessionID);
+                fRelayQueue = false;
+                break;
+            }
+        }
+    }
+
+    int64_t nLastDsq = mmetaman.GetMetaInfo(dmn->proTxHash)->GetLastDsq();
+    if (fRelayQueue && nLastDsq != 0 && nLastDsq + mnList.GetValidMNsCount() / 5 > mmetaman.GetDsqCount()) {
+        LogPrint("privatesend", "DSACCEPT -- last dsq too recent, not announcing session %d\n", nSessionID);
+        fRelayQueue = false;
+    }
+
+    auto session = std::make_shared<CPrivateSendServerSession>(fUnitTest);
+    CPrivateSendQueue dsq;
+    {
+        LOCK(session->GetLock());
+        if (!session->CreateNewSession(nSessionID, dsa, fRelayQueue, nMessageID, connman, dsq)) {
+            LogPrintf("DSACCEPT -- not compatible with existing transactions!\n");
+            PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
+            return;
+        }
+        LogPrintf("DSACCEPT -- is compatible, please submit!\n");
+        session->PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
+    }
+
+    if (fRelayQueue) {
+        LOCK(cs_vecqueue);
+        vecPrivateSendQueue.push_back(dsq);
+    }
+
+    LOCK(cs_sessions);
+    mapSessions.emplace(nSessionID, session);
+    mapPeerSessions[pfrom->GetId()] = nSessionID;
+}
+
+void CPrivateSendServer::ProcessDSVIN(CNode* pfrom, CPrivateSendEntry& entry, CConnman& connman)
+{
+    auto session = GetPeerSession(pfrom->GetId());
+    if (!session) {
+        LogPrintf("DSVIN -- peer=%d is not part of any session!\n", pfrom->GetId());
+        PushStatus(pfrom, STATUS_REJECTED, ERR_SESSION, connman);
+        return;
+    }
+
+    {
+        LOCK(session->GetLock());
+
+        //do we have enough users in the current session?
+        if (!session->IsSessionReady()) {
+            LogPrintf("DSVIN -- session not complete!\n");
+            session->PushStatus(pfrom, STATUS_REJECTED, ERR_SESSION, connman);
+            return;
+        }
+
         if (entry.vecTxDSIn.size() > PRIVATESEND_ENTRY_MAX_SIZE) {
             LogPrintf("DSVIN -- ERROR: too many inputs! %d/%d\n", entry.vecTxDSIn.size(), PRIVATESEND_ENTRY_MAX_SIZE);
-            PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
+            session->PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
             return;
         }
 
         if (entry.vecTxOut.size() > PRIVATESEND_ENTRY_MAX_SIZE) {
             LogPrintf("DSVIN -- ERROR: too many outputs! %d/%d\n", entry.vecTxOut.size(), PRIVATESEND_ENTRY_MAX_SIZE);
-            PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
+            session->PushStatus(pfrom, STATUS_REJECTED, ERR_MAXIMUM, connman);
             return;
         }
 
         //do we have the same denominations as the current session?
-        if (!IsOutputsCompatibleWithSessionDenom(entry.vecTxOut)) {
+        if (!session->IsOutputsCompatibleWithSessionDenom(entry.vecTxOut)) {
             LogPrintf("DSVIN -- not compatible with existing transactions!\n");
-            PushStatus(pfrom, STATUS_REJECTED, ERR_EXISTING_TX, connman);
+            session->PushStatus(pfrom, STATUS_REJECTED, ERR_EXISTING_TX, connman);
             return;
         }
 
-        //check it like a transaction
-        {
-            CAmount nValueIn = 0;
-            CAmount nValueOut = 0;
+        for (const auto& txout : entry.vecTxOut) {
+            if (txout.scriptPubKey.size() != 25) {
+                LogPrintf("DSVIN -- non-standard pubkey detected! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
+                session->PushStatus(pfrom, STATUS_REJECTED, ERR_NON_STANDARD_PUBKEY, connman);
+                return;
+            }
+            if (!txout.scriptPubKey.IsPayToPublicKeyHash()) {
+                LogPrintf("DSVIN -- invalid script! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
+                session->PushStatus(pfrom, STATUS_REJECTED, ERR_INVALID_SCRIPT, connman);
+                return;
+            }
+        }
+    }
 
-            CMutableTransaction tx;
+    entry.addr = pfrom->addr;
 
-            for (const auto& txout : entry.vecTxOut) {
-                nValueOut += txout.nValue;
-                tx.vout.push_back(txout);
+    bool fQueued = false;
+    {
+        LOCK(cs_pending);
+        if (deqPendingEntries.size() < MAX_PENDING_PRIVATESEND_ENTRIES) {
+            deqPendingEntries.push_back({session->GetSessionID(), pfrom->GetId(), entry});
+            fQueued = true;
+        }
+    }
 
-                if (txout.scriptPubKey.size() != 25) {
-                    LogPrintf("DSVIN -- non-standard pubkey detected! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
-                    PushStatus(pfrom, STATUS_REJECTED, ERR_NON_STANDARD_PUBKEY, connman);
-                    return;
-                }
-                if (!txout.scriptPubKey.IsPayToPublicKeyHash()) {
-                    LogPrintf("DSVIN -- invalid script! scriptPubKey=%s\n", ScriptToAsmStr(txout.scriptPubKey));
-                    PushStatus(pfrom, STATUS_REJECTED, ERR_INVALID_SCRIPT, connman);
-                    return;
-                }
+    if (!fQueued) {
+        LogPrintf("DSVIN -- too many pending entries!\n");
+        LOCK(session->GetLock());
+        session->PushStatus(pfrom, STATUS_REJECTED, ERR_QUEUE_FULL, connman);
+    }
+}
+
+void CPrivateSendServer::ProcessDSSIGNFINALTX(CNode* pfrom, const std::vector<CTxIn>& vecTxIn, CConnman& connman)
+{
+    auto session = GetPeerSession(pfrom->GetId());
+    if (!session) {
+        LogPrint("privatesend", "DSSIGNFINALTX -- peer=%d is not part of any session\n", pfrom->GetId());
+        return;
+    }
+
+    {
+        LOCK(session->GetLock());
+        if (!session->AddScriptSigs(vecTxIn, connman) || !session->IsReadyToCommit()) {
+            return;
+        }
+    }
+
+    // all is good, let the worker commit the final transaction
+    LOCK(cs_pending);
+    setSessionsToCommit.emplace(session->GetSessionID());
+}
+
+bool CPrivateSendServer::IsEntryValid(const CPrivateSendEntry& entry, PoolMessage& nMessageIDRet)
+{
+    //check it like a transaction
+    CAmount nValueIn = 0;
+    CAmount nValueOut = 0;
+
+    CMutableTransaction tx;
+
+    for (const auto& txout : entry.vecTxOut) {
+        nValueOut += txout.nValue;
+        tx.vout.push_back(txout);
+    }
+
+    for (const auto& txin : entry.vecTxDSIn) {
+        tx.vin.push_back(txin);
+
+        LogPrint("privatesend", "CPrivateSendServer::%s -- txin=%s\n", __func__, txin.ToString());
+
+        if (txin.prevout.IsNull()) {
+            LogPrint("privatesend", "CPrivateSendServer::%s -- input not valid!\n", __func__);
+            nMessageIDRet = ERR_INVALID_INPUT;
+            return false;
+        }
+
+        Coin coin;
+        auto mempoolTx = mempool.get(txin.prevout.hash);
+        if (mempoolTx != nullptr) {
+            if (mempool.isSpent(txin.prevout) || !llmq::quorumInstantSendManager->IsLocked(txin.prevout.hash)) {
+                LogPrintf("CPrivateSendServer::%s -- spent or non-locked mempool input! txin=%s\n", __func__, txin.ToString());
+                nMessageIDRet = ERR_MISSING_TX;
+                return false;
             }
+            nValueIn += mempoolTx->vout[txin.prevout.n].nValue;
+        } else if (GetUTXOCoin(txin.prevout, coin)) {
+            nValueIn += coin.out.nValue;
+        } else {
+            LogPrintf("CPrivateSendServer::%s -- missing input! txin=%s\n", __func__, txin.ToString());
+            nMessageIDRet = ERR_MISSING_TX;
+            return false;
+        }
+    }
 
-            for (const auto& txin : entry.vecTxDSIn) {
-                tx.vin.push_back(txin);
-
-                LogPrint("privatesend", "DSVIN -- txin=%s\n", txin.ToString());
-
-                Coin coin;
-                auto mempoolTx = mempool.get(txin.prevout.hash);
-                if (mempoolTx != nullptr) {
-                    if (mempool.isSpent(txin.prevout) || !llmq::quorumInstantSendManager->IsLocked(txin.prevout.hash)) {
-                        LogPrintf("DSVIN -- spent or non-locked mempool input! txin=%s\n", txin.ToString());
-                        PushStatus(pfrom, STATUS_REJECTED, ERR_MISSING_TX, connman);
-                        return;
-                    }
-                    nValueIn += mempoolTx->vout[txin.prevout.n].nValue;
-                } else if (GetUTXOCoin(txin.prevout, coin)) {
-                    nValueIn += coin.out.nValue;
-                } else {
-                    LogPrintf("DSVIN -- missing input! txin=%s\n", txin.ToString());
-                    PushStatus(pfrom, STATUS_REJECTED, ERR_MISSING_TX, connman);
-                    return;
-                }
+    // There should be no fee in mixing tx
+    CAmount nFee = nValueIn - nValueOut;
+    if (nFee != 0) {
+        LogPrintf("CPrivateSendServer::%s -- there should be no fee in mixing tx! fees: %lld, tx=%s", __func__, nFee, tx.ToString());
+        nMessageIDRet = ERR_FEES;
+        return false;
+    }
+
+    if (!CPrivateSend::IsCollateralValid(*entry.txCollateral)) {
+        LogPrint("privatesend", "CPrivateSendServer::%s -- collateral not valid!\n", __func__);
+        nMessageIDRet = ERR_INVALID_COLLATERAL;
+        return false;
+    }
+
+    return true;
+}
+
+bool CPrivateSendServer::ProcessPendingEntries(CConnman& connman)
+{
+    std::deque<PendingEntry> deqEntries;
+    {
+        LOCK(cs_pending);
+        deqEntries.swap(deqPendingEntries);
+    }
+
+    if (deqEntries.empty()) {
+        return false;
+    }
+
+    for (const auto& pendingEntry : deqEntries) {
+        auto session = GetSession(pendingEntry.nSessionID);
+        if (!session) {
+            // session timed out or was reset in the meantime
+            continue;
+        }
+
+        PoolMessage nMessageID = MSG_NOERR;
+        bool fAccepted = IsEntryValid(pendingEntry.entry, nMessageID);
+        bool fReserved = false;
+        if (fAccepted) {
+            fReserved = fAccepted = ReservePrevouts(pendingEntry.nSessionID, pendingEntry.entry);
+            if (!fAccepted) {
+                LogPrint("privatesend", "CPrivateSendServer::%s -- input already used in another entry, peer=%d\n", __func__, pendingEntry.nodeId);
+                nMessageID = ERR_ALREADY_HAVE;
+            }
+        }
+
+        {
+            LOCK(session->GetLock());
+            fAccepted = fAccepted && session->AddEntry(pendingEntry.entry, nMessageID);
+            connman.ForNode(pendingEntry.nodeId, [&](CNode* pnode) {
+                session->PushStatus(pnode, fAccepted ? STATUS_ACCEPTED : STATUS_REJECTED, nMessageID, connman);
+                return true;
+            });
+            if (fAccepted) {
+                session->CheckPool(connman);
+                session->RelayStatus(STATUS_ACCEPTED, connman);
             }
+        }
+
+        if (fReserved && !fAccepted) {
+            ReleasePrevouts(pendingEntry.nSessionID, pendingEntry.entry);
+        }
+    }
+
+    return true;
+}
+
+bool CPrivateSendServer::ProcessPendingCommits(CConnman& connman)
+{
+    std::set<int> setSessions;
+    {
+        LOCK(cs_pending);
+        setSessions.swap(setSessionsToCommit);
+    }
+
+    if (setSessions.empty()) {
+        return false;
+    }
+
+    for (int nSessionID : setSessions) {
+        auto session = GetSession(nSessionID);
+        if (!session) {
+            continue;
+        }
+
+        LOCK(session->GetLock());
+        if (session->IsReadyToCommit()) {
+            session->CommitFinalTransaction(connman);
+        }
+    }
+
+    CleanupSessions();
+
+    return true;
+}
+
+void CPrivateSendServer::StartWorkerThread()
+{
+    // can't start new thread if we have one running already
+    if (workThread.joinable()) {
+        assert(false);
+    }
+
+    workInterrupt.reset();
+    workThread = std::thread(&TraceThread<std::function<void()> >, "psserver", std::function<void()>(std::bind(&CPrivateSendServer::WorkThreadMain, this)));
+}
 
-            // There should be no fee in mixing tx
-            CAmount nFee = nValueIn - nValueOut;
-            if (nFee != 0) {
-                LogPrintf("DSVIN -- there should be no fee in mixing tx! fees: %lld, tx=%s", nFee, tx.ToString());
-                PushStatus(pfrom, STATUS_REJECTED, ERR_FEES, connman);
+void CPrivateSendServer::StopWorkerThread()
+{
+    // make sure to call InterruptWorkerThread() first
+    if (!workInterrupt) {
+        assert(false);
+    }
+
+    if (workThread.joinable()) {
+        workThread.join();
+    }
+}
+
+void CPrivateSendServer::InterruptWorkerThread()
+{
+    workInterrupt();
+}
+
+void CPrivateSendServer::WorkThreadMain()
+{
+    while (!workInterrupt) {
+        bool fDidWork = ProcessPendingEntries(*g_connman);
+        fDidWork |= ProcessPendingCommits(*g_connman);
+        if (!fDidWork) {
+            if (!workInterrupt.sleep_for(std::chrono::milliseconds(100))) {
                 return;
             }
         }
+    }
+}
 
-        PoolMessage nMessageID = MSG_NOERR;
+std::shared_ptr<CPrivateSendServerSession> CPrivateSendServer::GetSession(int nSessionID) const
+{
+    LOCK(cs_sessions);
+    auto it = mapSessions.find(nSessionID);
+    if (it == mapSessions.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
 
-        entry.addr = pfrom->addr;
-        if (AddEntry(entry, nMessageID)) {
-            PushStatus(pfrom, STATUS_ACCEPTED, nMessageID, connman);
-            CheckPool(connman);
-            RelayStatus(STATUS_ACCEPTED, connman);
+std::shared_ptr<CPrivateSendServerSession> CPrivateSendServer::GetPeerSession(NodeId nodeId) const
+{
+    LOCK(cs_sessions);
+    auto it = mapPeerSessions.find(nodeId);
+    if (it == mapPeerSessions.end()) {
+        return nullptr;
+    }
+    auto itSession = mapSessions.find(it->second);
+    if (itSession == mapSessions.end()) {
+        return nullptr;
+    }
+    return itSession->second;
+}
+
+std::vector<std::shared_ptr<CPrivateSendServerSession> > CPrivateSendServer::GetSessions() const
+{
+    std::vector<std::shared_ptr<CPrivateSendServerSession> > vecSessions;
+    LOCK(cs_sessions);
+    vecSessions.reserve(mapSessions.size());
+    for (const auto& p : mapSessions) {
+        vecSessions.emplace_back(p.second);
+    }
+    return vecSessions;
+}
+
+void CPrivateSendServer::CleanupSessions()
+{
+    LOCK(cs_sessions);
+
+    for (auto it = mapSessions.begin(); it != mapSessions.end(); ) {
+        // a session which is locked right now is busy and surely not done
+        TRY_LOCK(it->second->GetLock(), lockSession);
+        if (lockSession && it->second->GetState() == POOL_STATE_IDLE) {
+            LogPrint("privatesend", "CPrivateSendServer::%s -- removing session %d\n", __func__, it->first);
+            it = mapSessions.erase(it);
         } else {
-            PushStatus(pfrom, STATUS_REJECTED, nMessageID, connman);
+            ++it;
         }
+    }
 
-    } else if (strCommand == NetMsgType::DSSIGNFINALTX) {
-        if (pfrom->nVersion < MIN_PRIVATESEND_PEER_PROTO_VERSION) {
-            LogPrint("privatesend", "DSSIGNFINALTX -- peer=%d using obsolete version %i\n", pfrom->id, pfrom->nVersion);
-            connman.PushMessage(pfrom, CNetMsgMaker(pfrom->GetSendVersion()).Make(NetMsgType::REJECT, strCommand, REJECT_OBSOLETE, strprintf("Version must be %d or greater", MIN_PRIVATESEND_PEER_PROTO_VERSION)));
-            return;
+    for (auto it = mapPeerSessions.begin(); it != mapPeerSessions.end(); ) {
+        if (!mapSessions.count(it->second)) {
+            it = mapPeerSessions.erase(it);
+        } else {
+            ++it;
         }
+    }
 
-        std::vector<CTxIn> vecTxIn;
-        vRecv >> vecTxIn;
+    // sessions are only removed after they were committed or reset
+    for (auto it = mapReservedPrevouts.begin(); it != mapReservedPrevouts.end(); ) {
+        if (!mapSessions.count(it->second)) {
+            it = mapReservedPrevouts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
-        LogPrint("privatesend", "DSSIGNFINALTX -- vecTxIn.size() %s\n", vecTxIn.size());
+bool CPrivateSendServer::ReservePrevouts(int nSessionID, const CPrivateSendEntry& entry)
+{
+    LOCK(cs_sessions);
 
-        int nTxInIndex = 0;
-        int nTxInsCount = (int)vecTxIn.size();
+    for (const auto& txdsin : entry.vecTxDSIn) {
+        if (mapReservedPrevouts.count(txdsin.prevout)) {
+            return false;
+        }
+    }
+    for (const auto& txdsin : entry.vecTxDSIn) {
+        mapReservedPrevouts.emplace(txdsin.prevout, nSessionID);
+    }
+    return true;
+}
 
-        for (const auto& txin : vecTxIn) {
-            nTxInIndex++;
-            if (!AddScriptSig(txin)) {
-                LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSig() failed at %d/%d, session: %d\n", nTxInIndex, nTxInsCount, nSessionID);
-                RelayStatus(STATUS_REJECTED, connman);
-                return;
+void CPrivateSendServer::ReleasePrevouts(int nSessionID, const CPrivateSendEntry& entry)
+{
+    LOCK(cs_sessions);
+
+    for (const auto& txdsin : entry.vecTxDSIn) {
+        auto it = mapReservedPrevouts.find(txdsin.prevout);
+        if (it != mapReservedPrevouts.end() && it->second == nSessionID) {
+            mapReservedPrevouts.erase(it);
+        }
+    }
+}
+
+int CPrivateSendServer::GetSessionsCount() const
+{
+    LOCK(cs_sessions);
+    return mapSessions.size();
+}
+
+UniValue CPrivateSendServer::GetSessionsInfo() const
+{
+    UniValue arr(UniValue::VARR);
+    for (const auto& session : GetSessions()) {
+        LOCK(session->GetLock());
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("id",      session->GetSessionID()));
+        obj.push_back(Pair("denom",   CPrivateSend::GetDenominationsToString(session->nSessionDenom)));
+        obj.push_back(Pair("state",   session->GetStateString()));
+        obj.push_back(Pair("entries", session->GetEntriesCount()));
+        arr.push_back(obj);
+    }
+    return arr;
+}
+
+void CPrivateSendServer::PushStatus(CNode* pnode, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID, CConnman& connman)
+{
+    if (!pnode) return;
+    CNetMsgMaker msgMaker(pnode->GetSendVersion());
+    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DSSTATUSUPDATE, 0, (int)POOL_STATE_IDLE, 0, (int)nStatusUpdate, (int)nMessageID));
+}
+
+bool CPrivateSendServer::IsAcceptableDSA(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet)
+{
+    if (!fMasternodeMode) return false;
+
+    // is denom even smth legit?
+    std::vector<int> vecBits;
+    if (!CPrivateSend::GetDenominationsBits(dsa.nDenom, vecBits)) {
+        LogPrint("privatesend", "CPrivateSendServer::%s -- denom not valid!\n", __func__);
+        nMessageIDRet = ERR_DENOM;
+        return false;
+    }
+
+    // check collateral
+    if (!fUnitTest && !CPrivateSend::IsCollateralValid(dsa.txCollateral)) {
+        LogPrint("privatesend", "CPrivateSendServer::%s -- collateral not valid!\n", __func__);
+        nMessageIDRet = ERR_INVALID_COLLATERAL;
+        return false;
+    }
+
+    return true;
+}
+
+
+//
+// Check for various timeouts (queue objects, mixing, etc)
+//
+void CPrivateSendServer::CheckTimeout(CConnman& connman)
+{
+    if (!fMasternodeMode) return;
+
+    CheckQueue();
+
+    for (const auto& session : GetSessions()) {
+        LOCK(session->GetLock());
+        session->CheckTimeout(connman);
+    }
+
+    CleanupSessions();
+}
+
+void CPrivateSendServer::CheckForCompleteQueue(CConnman& connman)
+{
+    if (!fMasternodeMode) return;
+
+    for (const auto& session : GetSessions()) {
+        CPrivateSendQueue dsq;
+        {
+            LOCK(session->GetLock());
+            if (!session->CheckForCompleteQueue(dsq)) continue;
+        }
+
+        // Other sessions might still be waiting for participants, so the ready queue is only sent to the participants
+        // of this session instead of being relayed. Nobody else can submit into the wrong session then.
+        std::vector<NodeId> vecNodes;
+        {
+            LOCK(cs_sessions);
+            for (const auto& p : mapPeerSessions) {
+                if (p.second == session->GetSessionID()) {
+                    vecNodes.emplace_back(p.first);
+                }
             }
-            LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSig() %d/%d success\n", nTxInIndex, nTxInsCount);
         }
-        // all is good
-        CheckPool(connman);
+        for (const auto nodeId : vecNodes) {
+            connman.ForNode(nodeId, [&connman, &dsq](CNode* pnode) {
+                CNetMsgMaker msgMaker(pnode->GetSendVersion());
+                connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DSQUEUE, dsq));
+                return true;
+            });
+        }
     }
 }
 
-void CPrivateSendServer::SetNull()
+void CPrivateSendServer::DoMaintenance(CConnman& connman)
+{
+    if (fLiteMode) return;        // disable all Dash specific functionality
+    if (!fMasternodeMode) return; // only run on masternodes
+
+    if (!masternodeSync.IsBlockchainSynced() || ShutdownRequested())
+        return;
+
+    privateSendServer.CheckTimeout(connman);
+    privateSendServer.CheckForCompleteQueue(connman);
+}
+
+void CPrivateSendServerSession::SetNull()
 {
     // MN side
     vecSessionCollaterals.clear();
     nSessionMaxParticipants = 0;
 
     CPrivateSendBaseSession::SetNull();
-    CPrivateSendBaseManager::SetNull();
 }
 
 //
 // Check the mixing progress and send client updates if a Masternode
 //
-void CPrivateSendServer::CheckPool(CConnman& connman)
+void CPrivateSendServerSession::CheckPool(CConnman& connman)
 {
     if (!fMasternodeMode) return;
 
-    LogPrint("privatesend", "CPrivateSendServer::CheckPool -- entries count %lu\n", GetEntriesCount());
+    LogPrint("privatesend", "CPrivateSendServerSession::CheckPool -- nSessionID: %d  entries count %lu\n", nSessionID, GetEntriesCount());
 
     // If entries are full, create finalized transaction
     if (nState == POOL_STATE_ACCEPTING_ENTRIES && GetEntriesCount() >= nSessionMaxParticipants) {
-        LogPrint("privatesend", "CPrivateSendServer::CheckPool -- FINALIZE TRANSACTIONS\n");
+        LogPrint("privatesend", "CPrivateSendServerSession::CheckPool -- FINALIZE TRANSACTIONS\n");
         CreateFinalTransaction(connman);
         return;
     }
+}
 
-    // If we have all of the signatures, try to compile the transaction
-    if (nState == POOL_STATE_SIGNING && IsSignaturesComplete()) {
-        LogPrint("privatesend", "CPrivateSendServer::CheckPool -- SIGNING\n");
-        CommitFinalTransaction(connman);
-        return;
+bool CPrivateSendServerSession::AddScriptSigs(const std::vector<CTxIn>& vecTxIn, CConnman& connman)
+{
+    int nTxInIndex = 0;
+    int nTxInsCount = (int)vecTxIn.size();
+
+    for (const auto& txin : vecTxIn) {
+        nTxInIndex++;
+        if (!AddScriptSig(txin)) {
+            LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSig() failed at %d/%d, session: %d\n", nTxInIndex, nTxInsCount, nSessionID);
+            RelayStatus(STATUS_REJECTED, connman);
+            return false;
+        }
+        LogPrint("privatesend", "DSSIGNFINALTX -- AddScriptSig() %d/%d success\n", nTxInIndex, nTxInsCount);
     }
+
+    return true;
 }
 
-void CPrivateSendServer::CreateFinalTransaction(CConnman& connman)
+bool CPrivateSendServerSession::IsReadyToCommit()
 {
-    LogPrint("privatesend", "CPrivateSendServer::CreateFinalTransaction -- FINALIZE TRANSACTIONS\n");
+    return nState == POOL_STATE_SIGNING && IsSignaturesComplete();
+}
+
+void CPrivateSendServerSession::CreateFinalTransaction(CConnman& connman)
+{
+    LogPrint("privatesend", "CPrivateSendServerSession::CreateFinalTransaction -- FINALIZE TRANSACTIONS\n");
 
     CMutableTransaction txNew;
 
@@ -340,29 +775,29 @@ void CPrivateSendServer::CreateFinalTransaction(CConnman& connman)
     sort(txNew.vout.begin(), txNew.vout.end(), CompareOutputBIP69());
 
     finalMutableTransaction = txNew;
-    LogPrint("privatesend", "CPrivateSendServer::CreateFinalTransaction -- finalMutableTransaction=%s", txNew.ToString());
+    LogPrint("privatesend", "CPrivateSendServerSession::CreateFinalTransaction -- finalMutableTransaction=%s", txNew.ToString());
 
     // request signatures from clients
     SetState(POOL_STATE_SIGNING);
     RelayFinalTransaction(finalMutableTransaction, connman);
 }
 
-void CPrivateSendServer::CommitFinalTransaction(CConnman& connman)
+void CPrivateSendServerSession::CommitFinalTransaction(CConnman& connman)
 {
     if (!fMasternodeMode) return; // check and relay final tx only on masternode
 
     CTransactionRef finalTransaction = MakeTransactionRef(finalMutableTransaction);
     uint256 hashTx = finalTransaction->GetHash();
 
-    LogPrint("privatesend", "CPrivateSendServer::CommitFinalTransaction -- finalTransaction=%s", finalTransaction->ToString());
+    LogPrint("privatesend", "CPrivateSendServerSession::CommitFinalTransaction -- finalTransaction=%s", finalTransaction->ToString());
 
     {
         // See if the transaction is valid
-        TRY_LOCK(cs_main, lockMain);
+        LOCK(cs_main);
         CValidationState validationState;
         mempool.PrioritiseTransaction(hashTx, 0.1 * COIN);
-        if (!lockMain || !AcceptToMemoryPool(mempool, validationState, finalTransaction, false, NULL, false, maxTxFee, true)) {
-            LogPrintf("CPrivateSendServer::CommitFinalTransaction -- AcceptToMemoryPool() error: Transaction not valid\n");
+        if (!AcceptToMemoryPool(mempool, validationState, finalTransaction, false, NULL, false, maxTxFee, true)) {
+            LogPrintf("CPrivateSendServerSession::CommitFinalTransaction -- AcceptToMemoryPool() error: Transaction not valid\n");
             SetNull();
             // not much we can do in this case, just notify clients
             RelayCompletedTransaction(ERR_INVALID_TX, connman);
@@ -370,7 +805,7 @@ void CPrivateSendServer::CommitFinalTransaction(CConnman& connman)
         }
     }
 
-    LogPrintf("CPrivateSendServer::CommitFinalTransaction -- CREATING DSTX\n");
+    LogPrintf("CPrivateSendServerSession::CommitFinalTransaction -- CREATING DSTX\n");
 
     // create and sign masternode dstx transaction
     if (!CPrivateSend::GetDSTX(hashTx)) {
@@ -379,7 +814,7 @@ void CPrivateSendServer::CommitFinalTransaction(CConnman& connman)
         CPrivateSend::AddDSTX(dstxNew);
     }
 
-    LogPrintf("CPrivateSendServer::CommitFinalTransaction -- TRANSMITTING DSTX\n");
+    LogPrintf("CPrivateSendServerSession::CommitFinalTransaction -- TRANSMITTING DSTX\n");
 
     CInv inv(MSG_DSTX, hashTx);
     connman.RelayInv(inv);
@@ -391,7 +826,7 @@ void CPrivateSendServer::CommitFinalTransaction(CConnman& connman)
     ChargeRandomFees(connman);
 
     // Reset
-    LogPrint("privatesend", "CPrivateSendServer::CommitFinalTransaction -- COMPLETED -- RESETTING\n");
+    LogPrint("privatesend", "CPrivateSendServerSession::CommitFinalTransaction -- COMPLETED -- RESETTING\n");
     SetNull();
 }
 
@@ -407,7 +842,7 @@ void CPrivateSendServer::CommitFinalTransaction(CConnman& connman)
 // transaction for the client to be able to enter the pool. This transaction is kept by the Masternode
 // until the transaction is either complete or fails.
 //
-void CPrivateSendServer::ChargeFees(CConnman& connman)
+void CPrivateSendServerSession::ChargeFees(CConnman& connman)
 {
     if (!fMasternodeMode) return;
 
@@ -425,7 +860,7 @@ void CPrivateSendServer::ChargeFees(CConnman& connman)
 
             // This queue entry didn't send us the promised transaction
             if (!fFound) {
-                LogPrintf("CPrivateSendServer::ChargeFees -- found uncooperative node (didn't send transaction), found offence\n");
+                LogPrintf("CPrivateSendServerSession::ChargeFees -- found uncooperative node (didn't send transaction), found offence\n");
                 vecOffendersCollaterals.push_back(txCollateral);
             }
         }
@@ -436,7 +871,7 @@ void CPrivateSendServer::ChargeFees(CConnman& connman)
         for (const auto& entry : vecEntries) {
             for (const auto& txdsin : entry.vecTxDSIn) {
                 if (!txdsin.fHasSig) {
-                    LogPrintf("CPrivateSendServer::ChargeFees -- found uncooperative node (didn't sign), found offence\n");
+                    LogPrintf("CPrivateSendServerSession::ChargeFees -- found uncooperative node (didn't sign), found offence\n");
                     vecOffendersCollaterals.push_back(entry.txCollateral);
                 }
             }
@@ -456,7 +891,7 @@ void CPrivateSendServer::ChargeFees(CConnman& connman)
     std::random_shuffle(vecOffendersCollaterals.begin(), vecOffendersCollaterals.end());
 
     if (nState == POOL_STATE_ACCEPTING_ENTRIES || nState == POOL_STATE_SIGNING) {
-        LogPrintf("CPrivateSendServer::ChargeFees -- found uncooperative node (didn't %s transaction), charging fees: %s",
+        LogPrintf("CPrivateSendServerSession::ChargeFees -- found uncooperative node (didn't %s transaction), charging fees: %s",
             (nState == POOL_STATE_SIGNING) ? "sign" : "send", vecOffendersCollaterals[0]->ToString());
 
         LOCK(cs_main);
@@ -464,7 +899,7 @@ void CPrivateSendServer::ChargeFees(CConnman& connman)
         CValidationState state;
         if (!AcceptToMemoryPool(mempool, state, vecOffendersCollaterals[0], false, NULL, false, maxTxFee)) {
             // should never really happen
-            LogPrintf("CPrivateSendServer::ChargeFees -- ERROR: AcceptToMemoryPool failed!\n");
+            LogPrintf("CPrivateSendServerSession::ChargeFees -- ERROR: AcceptToMemoryPool failed!\n");
         } else {
             connman.RelayTransaction(*vecOffendersCollaterals[0]);
         }
@@ -483,7 +918,7 @@ void CPrivateSendServer::ChargeFees(CConnman& connman)
     stop these kinds of attacks 1 in 10 successful transactions are charged. This
     adds up to a cost of 0.001DRK per transaction on average.
 */
-void CPrivateSendServer::ChargeRandomFees(CConnman& connman)
+void CPrivateSendServerSession::ChargeRandomFees(CConnman& connman)
 {
     if (!fMasternodeMode) return;
 
@@ -491,12 +926,12 @@ void CPrivateSendServer::ChargeRandomFees(CConnman& connman)
 
     for (const auto& txCollateral : vecSessionCollaterals) {
         if (GetRandInt(100) > 10) return;
-        LogPrintf("CPrivateSendServer::ChargeRandomFees -- charging random fees, txCollateral=%s", txCollateral->ToString());
+        LogPrintf("CPrivateSendServerSession::ChargeRandomFees -- charging random fees, txCollateral=%s", txCollateral->ToString());
 
         CValidationState state;
         if (!AcceptToMemoryPool(mempool, state, txCollateral, false, NULL, false, maxTxFee)) {
             // Can happen if this collateral belongs to some misbehaving participant we punished earlier
-            LogPrintf("CPrivateSendServer::ChargeRandomFees -- ERROR: AcceptToMemoryPool failed!\n");
+            LogPrintf("CPrivateSendServerSession::ChargeRandomFees -- ERROR: AcceptToMemoryPool failed!\n");
         } else {
             connman.RelayTransaction(*txCollateral);
         }
@@ -506,12 +941,10 @@ void CPrivateSendServer::ChargeRandomFees(CConnman& connman)
 //
 // Check for various timeouts (queue objects, mixing, etc)
 //
-void CPrivateSendServer::CheckTimeout(CConnman& connman)
+void CPrivateSendServerSession::CheckTimeout(CConnman& connman)
 {
     if (!fMasternodeMode) return;
 
-    CheckQueue();
-
     if (nState == POOL_STATE_IDLE) return;
 
     int nTimeout = (nState == POOL_STATE_SIGNING) ? PRIVATESEND_SIGNING_TIMEOUT : PRIVATESEND_QUEUE_TIMEOUT;
@@ -522,14 +955,14 @@ void CPrivateSendServer::CheckTimeout(CConnman& connman)
 
     // See if we have at least min number of participants, if so - we can still do smth
     if (nState == POOL_STATE_QUEUE && vecSessionCollaterals.size() >= CPrivateSend::GetMinPoolParticipants()) {
-        LogPrint("privatesend", "CPrivateSendServer::CheckTimeout -- Queue for %d participants timed out (%ds) -- falling back to %d participants\n",
+        LogPrint("privatesend", "CPrivateSendServerSession::CheckTimeout -- Queue for %d participants timed out (%ds) -- falling back to %d participants\n",
             nSessionMaxParticipants, nTimeout, vecSessionCollaterals.size());
         nSessionMaxParticipants = vecSessionCollaterals.size();
         return;
     }
 
     if (nState == POOL_STATE_ACCEPTING_ENTRIES && GetEntriesCount() >= CPrivateSend::GetMinPoolParticipants()) {
-        LogPrint("privatesend", "CPrivateSendServer::CheckTimeout -- Accepting entries for %d participants timed out (%ds) -- falling back to %d participants\n",
+        LogPrint("privatesend", "CPrivateSendServerSession::CheckTimeout -- Accepting entries for %d participants timed out (%ds) -- falling back to %d participants\n",
             nSessionMaxParticipants, nTimeout, GetEntriesCount());
         // Punish misbehaving participants
         ChargeFees(connman);
@@ -540,7 +973,7 @@ void CPrivateSendServer::CheckTimeout(CConnman& connman)
     }
 
     // All other cases
-    LogPrint("privatesend", "CPrivateSendServer::CheckTimeout -- %s timed out (%ds) -- resetting\n",
+    LogPrint("privatesend", "CPrivateSendServerSession::CheckTimeout -- %s timed out (%ds) -- resetting\n",
         (nState == POOL_STATE_SIGNING) ? "Signing" : "Session", nTimeout);
     ChargeFees(connman);
     SetNull();
@@ -551,22 +984,26 @@ void CPrivateSendServer::CheckTimeout(CConnman& connman)
     After receiving multiple dsa messages, the queue will switch to "accepting entries"
     which is the active state right before merging the transaction
 */
-void CPrivateSendServer::CheckForCompleteQueue(CConnman& connman)
+bool CPrivateSendServerSession::CheckForCompleteQueue(CPrivateSendQueue& dsqRet)
 {
-    if (!fMasternodeMode) return;
+    if (!fMasternodeMode) return false;
 
     if (nState == POOL_STATE_QUEUE && IsSessionReady()) {
         SetState(POOL_STATE_ACCEPTING_ENTRIES);
 
-        CPrivateSendQueue dsq(nSessionDenom, activeMasternodeInfo.outpoint, GetAdjustedTime(), true);
-        LogPrint("privatesend", "CPrivateSendServer::CheckForCompleteQueue -- queue is ready, signing and relaying (%s)\n", dsq.ToString());
-        dsq.Sign();
-        dsq.Relay(connman);
+        dsqRet = CPrivateSendQueue(nSessionDenom, activeMasternodeInfo.outpoint, GetAdjustedTime(), true);
+        LogPrint("privatesend", "CPrivateSendServerSession::CheckForCompleteQueue -- queue is ready, signing (%s)\n", dsqRet.ToString());
+        if (!fUnitTest) {
+            dsqRet.Sign();
+        }
+        return true;
     }
+
+    return false;
 }
 
 // Check to make sure a given input matches an input in the pool and its scriptSig is valid
-bool CPrivateSendServer::IsInputScriptSigValid(const CTxIn& txin)
+bool CPrivateSendServerSession::IsInputScriptSigValid(const CTxIn& txin)
 {
     CMutableTransaction txNew;
     txNew.vin.clear();
@@ -593,43 +1030,36 @@ bool CPrivateSendServer::IsInputScriptSigValid(const CTxIn& txin)
 
     if (nTxInIndex >= 0) { //might have to do this one input at a time?
         txNew.vin[nTxInIndex].scriptSig = txin.scriptSig;
-        LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- verifying scriptSig %s\n", ScriptToAsmStr(txin.scriptSig).substr(0, 24));
+        LogPrint("privatesend", "CPrivateSendServerSession::IsInputScriptSigValid -- verifying scriptSig %s\n", ScriptToAsmStr(txin.scriptSig).substr(0, 24));
         if (!VerifyScript(txNew.vin[nTxInIndex].scriptSig, sigPubKey, SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_STRICTENC, MutableTransactionSignatureChecker(&txNew, nTxInIndex))) {
-            LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- VerifyScript() failed on input %d\n", nTxInIndex);
+            LogPrint("privatesend", "CPrivateSendServerSession::IsInputScriptSigValid -- VerifyScript() failed on input %d\n", nTxInIndex);
             return false;
         }
     } else {
-        LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- Failed to find matching input in pool, %s\n", txin.ToString());
+        LogPrint("privatesend", "CPrivateSendServerSession::IsInputScriptSigValid -- Failed to find matching input in pool, %s\n", txin.ToString());
         return false;
     }
 
-    LogPrint("privatesend", "CPrivateSendServer::IsInputScriptSigValid -- Successfully validated input and scriptSig\n");
+    LogPrint("privatesend", "CPrivateSendServerSession::IsInputScriptSigValid -- Successfully validated input and scriptSig\n");
     return true;
 }
 
 //
 // Add a clients transaction to the pool
 //
-bool CPrivateSendServer::AddEntry(const CPrivateSendEntry& entryNew, PoolMessage& nMessageIDRet)
+bool CPrivateSendServerSession::AddEntry(const CPrivateSendEntry& entryNew, PoolMessage& nMessageIDRet)
 {
     if (!fMasternodeMode) return false;
 
-    for (const auto& txin : entryNew.vecTxDSIn) {
-        if (txin.prevout.IsNull()) {
-            LogPrint("privatesend", "CPrivateSendServer::AddEntry -- input not valid!\n");
-            nMessageIDRet = ERR_INVALID_INPUT;
-            return false;
-        }
-    }
-
-    if (!CPrivateSend::IsCollateralValid(*entryNew.txCollateral)) {
-        LogPrint("privatesend", "CPrivateSendServer::AddEntry -- collateral not valid!\n");
-        nMessageIDRet = ERR_INVALID_COLLATERAL;
+    // the session could have timed out or moved on while the entry was validated
+    if (nState != POOL_STATE_ACCEPTING_ENTRIES) {
+        LogPrint("privatesend", "CPrivateSendServerSession::AddEntry -- incompatible mode: nState=%d\n", nState);
+        nMessageIDRet = ERR_MODE;
         return false;
     }
 
     if (GetEntriesCount() >= nSessionMaxParticipants) {
-        LogPrint("privatesend", "CPrivateSendServer::AddEntry -- entries is full!\n");
+        LogPrint("privatesend", "CPrivateSendServerSession::AddEntry -- entries is full!\n");
         nMessageIDRet = ERR_ENTRIES_FULL;
         return false;
     }
@@ -639,7 +1069,7 @@ bool CPrivateSendServer::AddEntry(const CPrivateSendEntry& entryNew, PoolMessage
         for (const auto& entry : vecEntries) {
             for (const auto& txdsin : entry.vecTxDSIn) {
                 if (txdsin.prevout == txin.prevout) {
-                    LogPrint("privatesend", "CPrivateSendServer::AddEntry -- found in txin\n");
+                    LogPrint("privatesend", "CPrivateSendServerSession::AddEntry -- found in txin\n");
                     nMessageIDRet = ERR_ALREADY_HAVE;
                     return false;
                 }
@@ -649,51 +1079,51 @@ bool CPrivateSendServer::AddEntry(const CPrivateSendEntry& entryNew, PoolMessage
 
     vecEntries.push_back(entryNew);
 
-    LogPrint("privatesend", "CPrivateSendServer::AddEntry -- adding entry %d of %d required\n", GetEntriesCount(), nSessionMaxParticipants);
+    LogPrint("privatesend", "CPrivateSendServerSession::AddEntry -- adding entry %d of %d required\n", GetEntriesCount(), nSessionMaxParticipants);
     nMessageIDRet = MSG_ENTRIES_ADDED;
 
     return true;
 }
 
-bool CPrivateSendServer::AddScriptSig(const CTxIn& txinNew)
+bool CPrivateSendServerSession::AddScriptSig(const CTxIn& txinNew)
 {
-    LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+    LogPrint("privatesend", "CPrivateSendServerSession::AddScriptSig -- scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
 
     for (const auto& entry : vecEntries) {
         for (const auto& txdsin : entry.vecTxDSIn) {
             if (txdsin.scriptSig == txinNew.scriptSig) {
-                LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- already exists\n");
+                LogPrint("privatesend", "CPrivateSendServerSession::AddScriptSig -- already exists\n");
                 return false;
             }
         }
     }
 
     if (!IsInputScriptSigValid(txinNew)) {
-        LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- Invalid scriptSig\n");
+        LogPrint("privatesend", "CPrivateSendServerSession::AddScriptSig -- Invalid scriptSig\n");
         return false;
     }
 
-    LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- scriptSig=%s new\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+    LogPrint("privatesend", "CPrivateSendServerSession::AddScriptSig -- scriptSig=%s new\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
 
     for (auto& txin : finalMutableTransaction.vin) {
         if (txin.prevout == txinNew.prevout && txin.nSequence == txinNew.nSequence) {
             txin.scriptSig = txinNew.scriptSig;
-            LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- adding to finalMutableTransaction, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+            LogPrint("privatesend", "CPrivateSendServerSession::AddScriptSig -- adding to finalMutableTransaction, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
         }
     }
     for (int i = 0; i < GetEntriesCount(); i++) {
         if (vecEntries[i].AddScriptSig(txinNew)) {
-            LogPrint("privatesend", "CPrivateSendServer::AddScriptSig -- adding to entries, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
+            LogPrint("privatesend", "CPrivateSendServerSession::AddScriptSig -- adding to entries, scriptSig=%s\n", ScriptToAsmStr(txinNew.scriptSig).substr(0, 24));
             return true;
         }
     }
 
-    LogPrintf("CPrivateSendServer::AddScriptSig -- Couldn't set sig!\n");
+    LogPrintf("CPrivateSendServerSession::AddScriptSig -- Couldn't set sig!\n");
     return false;
 }
 
 // Check to make sure everything is signed
-bool CPrivateSendServer::IsSignaturesComplete()
+bool CPrivateSendServerSession::IsSignaturesComplete()
 {
     for (const auto& entry : vecEntries)
         for (const auto& txdsin : entry.vecTxDSIn)
@@ -702,12 +1132,12 @@ bool CPrivateSendServer::IsSignaturesComplete()
     return true;
 }
 
-bool CPrivateSendServer::IsOutputsCompatibleWithSessionDenom(const std::vector<CTxOut>& vecTxOut)
+bool CPrivateSendServerSession::IsOutputsCompatibleWithSessionDenom(const std::vector<CTxOut>& vecTxOut)
 {
     if (CPrivateSend::GetDenominations(vecTxOut) == 0) return false;
 
     for (const auto& entry : vecEntries) {
-        LogPrintf("CPrivateSendServer::IsOutputsCompatibleWithSessionDenom -- vecTxOut denom %d, entry.vecTxOut denom %d\n",
+        LogPrintf("CPrivateSendServerSession::IsOutputsCompatibleWithSessionDenom -- vecTxOut denom %d, entry.vecTxOut denom %d\n",
             CPrivateSend::GetDenominations(vecTxOut), CPrivateSend::GetDenominations(entry.vecTxOut));
         if (CPrivateSend::GetDenominations(vecTxOut) != CPrivateSend::GetDenominations(entry.vecTxOut)) return false;
     }
@@ -715,84 +1145,53 @@ bool CPrivateSendServer::IsOutputsCompatibleWithSessionDenom(const std::vector<C
     return true;
 }
 
-bool CPrivateSendServer::IsAcceptableDSA(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet)
-{
-    if (!fMasternodeMode) return false;
-
-    // is denom even smth legit?
-    std::vector<int> vecBits;
-    if (!CPrivateSend::GetDenominationsBits(dsa.nDenom, vecBits)) {
-        LogPrint("privatesend", "CPrivateSendServer::%s -- denom not valid!\n", __func__);
-        nMessageIDRet = ERR_DENOM;
-        return false;
-    }
-
-    // check collateral
-    if (!fUnitTest && !CPrivateSend::IsCollateralValid(dsa.txCollateral)) {
-        LogPrint("privatesend", "CPrivateSendServer::%s -- collateral not valid!\n", __func__);
-        nMessageIDRet = ERR_INVALID_COLLATERAL;
-        return false;
-    }
-
-    return true;
-}
-
-bool CPrivateSendServer::CreateNewSession(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet, CConnman& connman)
+bool CPrivateSendServerSession::CreateNewSession(int nSessionIDIn, const CPrivateSendAccept& dsa, bool fRelayQueue, PoolMessage& nMessageIDRet, CConnman& connman, CPrivateSendQueue& dsqRet)
 {
     if (!fMasternodeMode || nSessionID != 0) return false;
 
     // new session can only be started in idle mode
     if (nState != POOL_STATE_IDLE) {
         nMessageIDRet = ERR_MODE;
-        LogPrintf("CPrivateSendServer::CreateNewSession -- incompatible mode: nState=%d\n", nState);
-        return false;
-    }
-
-    if (!IsAcceptableDSA(dsa, nMessageIDRet)) {
+        LogPrintf("CPrivateSendServerSession::CreateNewSession -- incompatible mode: nState=%d\n", nState);
         return false;
     }
 
     // start new session
     nMessageIDRet = MSG_NOERR;
-    nSessionID = GetRandInt(999999) + 1;
+    nSessionID = nSessionIDIn;
     nSessionDenom = dsa.nDenom;
     nSessionMaxParticipants = CPrivateSend::GetMinPoolParticipants() + GetRandInt(CPrivateSend::GetMaxPoolParticipants() - CPrivateSend::GetMinPoolParticipants() + 1);
 
     SetState(POOL_STATE_QUEUE);
 
-    if (!fUnitTest) {
+    if (!fUnitTest && fRelayQueue) {
         //broadcast that I'm accepting entries, only if it's the first entry through
-        CPrivateSendQueue dsq(nSessionDenom, activeMasternodeInfo.outpoint, GetAdjustedTime(), false);
-        LogPrint("privatesend", "CPrivateSendServer::CreateNewSession -- signing and relaying new queue: %s\n", dsq.ToString());
-        dsq.Sign();
-        dsq.Relay(connman);
-        vecPrivateSendQueue.push_back(dsq);
+        dsqRet = CPrivateSendQueue(nSessionDenom, activeMasternodeInfo.outpoint, GetAdjustedTime(), false);
+        LogPrint("privatesend", "CPrivateSendServerSession::CreateNewSession -- signing and relaying new queue: %s\n", dsqRet.ToString());
+        dsqRet.Sign();
+        dsqRet.Relay(connman);
     }
 
     vecSessionCollaterals.push_back(MakeTransactionRef(dsa.txCollateral));
-    LogPrintf("CPrivateSendServer::CreateNewSession -- new session created, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  nSessionMaxParticipants: %d\n",
+    LogPrintf("CPrivateSendServerSession::CreateNewSession -- new session created, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  nSessionMaxParticipants: %d\n",
         nSessionID, nSessionDenom, CPrivateSend::GetDenominationsToString(nSessionDenom), vecSessionCollaterals.size(), nSessionMaxParticipants);
 
     return true;
 }
 
-bool CPrivateSendServer::AddUserToExistingSession(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet)
+bool CPrivateSendServerSession::AddUserToExistingSession(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet)
 {
     if (!fMasternodeMode || nSessionID == 0 || IsSessionReady()) return false;
 
-    if (!IsAcceptableDSA(dsa, nMessageIDRet)) {
-        return false;
-    }
-
     // we only add new users to an existing session when we are in queue mode
     if (nState != POOL_STATE_QUEUE) {
         nMessageIDRet = ERR_MODE;
-        LogPrintf("CPrivateSendServer::AddUserToExistingSession -- incompatible mode: nState=%d\n", nState);
+        LogPrintf("CPrivateSendServerSession::AddUserToExistingSession -- incompatible mode: nState=%d\n", nState);
         return false;
     }
 
     if (dsa.nDenom != nSessionDenom) {
-        LogPrintf("CPrivateSendServer::AddUserToExistingSession -- incompatible denom %d (%s) != nSessionDenom %d (%s)\n",
+        LogPrintf("CPrivateSendServerSession::AddUserToExistingSession -- incompatible denom %d (%s) != nSessionDenom %d (%s)\n",
             dsa.nDenom, CPrivateSend::GetDenominationsToString(dsa.nDenom), nSessionDenom, CPrivateSend::GetDenominationsToString(nSessionDenom));
         nMessageIDRet = ERR_DENOM;
         return false;
@@ -803,20 +1202,20 @@ bool CPrivateSendServer::AddUserToExistingSession(const CPrivateSendAccept& dsa,
     nMessageIDRet = MSG_NOERR;
     vecSessionCollaterals.push_back(MakeTransactionRef(dsa.txCollateral));
 
-    LogPrintf("CPrivateSendServer::AddUserToExistingSession -- new user accepted, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  nSessionMaxParticipants: %d\n",
+    LogPrintf("CPrivateSendServerSession::AddUserToExistingSession -- new user accepted, nSessionID: %d  nSessionDenom: %d (%s)  vecSessionCollaterals.size(): %d  nSessionMaxParticipants: %d\n",
         nSessionID, nSessionDenom, CPrivateSend::GetDenominationsToString(nSessionDenom), vecSessionCollaterals.size(), nSessionMaxParticipants);
 
     return true;
 }
 
-bool CPrivateSendServer::IsSessionReady()
+bool CPrivateSendServerSession::IsSessionReady()
 {
     return nSessionMaxParticipants != 0 && (int)vecSessionCollaterals.size() >= nSessionMaxParticipants;
 }
 
-void CPrivateSendServer::RelayFinalTransaction(const CTransaction& txFinal, CConnman& connman)
+void CPrivateSendServerSession::RelayFinalTransaction(const CTransaction& txFinal, CConnman& connman)
 {
-    LogPrint("privatesend", "CPrivateSendServer::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
+    LogPrint("privatesend", "CPrivateSendServerSession::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
         __func__, nSessionID, nSessionDenom, CPrivateSend::GetDenominationsToString(nSessionDenom));
 
     // final mixing tx with empty signatures should be relayed to mixing participants only
@@ -834,14 +1233,14 @@ void CPrivateSendServer::RelayFinalTransaction(const CTransaction& txFinal, CCon
     }
 }
 
-void CPrivateSendServer::PushStatus(CNode* pnode, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID, CConnman& connman)
+void CPrivateSendServerSession::PushStatus(CNode* pnode, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID, CConnman& connman)
 {
     if (!pnode) return;
     CNetMsgMaker msgMaker(pnode->GetSendVersion());
     connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DSSTATUSUPDATE, nSessionID, (int)nState, (int)vecEntries.size(), (int)nStatusUpdate, (int)nMessageID));
 }
 
-void CPrivateSendServer::RelayStatus(PoolStatusUpdate nStatusUpdate, CConnman& connman, PoolMessage nMessageID)
+void CPrivateSendServerSession::RelayStatus(PoolStatusUpdate nStatusUpdate, CConnman& connman, PoolMessage nMessageID)
 {
     unsigned int nDisconnected{};
     // status updates should be relayed to mixing participants only
@@ -859,7 +1258,7 @@ void CPrivateSendServer::RelayStatus(PoolStatusUpdate nStatusUpdate, CConnman& c
     if (nDisconnected == 0) return; // all is clear
 
     // smth went wrong
-    LogPrintf("CPrivateSendServer::%s -- can't continue, %llu client(s) disconnected, nSessionID: %d  nSessionDenom: %d (%s)\n",
+    LogPrintf("CPrivateSendServerSession::%s -- can't continue, %llu client(s) disconnected, nSessionID: %d  nSessionDenom: %d (%s)\n",
         __func__, nDisconnected, nSessionID, nSessionDenom, CPrivateSend::GetDenominationsToString(nSessionDenom));
 
     // notify everyone else that this session should be terminated
@@ -877,9 +1276,9 @@ void CPrivateSendServer::RelayStatus(PoolStatusUpdate nStatusUpdate, CConnman& c
     }
 }
 
-void CPrivateSendServer::RelayCompletedTransaction(PoolMessage nMessageID, CConnman& connman)
+void CPrivateSendServerSession::RelayCompletedTransaction(PoolMessage nMessageID, CConnman& connman)
 {
-    LogPrint("privatesend", "CPrivateSendServer::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
+    LogPrint("privatesend", "CPrivateSendServerSession::%s -- nSessionID: %d  nSessionDenom: %d (%s)\n",
         __func__, nSessionID, nSessionDenom, CPrivateSend::GetDenominationsToString(nSessionDenom));
 
     // final mixing tx with empty signatures should be relayed to mixing participants only
@@ -897,28 +1296,16 @@ void CPrivateSendServer::RelayCompletedTransaction(PoolMessage nMessageID, CConn
     }
 }
 
-void CPrivateSendServer::SetState(PoolState nStateNew)
+void CPrivateSendServerSession::SetState(PoolState nStateNew)
 {
     if (!fMasternodeMode) return;
 
     if (nStateNew == POOL_STATE_ERROR || nStateNew == POOL_STATE_SUCCESS) {
-        LogPrint("privatesend", "CPrivateSendServer::SetState -- Can't set state to ERROR or SUCCESS as a Masternode. \n");
+        LogPrint("privatesend", "CPrivateSendServerSession::SetState -- Can't set state to ERROR or SUCCESS as a Masternode. \n");
         return;
     }
 
-    LogPrintf("CPrivateSendServer::SetState -- nState: %d, nStateNew: %d\n", nState, nStateNew);
+    LogPrintf("CPrivateSendServerSession::SetState -- nState: %d, nStateNew: %d\n", nState, nStateNew);
     nTimeLastSuccessfulStep = GetTime();
     nState = nStateNew;
 }
-
-void CPrivateSendServer::DoMaintenance(CConnman& connman)
-{
-    if (fLiteMode) return;        // disable all Dash specific functionality
-    if (!fMasternodeMode) return; // only run on masternodes
-
-    if (!masternodeSync.IsBlockchainSynced() || ShutdownRequested())
-        return;
-
-    privateSendServer.CheckTimeout(connman);
-    privateSendServer.CheckForCompleteQueue(connman);
-}
@@ -7,15 +7,27 @@
 
 #include "net.h"
 #include "privatesend.h"
+#include "threadinterrupt.h"
+
+#include <univalue.h>
+
+#include <deque>
+#include <memory>
+#include <thread>
 
 class CPrivateSendServer;
 
+// How many mixing sessions a masternode runs at the same time
+static const int MAX_PRIVATESEND_SERVER_SESSIONS = 5;
+// How many entries can wait for validation before new ones are rejected
+static const size_t MAX_PENDING_PRIVATESEND_ENTRIES = 100;
+
 // The main object for accessing mixing
 extern CPrivateSendServer privateSendServer;
 
-/** Used to keep track of current status of mixing pool
+/** Used to keep track of current status of a single mixing session
  */
-class CPrivateSendServer : public CPrivateSendBaseSession, public CPrivateSendBaseManager
+class CPrivateSendServerSession : public CPrivateSendBaseSession
 {
 private:
     // Mixing uses collateral transactions to trust parties entering the pool
@@ -27,8 +39,6 @@ private:
 
     bool fUnitTest;
 
-    /// Add a clients entry to the pool
-    bool AddEntry(const CPrivateSendEntry& entryNew, PoolMessage& nMessageIDRet);
     /// Add signature to a txin
     bool AddScriptSig(const CTxIn& txin);
 
@@ -37,45 +47,126 @@ private:
     /// Rarely charge fees to pay miners
     void ChargeRandomFees(CConnman& connman);
 
-    /// Check for process
-    void CheckPool(CConnman& connman);
-
     void CreateFinalTransaction(CConnman& connman);
-    void CommitFinalTransaction(CConnman& connman);
-
-    /// Is this nDenom and txCollateral acceptable?
-    bool IsAcceptableDSA(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet);
-    bool CreateNewSession(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet, CConnman& connman);
-    bool AddUserToExistingSession(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet);
-    /// Do we have enough users to take entries?
-    bool IsSessionReady();
 
     /// Check that all inputs are signed. (Are all inputs signed?)
     bool IsSignaturesComplete();
     /// Check to make sure a given input matches an input in the pool and its scriptSig is valid
     bool IsInputScriptSigValid(const CTxIn& txin);
-    /// Are these outputs compatible with other client in the pool?
-    bool IsOutputsCompatibleWithSessionDenom(const std::vector<CTxOut>& vecTxOut);
 
     // Set the 'state' value, with some logging and capturing when the state changed
     void SetState(PoolState nStateNew);
 
     /// Relay mixing Messages
     void RelayFinalTransaction(const CTransaction& txFinal, CConnman& connman);
+    void RelayCompletedTransaction(PoolMessage nMessageID, CConnman& connman);
+
+public:
+    explicit CPrivateSendServerSession(bool fUnitTestIn = false) :
+        vecSessionCollaterals(),
+        nSessionMaxParticipants(0),
+        fUnitTest(fUnitTestIn) {}
+
+    CCriticalSection& GetLock() const { return cs_privatesend; }
+    int GetSessionID() const { return nSessionID; }
+
+    /// Start the session, the queue is only announced if fRelayQueue is set (and returned in dsqRet then)
+    bool CreateNewSession(int nSessionIDIn, const CPrivateSendAccept& dsa, bool fRelayQueue, PoolMessage& nMessageIDRet, CConnman& connman, CPrivateSendQueue& dsqRet);
+    bool AddUserToExistingSession(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet);
+    /// Do we have enough users to take entries?
+    bool IsSessionReady();
+    /// Are these outputs compatible with other client in the pool?
+    bool IsOutputsCompatibleWithSessionDenom(const std::vector<CTxOut>& vecTxOut);
+    /// Add a clients entry to the pool
+    bool AddEntry(const CPrivateSendEntry& entryNew, PoolMessage& nMessageIDRet);
+    bool AddScriptSigs(const std::vector<CTxIn>& vecTxIn, CConnman& connman);
+
+    /// Check for process
+    void CheckPool(CConnman& connman);
+    /// Are all signatures collected and the final transaction ready to be committed?
+    bool IsReadyToCommit();
+    void CommitFinalTransaction(CConnman& connman);
+
+    void CheckTimeout(CConnman& connman);
+    /// Start accepting entries when enough users joined, returns the signed ready queue for the participants then
+    bool CheckForCompleteQueue(CPrivateSendQueue& dsqRet);
+
     void PushStatus(CNode* pnode, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID, CConnman& connman);
     void RelayStatus(PoolStatusUpdate nStatusUpdate, CConnman& connman, PoolMessage nMessageID = MSG_NOERR);
-    void RelayCompletedTransaction(PoolMessage nMessageID, CConnman& connman);
 
     void SetNull();
+};
+
+/** Runs the mixing sessions of a masternode
+ *
+ * Up to MAX_PRIVATESEND_SERVER_SESSIONS sessions run independently of each other. Participants are mapped to their
+ * session when their DSACCEPT is accepted and all their later messages are routed to that session.
+ * Entries (DSVIN) are only checked for consistency on the message thread, the expensive validation of their inputs
+ * and collaterals and the commit of final transactions happen on a worker thread.
+ */
+class CPrivateSendServer : public CPrivateSendBaseManager
+{
+private:
+    struct PendingEntry {
+        int nSessionID;
+        NodeId nodeId;
+        CPrivateSendEntry entry;
+    };
+
+    mutable CCriticalSection cs_sessions;
+    std::map<int, std::shared_ptr<CPrivateSendServerSession> > mapSessions;
+    std::map<NodeId, int> mapPeerSessions;
+    // Inputs of accepted entries of all sessions (and the session they belong to). An input can only be mixed in one
+    // session at a time, otherwise all but one final transaction would fail
+    std::map<COutPoint, int> mapReservedPrevouts;
+
+    CCriticalSection cs_pending;
+    std::deque<PendingEntry> deqPendingEntries;
+    std::set<int> setSessionsToCommit;
+
+    std::thread workThread;
+    CThreadInterrupt workInterrupt;
+
+    bool fUnitTest;
+
+    std::shared_ptr<CPrivateSendServerSession> GetSession(int nSessionID) const;
+    std::shared_ptr<CPrivateSendServerSession> GetPeerSession(NodeId nodeId) const;
+    std::vector<std::shared_ptr<CPrivateSendServerSession> > GetSessions() const;
+    // Removes sessions which completed or were reset, their participants and their reserved inputs
+    void CleanupSessions();
+    // Returns false if any input of the entry is reserved already, reserves all of them otherwise
+    bool ReservePrevouts(int nSessionID, const CPrivateSendEntry& entry);
+    void ReleasePrevouts(int nSessionID, const CPrivateSendEntry& entry);
+
+    /// Is this nDenom and txCollateral acceptable?
+    bool IsAcceptableDSA(const CPrivateSendAccept& dsa, PoolMessage& nMessageIDRet);
+
+    void ProcessDSACCEPT(CNode* pfrom, CPrivateSendAccept& dsa, CConnman& connman);
+    void ProcessDSVIN(CNode* pfrom, CPrivateSendEntry& entry, CConnman& connman);
+    void ProcessDSSIGNFINALTX(CNode* pfrom, const std::vector<CTxIn>& vecTxIn, CConnman& connman);
+
+    /// Check inputs, fees and collateral of an entry. Needs cs_main, which is why this is done on the worker thread
+    bool IsEntryValid(const CPrivateSendEntry& entry, PoolMessage& nMessageIDRet);
+    bool ProcessPendingEntries(CConnman& connman);
+    bool ProcessPendingCommits(CConnman& connman);
+    void WorkThreadMain();
+
+    /// Push a status update to a peer which is not part of any session
+    static void PushStatus(CNode* pnode, PoolStatusUpdate nStatusUpdate, PoolMessage nMessageID, CConnman& connman);
 
 public:
     CPrivateSendServer() :
-        vecSessionCollaterals(),
-        nSessionMaxParticipants(0),
         fUnitTest(false) {}
 
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
 
+    void StartWorkerThread();
+    void StopWorkerThread();
+    void InterruptWorkerThread();
+
+    int GetSessionsCount() const;
+    UniValue GetSessionsInfo() const;
+
     void CheckTimeout(CConnman& connman);
     void CheckForCompleteQueue(CConnman& connman);
 
@@ -85,6 +85,12 @@ bool CPrivateSendQueue::IsTimeOutOfBounds() const
     return GetAdjustedTime() - nTime > PRIVATESEND_QUEUE_TIMEOUT || nTime - GetAdjustedTime() > PRIVATESEND_QUEUE_TIMEOUT;
 }
 
+bool CPrivateSendQueue::OverlapsWith(const CPrivateSendQueue& q) const
+{
+    // compare the times the masternode put into the queues, not our own clock
+    return fReady == q.fReady && masternodeOutpoint == q.masternodeOutpoint && nTime - q.nTime < PRIVATESEND_QUEUE_TIMEOUT;
+}
+
 uint256 CPrivateSendBroadcastTx::GetSignatureHash() const
 {
     return SerializeHash(*this);
@@ -121,10 +127,10 @@ bool CPrivateSendBroadcastTx::CheckSignature(const CBLSPublicKey& blsPubKey) con
     return true;
 }
 
-bool CPrivateSendBroadcastTx::IsExpired(int nHeight)
+bool CPrivateSendBroadcastTx::IsExpired(int nHeight) const
 {
     // expire confirmed DSTXes after ~1h since confirmation
-    return (nConfirmedHeight != -1) && (nHeight - nConfirmedHeight > 24);
+    return (nConfirmedHeight != -1) && (nHeight - nConfirmedHeight > PRIVATESEND_DSTX_EXPIRY_BLOCKS);
 }
 
 void CPrivateSendBaseSession::SetNull()
@@ -200,8 +206,12 @@ std::string CPrivateSendBaseSession::GetStateString() const
 
 // Definitions for static data members
 std::vector<CAmount> CPrivateSend::vecStandardDenominations;
-std::map<uint256, CPrivateSendBroadcastTx> CPrivateSend::mapDSTX;
-CCriticalSection CPrivateSend::cs_mapdstx;
+std::unordered_map<uint256, CPrivateSendBroadcastTx, StaticSaltedHasher> CPrivateSend::mapDSTX;
+std::map<int, std::vector<uint256> > CPrivateSend::mapDSTXByConfirmedHeight;
+boost::shared_mutex CPrivateSend::cs_mapdstx;
+std::atomic<uint64_t> CPrivateSend::nDSTXHits{0};
+std::atomic<uint64_t> CPrivateSend::nDSTXMisses{0};
+std::atomic<uint64_t> CPrivateSend::nDSTXExpired{0};
 
 void CPrivateSend::InitStandardDenominations()
 {
@@ -457,29 +467,56 @@ std::string CPrivateSend::GetMessageByID(PoolMessage nMessageID)
 
 void CPrivateSend::AddDSTX(const CPrivateSendBroadcastTx& dstx)
 {
-    LOCK(cs_mapdstx);
-    mapDSTX.insert(std::make_pair(dstx.tx->GetHash(), dstx));
+    boost::unique_lock<boost::shared_mutex> lock(cs_mapdstx);
+    mapDSTX.emplace(dstx.tx->GetHash(), dstx);
 }
 
 CPrivateSendBroadcastTx CPrivateSend::GetDSTX(const uint256& hash)
 {
-    LOCK(cs_mapdstx);
+    boost::shared_lock<boost::shared_mutex> lock(cs_mapdstx);
     auto it = mapDSTX.find(hash);
-    return (it == mapDSTX.end()) ? CPrivateSendBroadcastTx() : it->second;
+    if (it == mapDSTX.end()) {
+        nDSTXMisses++;
+        return CPrivateSendBroadcastTx();
+    }
+    nDSTXHits++;
+    return it->second;
+}
+
+size_t CPrivateSend::GetDSTXCount()
+{
+    boost::shared_lock<boost::shared_mutex> lock(cs_mapdstx);
+    return mapDSTX.size();
+}
+
+void CPrivateSend::GetDSTXStats(uint64_t& nHitsRet, uint64_t& nMissesRet, uint64_t& nExpiredRet)
+{
+    nHitsRet = nDSTXHits;
+    nMissesRet = nDSTXMisses;
+    nExpiredRet = nDSTXExpired;
 }
 
 void CPrivateSend::CheckDSTXes(int nHeight)
 {
-    LOCK(cs_mapdstx);
-    std::map<uint256, CPrivateSendBroadcastTx>::iterator it = mapDSTX.begin();
-    while (it != mapDSTX.end()) {
-        if (it->second.IsExpired(nHeight)) {
-            mapDSTX.erase(it++);
-        } else {
-            ++it;
+    boost::unique_lock<boost::shared_mutex> lock(cs_mapdstx);
+
+    // only the buckets which reached the expiry height are visited
+    size_t nExpired = 0;
+    auto itBucket = mapDSTXByConfirmedHeight.begin();
+    while (itBucket != mapDSTXByConfirmedHeight.end() && nHeight - itBucket->first > PRIVATESEND_DSTX_EXPIRY_BLOCKS) {
+        for (const auto& txHash : itBucket->second) {
+            auto it = mapDSTX.find(txHash);
+            // the DSTX could have been unconfirmed or confirmed again at another height in the meantime
+            if (it != mapDSTX.end() && it->second.IsExpired(nHeight)) {
+                mapDSTX.erase(it);
+                nExpired++;
+            }
         }
+        itBucket = mapDSTXByConfirmedHeight.erase(itBucket);
     }
-    LogPrint("privatesend", "CPrivateSend::CheckDSTXes -- mapDSTX.size()=%llu\n", mapDSTX.size());
+    nDSTXExpired += nExpired;
+
+    LogPrint("privatesend", "CPrivateSend::CheckDSTXes -- expired=%llu  mapDSTX.size()=%llu\n", nExpired, mapDSTX.size());
 }
 
 void CPrivateSend::UpdatedBlockTip(const CBlockIndex* pindex)
@@ -493,12 +530,24 @@ void CPrivateSend::SyncTransaction(const CTransaction& tx, const CBlockIndex* pi
 {
     if (tx.IsCoinBase()) return;
 
-    LOCK2(cs_main, cs_mapdstx);
-
     uint256 txHash = tx.GetHash();
-    if (!mapDSTX.count(txHash)) return;
+
+    {
+        // most transactions are no DSTXes, don't block readers for them
+        boost::shared_lock<boost::shared_mutex> lock(cs_mapdstx);
+        if (!mapDSTX.count(txHash)) return;
+    }
+
+    boost::unique_lock<boost::shared_mutex> lock(cs_mapdstx);
+
+    auto it = mapDSTX.find(txHash);
+    if (it == mapDSTX.end()) return;
 
     // When tx is 0-confirmed or conflicted, posInBlock is SYNC_TRANSACTION_NOT_IN_BLOCK and nConfirmedHeight should be set to -1
-    mapDSTX[txHash].SetConfirmedHeight(posInBlock == CMainSignals::SYNC_TRANSACTION_NOT_IN_BLOCK ? -1 : pindex->nHeight);
+    int nConfirmedHeight = posInBlock == CMainSignals::SYNC_TRANSACTION_NOT_IN_BLOCK ? -1 : pindex->nHeight;
+    it->second.SetConfirmedHeight(nConfirmedHeight);
+    if (nConfirmedHeight != -1) {
+        mapDSTXByConfirmedHeight[nConfirmedHeight].emplace_back(txHash);
+    }
     LogPrint("privatesend", "CPrivateSend::SyncTransaction -- txid=%s\n", txHash.ToString());
 }
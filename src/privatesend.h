@@ -10,10 +10,16 @@
 #include "chainparams.h"
 #include "primitives/transaction.h"
 #include "pubkey.h"
+#include "saltedhasher.h"
 #include "sync.h"
 #include "timedata.h"
 #include "tinyformat.h"
 
+#include <atomic>
+#include <unordered_map>
+
+#include <boost/thread/shared_mutex.hpp>
+
 class CPrivateSend;
 class CConnman;
 
@@ -28,6 +34,9 @@ static const int MIN_PRIVATESEND_PEER_PROTO_VERSION = 70213;
 
 static const size_t PRIVATESEND_ENTRY_MAX_SIZE = 9;
 
+// confirmed DSTXes expire after ~1h
+static const int PRIVATESEND_DSTX_EXPIRY_BLOCKS = 24;
+
 // pool responses
 enum PoolMessage {
     ERR_ALREADY_HAVE,
@@ -231,6 +240,8 @@ public:
 
     /// Check if a queue is too old or too far into the future
     bool IsTimeOutOfBounds() const;
+    /// Was this queue announced by the same masternode while another queue with the same readiness was still running?
+    bool OverlapsWith(const CPrivateSendQueue& q) const;
 
     std::string ToString() const
     {
@@ -309,7 +320,8 @@ public:
     bool CheckSignature(const CBLSPublicKey& blsPubKey) const;
 
     void SetConfirmedHeight(int nConfirmedHeightIn) { nConfirmedHeight = nConfirmedHeightIn; }
-    bool IsExpired(int nHeight);
+    int GetConfirmedHeight() const { return nConfirmedHeight; }
+    bool IsExpired(int nHeight) const;
 };
 
 // base class
@@ -380,9 +392,17 @@ private:
 
     // static members
     static std::vector<CAmount> vecStandardDenominations;
-    static std::map<uint256, CPrivateSendBroadcastTx> mapDSTX;
+    static std::unordered_map<uint256, CPrivateSendBroadcastTx, StaticSaltedHasher> mapDSTX;
+    // Hashes of DSTXes by the height they were confirmed at, entries are not removed when a DSTX
+    // gets unconfirmed or confirmed at another height, so they must be checked again on expiry
+    static std::map<int, std::vector<uint256> > mapDSTXByConfirmedHeight;
+
+    // GetDSTX is called for every relayed tx/inv, so readers should not block each other
+    static boost::shared_mutex cs_mapdstx;
 
-    static CCriticalSection cs_mapdstx;
+    static std::atomic<uint64_t> nDSTXHits;
+    static std::atomic<uint64_t> nDSTXMisses;
+    static std::atomic<uint64_t> nDSTXExpired;
 
     static void CheckDSTXes(int nHeight);
 
@@ -418,6 +438,8 @@ public:
 
     static void AddDSTX(const CPrivateSendBroadcastTx& dstx);
     static CPrivateSendBroadcastTx GetDSTX(const uint256& hash);
+    static size_t GetDSTXCount();
+    static void GetDSTXStats(uint64_t& nHitsRet, uint64_t& nMissesRet, uint64_t& nExpiredRet);
 
     static void UpdatedBlockTip(const CBlockIndex* pindex);
     static void SyncTransaction(const CTransaction& tx, const CBlockIndex* pindex, int posInBlock);
@@ -57,6 +57,8 @@ const char *SYNCSTATUSCOUNT="ssc";
 const char *MNGOVERNANCESYNC="govsync";
 const char *MNGOVERNANCEOBJECT="govobj";
 const char *MNGOVERNANCEOBJECTVOTE="govobjvote";
+const char *MNGOVERNANCEVOTESKETCH="govvsketch";
+const char *MNGOVERNANCEVOTES="govvotes";
 const char *GETMNLISTDIFF="getmnlistd";
 const char *MNLISTDIFF="mnlistdiff";
 const char *QSENDRECSIGS="qsendrecsigs";
@@ -162,6 +164,8 @@ const static std::string allNetMessageTypes[] = {
     NetMsgType::MNGOVERNANCESYNC,
     NetMsgType::MNGOVERNANCEOBJECT,
     NetMsgType::MNGOVERNANCEOBJECTVOTE,
+    NetMsgType::MNGOVERNANCEVOTESKETCH,
+    NetMsgType::MNGOVERNANCEVOTES,
     NetMsgType::GETMNLISTDIFF,
     NetMsgType::MNLISTDIFF,
     NetMsgType::QSENDRECSIGS,
@@ -263,6 +263,8 @@ extern const char *SYNCSTATUSCOUNT;
 extern const char *MNGOVERNANCESYNC;
 extern const char *MNGOVERNANCEOBJECT;
 extern const char *MNGOVERNANCEOBJECTVOTE;
+extern const char *MNGOVERNANCEVOTESKETCH;
+extern const char *MNGOVERNANCEVOTES;
 extern const char *GETMNLISTDIFF;
 extern const char *MNLISTDIFF;
 extern const char *QSENDRECSIGS;
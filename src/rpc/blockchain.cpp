@@ -1312,6 +1312,14 @@ UniValue getblockchaininfo(const JSONRPCRequest& request)
             "        \"timeout\": xx,         (numeric) the median time past of a block at which the deployment is considered failed if not yet locked in\n"
             "        \"since\": xx            (numeric) height of the first block to which the status applies\n"
             "     }\n"
+            "  },\n"
+            "  \"chainlocklatency\": {        (object) Time from connecting a block until its ChainLock is known\n"
+            "    \"count\": xxxxx,            (numeric) Number of measured ChainLocks\n"
+            "    \"avg\": x.xxx,              (numeric) Average latency in milliseconds\n"
+            "    \"max\": x.xxx,              (numeric) Maximum latency in milliseconds\n"
+            "    \"buckets\": [               (array) Number of ChainLocks below (\"lt\") or above (\"gte\") the given milliseconds\n"
+            "      { \"lt\": n, \"count\": n }, ...\n"
+            "    ]\n"
             "  }\n"
             "}\n"
             "\nExamples:\n"
@@ -1347,6 +1355,10 @@ UniValue getblockchaininfo(const JSONRPCRequest& request)
     obj.push_back(Pair("softforks",             softforks));
     obj.push_back(Pair("bip9_softforks", bip9_softforks));
 
+    UniValue chainLockLatency;
+    llmq::chainLocksHandler->GetChainLockLatency(chainLockLatency);
+    obj.push_back(Pair("chainlocklatency", chainLockLatency));
+
     if (fPruneMode)
     {
         CBlockIndex *block = chainActive.Tip();
@@ -1511,6 +1523,9 @@ UniValue mempoolInfoToJSON()
     ret.push_back(Pair("maxmempool", (int64_t) maxmempool));
     ret.push_back(Pair("mempoolminfee", ValueFromAmount(mempool.GetMinFee(maxmempool).GetFeePerK())));
     ret.push_back(Pair("instantsendlocks", (int64_t)llmq::quorumInstantSendManager->GetInstantSendLockCount()));
+    UniValue islockLatency;
+    llmq::quorumInstantSendManager->GetInstantSendLockLatency(islockLatency);
+    ret.push_back(Pair("instantsendlocklatency", islockLatency));
 
     return ret;
 }
@@ -1529,6 +1544,14 @@ UniValue getmempoolinfo(const JSONRPCRequest& request)
             "  \"maxmempool\": xxxxx,         (numeric) Maximum memory usage for the mempool\n"
             "  \"mempoolminfee\": xxxxx       (numeric) Minimum fee for tx to be accepted\n"
             "  \"instantsendlocks\": xxxxx,   (numeric) Number of unconfirmed instant send locks\n"
+            "  \"instantsendlocklatency\": {  (json object) Time from receiving an islock until the locked TX is notified\n"
+            "    \"count\": xxxxx,            (numeric) Number of measured islocks\n"
+            "    \"avg\": x.xxx,              (numeric) Average latency in milliseconds\n"
+            "    \"max\": x.xxx,              (numeric) Maximum latency in milliseconds\n"
+            "    \"buckets\": [               (array) Number of islocks below (\"lt\") or above (\"gte\") the given milliseconds\n"
+            "      { \"lt\": n, \"count\": n }, ...\n"
+            "    ]\n"
+            "  }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getmempoolinfo", "")
@@ -77,6 +77,19 @@ UniValue privatesend(const JSONRPCRequest& request)
 }
 #endif // ENABLE_WALLET
 
+static UniValue GetDSTXInfo()
+{
+    uint64_t nHits, nMisses, nExpired;
+    CPrivateSend::GetDSTXStats(nHits, nMisses, nExpired);
+
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("count",             (int64_t)CPrivateSend::GetDSTXCount()));
+    obj.push_back(Pair("hits",              nHits));
+    obj.push_back(Pair("misses",            nMisses));
+    obj.push_back(Pair("expired",           nExpired));
+    return obj;
+}
+
 UniValue getpoolinfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -91,8 +104,12 @@ UniValue getpoolinfo(const JSONRPCRequest& request)
     // TODO:
     // obj.push_back(Pair("state",             pprivateSendBase->GetStateString()));
     obj.push_back(Pair("queue",             pprivateSendBaseManager->GetQueueSize()));
+    obj.push_back(Pair("dstx",              GetDSTXInfo()));
     // obj.push_back(Pair("entries",           pprivateSendBase->GetEntriesCount()));
     obj.push_back(Pair("status",            privateSendClient.GetStatuses()));
+    if (fMasternodeMode) {
+        obj.push_back(Pair("sessions",      privateSendServer.GetSessionsInfo()));
+    }
 
     std::vector<CDeterministicMNCPtr> vecDmns;
     if (privateSendClient.GetMixingMasternodesInfo(vecDmns)) {
@@ -114,9 +131,9 @@ UniValue getpoolinfo(const JSONRPCRequest& request)
     }
 #else // ENABLE_WALLET
     UniValue obj(UniValue::VOBJ);
-    obj.push_back(Pair("state",             privateSendServer.GetStateString()));
     obj.push_back(Pair("queue",             privateSendServer.GetQueueSize()));
-    obj.push_back(Pair("entries",           privateSendServer.GetEntriesCount()));
+    obj.push_back(Pair("sessions",          privateSendServer.GetSessionsInfo()));
+    obj.push_back(Pair("dstx",              GetDSTXInfo()));
 #endif // ENABLE_WALLET
 
     return obj;
@@ -323,6 +323,41 @@ std::string gbt_vb_name(const Consensus::DeploymentPos pos) {
     return s;
 }
 
+static UniValue TemplateTxToJSON(const CTransaction& tx, const UniValue& deps, CAmount nFee, int64_t nSigOps)
+{
+    UniValue entry(UniValue::VOBJ);
+    entry.push_back(Pair("data", EncodeHexTx(tx)));
+    entry.push_back(Pair("hash", tx.GetHash().GetHex()));
+    entry.push_back(Pair("depends", deps));
+    entry.push_back(Pair("fee", nFee));
+    entry.push_back(Pair("sigops", nSigOps));
+    return entry;
+}
+
+static UniValue TemplatePayeesToJSON(const std::vector<CTxOut>& vout)
+{
+    UniValue payees(UniValue::VARR);
+    for (const auto& txout : vout) {
+        CTxDestination address1;
+        ExtractDestination(txout.scriptPubKey, address1);
+        CBitcoinAddress address2(address1);
+
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("payee", address2.ToString().c_str()));
+        obj.push_back(Pair("script", HexStr(txout.scriptPubKey)));
+        obj.push_back(Pair("amount", txout.nValue));
+        payees.push_back(obj);
+    }
+    return payees;
+}
+
+// Identifies the newest getblocktemplate template for long-poll waiters, guarded by csBestBlock
+static uint256 hashLongPollTemplatePrev;
+static unsigned int nLongPollTemplateTransactionsUpdated;
+
+// Number of previous templates on the current tip which can serve as a base for "delta" requests
+static const size_t MAX_DELTA_TEMPLATES = 16;
+
 UniValue getblocktemplate(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 1)
@@ -346,7 +381,10 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
             "       \"rules\":[            (array, optional) A list of strings\n"
             "           \"support\"          (string) client side supported softfork deployment\n"
             "           ,...\n"
-            "       ]\n"
+            "       ],\n"
+            "       \"longpollid\":\"id\"    (string, optional) Wait until the template changed compared to the one with this longpollid\n"
+            "       \"delta\":true|false     (boolean, optional, default=false) If the template identified by longpollid is still known and\n"
+            "                                 on the same previous block, return \"delta\" instead of the full \"transactions\" list\n"
             "     }\n"
             "\n"
 
@@ -413,6 +451,12 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
             "  \"superblocks_started\" : true|false, (boolean) true, if superblock payments started\n"
             "  \"superblocks_enabled\" : true|false, (boolean) true, if superblock payments are enabled\n"
             "  \"coinbase_payload\" : \"xxxxxxxx\"    (string) coinbase transaction payload data encoded in hexadecimal\n"
+            "  \"delta\" : {                      (json object) only present instead of \"transactions\" when a delta was requested\n"
+            "      \"base\" : \"id\",              (string) the longpollid this delta is relative to\n"
+            "      \"added\" : [ ... ],           (array) transactions added to the template, in block order and in the same format\n"
+            "                                     as \"transactions\", except that \"depends\" lists the hashes of the transactions\n"
+            "      \"removed\" : [ \"hash\", ... ]  (array of strings) hashes of transactions removed from the template\n"
+            "  }\n"
             "}\n"
 
             "\nExamples:\n"
@@ -424,6 +468,7 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
 
     std::string strMode = "template";
     UniValue lpval = NullUniValue;
+    bool fDelta = false;
     std::set<std::string> setClientRules;
     int64_t nMaxVersionPreVB = -1;
     if (request.params.size() > 0)
@@ -439,6 +484,9 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
         else
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid mode");
         lpval = find_value(oparam, "longpollid");
+        const UniValue& deltaval = find_value(oparam, "delta");
+        if (deltaval.isBool())
+            fDelta = deltaval.get_bool();
 
         if (strMode == "proposal")
         {
@@ -511,12 +559,13 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
 
     static unsigned int nTransactionsUpdatedLast;
 
+    uint256 hashWatchedChain;
+    unsigned int nTransactionsUpdatedLastLP = 0;
     if (!lpval.isNull())
     {
-        // Wait to respond until either the best block changes, OR a minute has passed and there are more transactions
-        uint256 hashWatchedChain;
+        // Wait to respond until either the best block changes, a newer template was built
+        // for another caller, OR a minute has passed and there are more transactions
         boost::system_time checktxtime;
-        unsigned int nTransactionsUpdatedLastLP;
 
         if (lpval.isStr())
         {
@@ -539,7 +588,8 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
             checktxtime = boost::get_system_time() + boost::posix_time::minutes(1);
 
             boost::unique_lock<boost::mutex> lock(csBestBlock);
-            while (chainActive.Tip()->GetBlockHash() == hashWatchedChain && IsRPCRunning())
+            while (chainActive.Tip()->GetBlockHash() == hashWatchedChain && IsRPCRunning() &&
+                   !(hashLongPollTemplatePrev == hashWatchedChain && nLongPollTemplateTransactionsUpdated != nTransactionsUpdatedLastLP))
             {
                 if (!cvBlockChange.timed_wait(lock, checktxtime))
                 {
@@ -561,6 +611,14 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     static CBlockIndex* pindexPrev;
     static int64_t nStart;
     static std::unique_ptr<CBlockTemplate> pblocktemplate;
+    // JSON parts of pblocktemplate which only change together with it
+    static UniValue templateTransactions;
+    static UniValue templateMasternodePayees;
+    static UniValue templateSuperblockPayees;
+    // Transactions of recent templates on the current tip, keyed by the
+    // nTransactionsUpdated part of their longpollid
+    static uint256 hashRecentTemplatesPrev;
+    static std::map<unsigned int, std::vector<uint256>> mapRecentTemplateTxs;
     if (pindexPrev != chainActive.Tip() ||
         (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5))
     {
@@ -578,8 +636,52 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
         if (!pblocktemplate)
             throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
 
+        // Encode the template only once, all callers until the next CreateNewBlock share it
+        templateTransactions = UniValue(UniValue::VARR);
+        std::vector<uint256> vTemplateTxs;
+        std::map<uint256, int64_t> setTxIndex;
+        int i = 0;
+        for (const auto& it : pblocktemplate->block.vtx) {
+            const CTransaction& tx = *it;
+            uint256 txHash = tx.GetHash();
+            setTxIndex[txHash] = i++;
+
+            if (tx.IsCoinBase())
+                continue;
+
+            UniValue deps(UniValue::VARR);
+            BOOST_FOREACH (const CTxIn &in, tx.vin)
+            {
+                if (setTxIndex.count(in.prevout.hash))
+                    deps.push_back(setTxIndex[in.prevout.hash]);
+            }
+
+            int index_in_template = i - 1;
+            templateTransactions.push_back(TemplateTxToJSON(tx, deps, pblocktemplate->vTxFees[index_in_template], pblocktemplate->vTxSigOps[index_in_template]));
+            vTemplateTxs.emplace_back(txHash);
+        }
+        templateMasternodePayees = TemplatePayeesToJSON(pblocktemplate->voutMasternodePayments);
+        templateSuperblockPayees = TemplatePayeesToJSON(pblocktemplate->voutSuperblockPayments);
+
+        if (hashRecentTemplatesPrev != pindexPrevNew->GetBlockHash()) {
+            hashRecentTemplatesPrev = pindexPrevNew->GetBlockHash();
+            mapRecentTemplateTxs.clear();
+        }
+        mapRecentTemplateTxs[nTransactionsUpdatedLast] = std::move(vTemplateTxs);
+        while (mapRecentTemplateTxs.size() > MAX_DELTA_TEMPLATES) {
+            mapRecentTemplateTxs.erase(mapRecentTemplateTxs.begin());
+        }
+
         // Need to update only after we know CreateNewBlock succeeded
         pindexPrev = pindexPrevNew;
+
+        // Release all long-poll waiters of older templates at once, they'll get this one
+        {
+            boost::unique_lock<boost::mutex> lock(csBestBlock);
+            hashLongPollTemplatePrev = pindexPrev->GetBlockHash();
+            nLongPollTemplateTransactionsUpdated = nTransactionsUpdatedLast;
+        }
+        cvBlockChange.notify_all();
     }
     CBlock* pblock = &pblocktemplate->block; // pointer for convenience
     const Consensus::Params& consensusParams = Params().GetConsensus();
@@ -590,36 +692,40 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
 
     UniValue aCaps(UniValue::VARR); aCaps.push_back("proposal");
 
-    UniValue transactions(UniValue::VARR);
-    std::map<uint256, int64_t> setTxIndex;
-    int i = 0;
-    for (const auto& it : pblock->vtx) {
-        const CTransaction& tx = *it;
-        uint256 txHash = tx.GetHash();
-        setTxIndex[txHash] = i++;
-
-        if (tx.IsCoinBase())
-            continue;
-
-        UniValue entry(UniValue::VOBJ);
-
-        entry.push_back(Pair("data", EncodeHexTx(tx)));
-
-        entry.push_back(Pair("hash", txHash.GetHex()));
-
-        UniValue deps(UniValue::VARR);
-        BOOST_FOREACH (const CTxIn &in, tx.vin)
-        {
-            if (setTxIndex.count(in.prevout.hash))
-                deps.push_back(setTxIndex[in.prevout.hash]);
+    // Only send the changes if the client still has the base template
+    UniValue delta(UniValue::VNULL);
+    if (fDelta && lpval.isStr() && hashWatchedChain == pindexPrev->GetBlockHash() &&
+        mapRecentTemplateTxs.count(nTransactionsUpdatedLastLP) && mapRecentTemplateTxs.count(nTransactionsUpdatedLast))
+    {
+        const auto& vBaseTxs = mapRecentTemplateTxs[nTransactionsUpdatedLastLP];
+        const auto& vCurrentTxs = mapRecentTemplateTxs[nTransactionsUpdatedLast];
+        std::set<uint256> setBaseTxs(vBaseTxs.begin(), vBaseTxs.end());
+        std::set<uint256> setCurrentTxs(vCurrentTxs.begin(), vCurrentTxs.end());
+
+        UniValue added(UniValue::VARR);
+        UniValue removed(UniValue::VARR);
+        for (const uint256& txHash : vBaseTxs) {
+            if (!setCurrentTxs.count(txHash))
+                removed.push_back(txHash.GetHex());
+        }
+        for (size_t i = 0; i < pblock->vtx.size(); i++) {
+            const CTransaction& tx = *pblock->vtx[i];
+            if (tx.IsCoinBase() || setBaseTxs.count(tx.GetHash()))
+                continue;
+
+            UniValue deps(UniValue::VARR);
+            std::set<uint256> setDeps;
+            for (const CTxIn& in : tx.vin) {
+                if (setCurrentTxs.count(in.prevout.hash) && setDeps.emplace(in.prevout.hash).second)
+                    deps.push_back(in.prevout.hash.GetHex());
+            }
+            added.push_back(TemplateTxToJSON(tx, deps, pblocktemplate->vTxFees[i], pblocktemplate->vTxSigOps[i]));
         }
-        entry.push_back(Pair("depends", deps));
-
-        int index_in_template = i - 1;
-        entry.push_back(Pair("fee", pblocktemplate->vTxFees[index_in_template]));
-        entry.push_back(Pair("sigops", pblocktemplate->vTxSigOps[index_in_template]));
 
-        transactions.push_back(entry);
+        delta = UniValue(UniValue::VOBJ);
+        delta.push_back(Pair("base", lpval.get_str()));
+        delta.push_back(Pair("added", added));
+        delta.push_back(Pair("removed", removed));
     }
 
     UniValue aux(UniValue::VOBJ);
@@ -691,7 +797,9 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     }
 
     result.push_back(Pair("previousblockhash", pblock->hashPrevBlock.GetHex()));
-    result.push_back(Pair("transactions", transactions));
+    if (delta.isNull()) {
+        result.push_back(Pair("transactions", templateTransactions));
+    }
     result.push_back(Pair("coinbaseaux", aux));
     result.push_back(Pair("coinbasevalue", (int64_t)pblock->vtx[0]->GetValueOut()));
     result.push_back(Pair("longpollid", chainActive.Tip()->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast)));
@@ -706,42 +814,20 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     result.push_back(Pair("previousbits", strprintf("%08x", pblocktemplate->nPrevBits)));
     result.push_back(Pair("height", (int64_t)(pindexPrev->nHeight+1)));
 
-    UniValue masternodeObj(UniValue::VARR);
-    for (const auto& txout : pblocktemplate->voutMasternodePayments) {
-        CTxDestination address1;
-        ExtractDestination(txout.scriptPubKey, address1);
-        CBitcoinAddress address2(address1);
-
-        UniValue obj(UniValue::VOBJ);
-        obj.push_back(Pair("payee", address2.ToString().c_str()));
-        obj.push_back(Pair("script", HexStr(txout.scriptPubKey)));
-        obj.push_back(Pair("amount", txout.nValue));
-        masternodeObj.push_back(obj);
-    }
-
-    result.push_back(Pair("masternode", masternodeObj));
+    result.push_back(Pair("masternode", templateMasternodePayees));
     result.push_back(Pair("masternode_payments_started", pindexPrev->nHeight + 1 > consensusParams.nMasternodePaymentsStartBlock));
     result.push_back(Pair("masternode_payments_enforced", true));
 
-    UniValue superblockObjArray(UniValue::VARR);
-    if(pblocktemplate->voutSuperblockPayments.size()) {
-        for (const auto& txout : pblocktemplate->voutSuperblockPayments) {
-            UniValue entry(UniValue::VOBJ);
-            CTxDestination address1;
-            ExtractDestination(txout.scriptPubKey, address1);
-            CBitcoinAddress address2(address1);
-            entry.push_back(Pair("payee", address2.ToString().c_str()));
-            entry.push_back(Pair("script", HexStr(txout.scriptPubKey)));
-            entry.push_back(Pair("amount", txout.nValue));
-            superblockObjArray.push_back(entry);
-        }
-    }
-    result.push_back(Pair("superblock", superblockObjArray));
+    result.push_back(Pair("superblock", templateSuperblockPayees));
     result.push_back(Pair("superblocks_started", pindexPrev->nHeight + 1 > consensusParams.nSuperblockStartBlock));
     result.push_back(Pair("superblocks_enabled", sporkManager.IsSporkActive(SPORK_9_SUPERBLOCKS_ENABLED)));
 
     result.push_back(Pair("coinbase_payload", HexStr(pblock->vtx[0]->vExtraPayload)));
 
+    if (!delta.isNull()) {
+        result.push_back(Pair("delta", delta));
+    }
+
     return result;
 }
 
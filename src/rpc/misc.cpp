@@ -10,6 +10,7 @@
 #include "net.h"
 #include "netbase.h"
 #include "rpc/server.h"
+#include "script/sigcache.h"
 #include "timedata.h"
 #include "txmempool.h"
 #include "util.h"
@@ -24,6 +25,10 @@
 #include "masternode-sync.h"
 #include "spork.h"
 
+#include "evo/deterministicmns.h"
+#include "llmq/quorums_chainlocks.h"
+#include "llmq/quorums_instantsend.h"
+
 #include <stdint.h>
 
 #include <boost/assign/list_of.hpp>
@@ -1105,6 +1110,15 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCCacheHitInfo(uint64_t nLookups, uint64_t nHits)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("lookups", nLookups));
+    obj.push_back(Pair("hits", nHits));
+    obj.push_back(Pair("hitrate", nLookups ? (double)nHits / nLookups : 0.0));
+    return obj;
+}
+
 UniValue getmemoryinfo(const JSONRPCRequest& request)
 {
     /* Please, avoid using the word "pool" here in the RPC interface or help,
@@ -1123,14 +1137,69 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"sigcache\": {             (json object) Information about the signature cache\n"
+            "    \"lookups\": xxxxx,       (numeric) Number of signatures looked up\n"
+            "    \"hits\": xxxxx,          (numeric) Number of signatures found in the cache\n"
+            "    \"hitrate\": x.xxx,       (numeric) Share of lookups that were hits\n"
+            "  },\n"
+            "  \"scriptcache\": {          (json object) Information about the script execution cache\n"
+            "    \"lookups\": xxxxx,       (numeric) Number of transactions looked up\n"
+            "    \"hits\": xxxxx,          (numeric) Number of transactions whose scripts didn't need to be executed again\n"
+            "    \"hitrate\": x.xxx,       (numeric) Share of lookups that were hits\n"
+            "  },\n"
+            "  \"mnlistcache\": {          (json object) Information about the deterministic masternode list cache\n"
+            "    \"snapshotPeriod\": xxx,  (numeric) Number of blocks between two list snapshots written to disk\n"
+            "    \"recentLists\": xxx,     (numeric) Number of cached lists close to the chain tip\n"
+            "    \"checkpointLists\": xxx, (numeric) Number of cached sparse checkpoint lists\n"
+            "    \"lruLists\": xxx,        (numeric) Number of cached recently requested historic lists\n"
+            "    \"hits\": xxxxx,          (numeric) Number of lists found in the cache\n"
+            "    \"misses\": xxxxx,        (numeric) Number of lists that had to be rebuilt from disk\n"
+            "    \"diffsApplied\": xxxxx,  (numeric) Number of list diffs applied while rebuilding\n"
+            "    \"rebuildTime\": x.xxx,   (numeric) Total time spent rebuilding lists, in seconds\n"
+            "  },\n"
+            "  \"islockindex\": {          (json object) Information about the in-memory index of active InstantSend locks\n"
+            "    \"locks\": xxxxx,         (numeric) Number of indexed InstantSend locks\n"
+            "    \"usage\": xxxxx,         (numeric) Memory used by the index, in bytes\n"
+            "    \"bytesperlock\": xxx,    (numeric) Average memory used per InstantSend lock, in bytes\n"
+            "  },\n"
+            "  \"chainlockstxs\": {        (json object) Information about the TXs of recent blocks tracked for ChainLocks\n"
+            "    \"txs\": xxxxx,           (numeric) Number of TXs which are not old enough yet to be safe without an InstantSend lock\n"
+            "    \"blocks\": xxx,          (numeric) Number of recent blocks whose TXs are tracked\n"
+            "    \"usage\": xxxxx,         (numeric) Memory used for tracking, in bytes\n"
+            "    \"evicted\": xxx,         (numeric) Number of time buckets dropped early because the tracking limit was reached\n"
             "  }\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getmemoryinfo", "")
             + HelpExampleRpc("getmemoryinfo", "")
         );
+    uint64_t nLookups, nHits;
     UniValue obj(UniValue::VOBJ);
     obj.push_back(Pair("locked", RPCLockedMemoryInfo()));
+    GetSignatureCacheStats(nLookups, nHits);
+    obj.push_back(Pair("sigcache", RPCCacheHitInfo(nLookups, nHits)));
+    GetScriptExecutionCacheStats(nLookups, nHits);
+    obj.push_back(Pair("scriptcache", RPCCacheHitInfo(nLookups, nHits)));
+    UniValue mnListCacheObj(UniValue::VOBJ);
+    deterministicMNManager->GetListCacheStats(mnListCacheObj);
+    obj.push_back(Pair("mnlistcache", mnListCacheObj));
+    UniValue islockIndexObj(UniValue::VOBJ);
+    size_t nISLocks = llmq::quorumInstantSendManager->GetInstantSendLockCount();
+    size_t nISLockIndexUsage = llmq::quorumInstantSendManager->GetInstantSendLockIndexMemoryUsage();
+    islockIndexObj.push_back(Pair("locks", (uint64_t)nISLocks));
+    islockIndexObj.push_back(Pair("usage", (uint64_t)nISLockIndexUsage));
+    islockIndexObj.push_back(Pair("bytesperlock", (uint64_t)(nISLocks ? nISLockIndexUsage / nISLocks : 0)));
+    obj.push_back(Pair("islockindex", islockIndexObj));
+    UniValue clTxsObj(UniValue::VOBJ);
+    size_t nCLTxs, nCLBlocks, nCLUsage;
+    uint64_t nCLEvicted;
+    llmq::chainLocksHandler->GetTxTrackerStats(nCLTxs, nCLBlocks, nCLUsage, nCLEvicted);
+    clTxsObj.push_back(Pair("txs", (uint64_t)nCLTxs));
+    clTxsObj.push_back(Pair("blocks", (uint64_t)nCLBlocks));
+    clTxsObj.push_back(Pair("usage", (uint64_t)nCLUsage));
+    clTxsObj.push_back(Pair("evicted", nCLEvicted));
+    obj.push_back(Pair("chainlockstxs", clTxsObj));
     return obj;
 }
 
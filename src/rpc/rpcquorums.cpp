@@ -11,6 +11,7 @@
 #include "llmq/quorums_debug.h"
 #include "llmq/quorums_dkgsession.h"
 #include "llmq/quorums_signing.h"
+#include "llmq/quorums_signing_shares.h"
 
 void quorum_list_help()
 {
@@ -341,6 +342,54 @@ UniValue quorum_sigs_cmd(const JSONRPCRequest& request)
     }
 }
 
+void quorum_sigsharestats_help()
+{
+    throw std::runtime_error(
+            "quorum sigsharestats\n"
+            "Return timing statistics of the batched signature share verification, per LLMQ type.\n"
+            "Batches of different quorums are verified in parallel, so the sum of the batch times is usually\n"
+            "higher than lastVerifyTime.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"lastVerifyTime\": xxx,      (numeric) Wall time of the last verification pass, in milliseconds\n"
+            "  \"llmq_name\": {\n"
+            "    \"batches\": xxx,           (numeric) Number of verified batches\n"
+            "    \"sigShares\": xxx,         (numeric) Number of verified signature shares\n"
+            "    \"totalTime\": xxx,         (numeric) Sum of all batch times, in milliseconds\n"
+            "    \"maxBatchTime\": xxx,      (numeric) Time of the slowest batch, in milliseconds\n"
+            "    \"lastBatchTime\": xxx,     (numeric) Time of the last batch, in milliseconds\n"
+            "    \"lastBatchSize\": xxx,     (numeric) Number of signature shares in the last batch\n"
+            "  }, ...\n"
+            "}\n"
+    );
+}
+
+UniValue quorum_sigsharestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1) {
+        quorum_sigsharestats_help();
+    }
+
+    int64_t lastVerifyTime;
+    auto stats = llmq::quorumSigSharesManager->GetVerifyStats(lastVerifyTime);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("lastVerifyTime", lastVerifyTime * 0.001));
+    for (const auto& p : stats) {
+        auto& s = p.second;
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("batches", s.batchCount));
+        obj.push_back(Pair("sigShares", s.sigShareCount));
+        obj.push_back(Pair("totalTime", s.totalTime * 0.001));
+        obj.push_back(Pair("maxBatchTime", s.maxBatchTime * 0.001));
+        obj.push_back(Pair("lastBatchTime", s.lastBatchTime * 0.001));
+        obj.push_back(Pair("lastBatchSize", (int64_t)s.lastBatchSize));
+        ret.push_back(Pair(Params().GetConsensus().llmqs.at(p.first).name, obj));
+    }
+
+    return ret;
+}
+
 void quorum_dkgsimerror_help()
 {
     throw std::runtime_error(
@@ -391,6 +440,7 @@ UniValue quorum_dkgsimerror(const JSONRPCRequest& request)
             "  hasrecsig         - Test if a valid recovered signature is present\n"
             "  getrecsig         - Get a recovered signature\n"
             "  isconflicting     - Test if a conflict exists\n"
+            "  sigsharestats     - Return timing statistics of signature share verification\n"
     );
 }
 
@@ -415,6 +465,8 @@ UniValue quorum(const JSONRPCRequest& request)
         return quorum_memberof(request);
     } else if (command == "sign" || command == "hasrecsig" || command == "getrecsig" || command == "isconflicting") {
         return quorum_sigs_cmd(request);
+    } else if (command == "sigsharestats") {
+        return quorum_sigsharestats(request);
     } else if (command == "dkgsimerror") {
         return quorum_dkgsimerror(request);
     } else {
@@ -12,31 +12,13 @@
 #include "util.h"
 
 #include "cuckoocache.h"
+
+#include <atomic>
+
 #include <boost/thread.hpp>
 
 namespace {
 
-/**
- * We're hashing a nonce into the entries themselves, so we don't need extra
- * blinding in the set hash computation.
- *
- * This may exhibit platform endian dependent behavior but because these are
- * nonced hashes (random) and this state is only ever used locally it is safe.
- * All that matters is local consistency.
- */
-class SignatureCacheHasher
-{
-public:
-    template <uint8_t hash_select>
-    uint32_t operator()(const uint256& key) const
-    {
-        static_assert(hash_select <8, "SignatureCacheHasher only has 8 hashes available.");
-        uint32_t u;
-        std::memcpy(&u, key.begin()+4*hash_select, 4);
-        return u;
-    }
-};
-
 /**
  * Valid signature cache, to avoid doing expensive ECDSA signature checking
  * twice for every transaction (once when accepted into memory pool, and
@@ -88,6 +70,9 @@ public:
  * signatureCache could be made local to VerifySignature.
 */
 static CSignatureCache signatureCache;
+
+static std::atomic<uint64_t> nSignatureCacheLookups(0);
+static std::atomic<uint64_t> nSignatureCacheHits(0);
 }
 
 // To be called once in AppInitMain/BasicTestingSetup to initialize the
@@ -96,7 +81,8 @@ void InitSignatureCache()
 {
     // nMaxCacheSize is unsigned. If -maxsigcachesize is set to zero,
     // setup_bytes creates the minimum possible cache (2 elements).
-    size_t nMaxCacheSize = std::min(std::max((int64_t)0, GetArg("-maxsigcachesize", DEFAULT_MAX_SIG_CACHE_SIZE)), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    // The other half of -maxsigcachesize goes to the script execution cache.
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, GetArg("-maxsigcachesize", DEFAULT_MAX_SIG_CACHE_SIZE) / 2), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
     size_t nElems = signatureCache.setup_bytes(nMaxCacheSize);
     LogPrintf("Using %zu MiB out of %zu requested for signature cache, able to store %zu elements\n",
             (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
@@ -106,11 +92,20 @@ bool CachingTransactionSignatureChecker::VerifySignature(const std::vector<unsig
 {
     uint256 entry;
     signatureCache.ComputeEntry(entry, sighash, vchSig, pubkey);
-    if (signatureCache.Get(entry, !store))
+    nSignatureCacheLookups++;
+    if (signatureCache.Get(entry, !store)) {
+        nSignatureCacheHits++;
         return true;
+    }
     if (!TransactionSignatureChecker::VerifySignature(vchSig, pubkey, sighash))
         return false;
     if (store)
         signatureCache.Set(entry);
     return true;
 }
+
+void GetSignatureCacheStats(uint64_t& nLookupsRet, uint64_t& nHitsRet)
+{
+    nLookupsRet = nSignatureCacheLookups;
+    nHitsRet = nSignatureCacheHits;
+}
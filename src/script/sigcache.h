@@ -8,6 +8,7 @@
 
 #include "script/interpreter.h"
 
+#include <cstring>
 #include <vector>
 
 // DoS prevention: limit cache size to 32MB (over 1000000 entries on 64-bit
@@ -19,6 +20,27 @@ static const int64_t MAX_MAX_SIG_CACHE_SIZE = 16384;
 
 class CPubKey;
 
+/**
+ * We're hashing a nonce into the entries themselves, so we don't need extra
+ * blinding in the set hash computation.
+ *
+ * This may exhibit platform endian dependent behavior but because these are
+ * nonced hashes (random) and this state is only ever used locally it is safe.
+ * All that matters is local consistency.
+ */
+class SignatureCacheHasher
+{
+public:
+    template <uint8_t hash_select>
+    uint32_t operator()(const uint256& key) const
+    {
+        static_assert(hash_select <8, "SignatureCacheHasher only has 8 hashes available.");
+        uint32_t u;
+        std::memcpy(&u, key.begin()+4*hash_select, 4);
+        return u;
+    }
+};
+
 class CachingTransactionSignatureChecker : public TransactionSignatureChecker
 {
 private:
@@ -32,4 +54,7 @@ public:
 
 void InitSignatureCache();
 
+/** Number of lookups in the signature cache and how many of them were hits */
+void GetSignatureCacheStats(uint64_t& nLookupsRet, uint64_t& nHitsRet);
+
 #endif // BITCOIN_SCRIPT_SIGCACHE_H
@@ -0,0 +1,80 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "miner.h"
+#include "random.h"
+#include "txmempool.h"
+
+#include "test/test_jemcash.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blocktemplate_tests, TestingSetup)
+
+static CMutableTransaction MakeTx()
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].prevout = COutPoint(GetRandHash(), 0);
+    tx.vin[0].scriptSig = CScript() << OP_11;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    tx.vout[0].nValue = 10 * COIN;
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(template_reuse_and_invalidation)
+{
+    CTxMemPool pool;
+    TestMemPoolEntryHelper entry;
+    CBlockTemplateManager manager;
+    manager.Connect(pool);
+
+    CMutableTransaction tx1 = MakeTx();
+    CMutableTransaction tx2 = MakeTx();
+    LOCK(pool.cs);
+    pool.addUnchecked(tx1.GetHash(), entry.Fee(10000).FromTx(tx1));
+
+    uint256 hashPrevBlock = GetRandHash();
+    CFeeRate minFeeRate(1000);
+    std::vector<uint256> vSelected;
+    std::vector<uint256> vCandidates;
+
+    // nothing stored yet
+    BOOST_CHECK(!manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+
+    manager.SetSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, {tx1.GetHash()}, false, {});
+    BOOST_CHECK(manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+    BOOST_CHECK(vSelected == std::vector<uint256>{tx1.GetHash()});
+    BOOST_CHECK(vCandidates.empty());
+
+    // a different tip or configuration needs a full rebuild
+    BOOST_CHECK(!manager.GetIncrementalSelection(GetRandHash(), 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+    BOOST_CHECK(!manager.GetIncrementalSelection(hashPrevBlock, 50000, minFeeRate, 1000, 10, vSelected, vCandidates));
+
+    // new mempool transactions are the only candidates for package selection
+    pool.addUnchecked(tx2.GetHash(), entry.Fee(20000).FromTx(tx2));
+    BOOST_CHECK(manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+    BOOST_CHECK(vSelected == std::vector<uint256>{tx1.GetHash()});
+    BOOST_CHECK(vCandidates == std::vector<uint256>{tx2.GetHash()});
+
+    // a limited selection can't be reused once the mempool changed
+    manager.SetSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, {tx1.GetHash()}, true, {});
+    BOOST_CHECK(manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+    pool.removeRecursive(tx2);
+    BOOST_CHECK(!manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+
+    // prioritising a mempool transaction drops the selection
+    manager.SetSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, {tx1.GetHash()}, false, {});
+    BOOST_CHECK(manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+    pool.PrioritiseTransaction(tx1.GetHash(), 5000);
+    BOOST_CHECK(!manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+
+    // but prioritising transactions which are not in the mempool doesn't
+    manager.SetSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, {tx1.GetHash()}, false, {});
+    pool.PrioritiseTransaction(GetRandHash(), 5000);
+    BOOST_CHECK(manager.GetIncrementalSelection(hashPrevBlock, 100000, minFeeRate, 1000, 10, vSelected, vCandidates));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -77,7 +77,7 @@ static void AddMessage(std::vector<Message>& vec, uint32_t sourceId, uint32_t ms
     vec.emplace_back(m);
 }
 
-static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback)
+static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback, size_t maxBatchSize = 0)
 {
     CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(secureVerification, perMessageFallback);
 
@@ -92,7 +92,12 @@ static void Verify(std::vector<Message>& vec, bool secureVerification, bool perM
         batchVerifier.PushMessage(m.sourceId, m.msgId, m.msgHash, m.sig, m.pk);
     }
 
-    batchVerifier.Verify();
+    if (maxBatchSize != 0) {
+        CBLSBatchSizeController sizeController(1, maxBatchSize);
+        batchVerifier.Verify(nullptr, &sizeController);
+    } else {
+        batchVerifier.Verify();
+    }
 
     BOOST_CHECK(batchVerifier.badSources == expectedBadSources);
 
@@ -109,6 +114,10 @@ static void Verify(std::vector<Message>& vec)
     Verify(vec, true, false);
     Verify(vec, false, true);
     Verify(vec, true, true);
+
+    // split into sub batches
+    Verify(vec, false, true, 1);
+    Verify(vec, true, true, 2);
 }
 
 BOOST_AUTO_TEST_CASE(batch_verifier_tests)
@@ -154,4 +163,16 @@ BOOST_AUTO_TEST_CASE(batch_verifier_tests)
     Verify(msgs);
 }
 
+BOOST_AUTO_TEST_CASE(batch_verifier_bisect_tests)
+{
+    std::vector<Message> msgs;
+
+    // many sources with a few bad ones spread over the batch, so that bisection has to go down both halves
+    for (uint32_t i = 0; i < 37; i++) {
+        AddMessage(msgs, i, i * 2, i % 5, (i % 11) != 3);
+        AddMessage(msgs, i, i * 2 + 1, 100 + i, (i % 13) != 7);
+    }
+    Verify(msgs);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,8 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "test/test_jemcash.h"
+#include "test/test_random.h"
 
 #include "bls/bls.h"
+#include "evo/deterministicmns.h"
 #include "evo/simplifiedmns.h"
 #include "netbase.h"
 
@@ -70,4 +72,66 @@ BOOST_AUTO_TEST_CASE(simplifiedmns_merkleroots)
 
     BOOST_CHECK(expectedMerkleRoot == calculatedMerkleRoot);
 }
+
+static CDeterministicMNCPtr MakeDMN(uint64_t internalId)
+{
+    auto state = std::make_shared<CDeterministicMNState>();
+    state->confirmedHash = GetRandHash();
+    state->keyIDOwner.SetHex(strprintf("%040x", internalId));
+    auto dmn = std::make_shared<CDeterministicMN>();
+    dmn->proTxHash = GetRandHash();
+    dmn->internalId = internalId;
+    dmn->collateralOutpoint = COutPoint(dmn->proTxHash, 0);
+    dmn->pdmnState = state;
+    return dmn;
+}
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_merkletree_incremental)
+{
+    CSimplifiedMNListMerkleTree tree;
+    CDeterministicMNList mnList;
+    uint64_t nextId = 0;
+
+    auto checkRoot = [&](const CDeterministicMNList& list) {
+        bool mutated1 = false, mutated2 = false;
+        uint256 expected = CSimplifiedMNList(list).CalcMerkleRoot(&mutated1);
+        BOOST_CHECK(tree.CalcMerkleRoot(list, &mutated2) == expected);
+        BOOST_CHECK(mutated1 == mutated2);
+    };
+
+    checkRoot(mnList);
+    for (size_t i = 0; i < 17; i++) {
+        mnList.AddMN(MakeDMN(nextId++));
+        checkRoot(mnList);
+    }
+
+    // update, remove and add entries in different combinations
+    for (size_t round = 0; round < 20; round++) {
+        CDeterministicMNList prevList = mnList;
+        std::vector<CDeterministicMNCPtr> dmns;
+        mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+            dmns.emplace_back(dmn);
+        });
+        auto dmn = dmns[insecure_rand() % dmns.size()];
+        auto newState = std::make_shared<CDeterministicMNState>(*dmn->pdmnState);
+        newState->nPoSeBanHeight = round;
+        mnList.UpdateMN(dmn, newState);
+        if (round % 3 == 0) {
+            mnList.RemoveMN(dmns[insecure_rand() % dmns.size()]->proTxHash);
+        }
+        if (round % 2 == 0) {
+            mnList.AddMN(MakeDMN(nextId++));
+        }
+        checkRoot(mnList);
+
+        // going back to an older list (e.g. a reorg) must work as well
+        if (round % 5 == 0) {
+            checkRoot(prevList);
+            checkRoot(mnList);
+        }
+    }
+
+    checkRoot(CDeterministicMNList());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "governance-db.h"
+#include "governance-object.h"
+#include "governance-votedb.h"
+#include "random.h"
+
+#include "test/test_jemcash.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(governance_db_tests, BasicTestingSetup)
+
+static CGovernanceVote CreateVote(const COutPoint& mnOutpoint, const uint256& nParentHash, vote_outcome_enum_t eOutcome, int64_t nTime)
+{
+    CGovernanceVote vote(mnOutpoint, nParentHash, VOTE_SIGNAL_FUNDING, eOutcome);
+    vote.SetTime(nTime);
+    return vote;
+}
+
+BOOST_AUTO_TEST_CASE(votefile_replaced_votes)
+{
+    uint256 nParentHash = GetRandHash();
+    COutPoint mnOutpoint1(GetRandHash(), 0);
+    COutPoint mnOutpoint2(GetRandHash(), 0);
+
+    CGovernanceObjectVoteFile fileVotes;
+    auto vote1 = CreateVote(mnOutpoint1, nParentHash, VOTE_OUTCOME_YES, 1000);
+    auto vote2 = CreateVote(mnOutpoint2, nParentHash, VOTE_OUTCOME_YES, 1000);
+    BOOST_CHECK(fileVotes.AddVote(vote1).empty());
+    BOOST_CHECK(fileVotes.AddVote(vote2).empty());
+
+    // a newer vote from the same masternode replaces the older one
+    auto vote3 = CreateVote(mnOutpoint1, nParentHash, VOTE_OUTCOME_NO, 2000);
+    auto replaced = fileVotes.AddVote(vote3);
+    BOOST_CHECK(replaced == std::set<uint256>{vote1.GetHash()});
+    BOOST_CHECK_EQUAL(fileVotes.GetVoteCount(), 2);
+
+    auto removed = fileVotes.RemoveVotesFromMasternode(mnOutpoint2);
+    BOOST_CHECK(removed == std::set<uint256>{vote2.GetHash()});
+    BOOST_CHECK_EQUAL(fileVotes.GetVoteCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(governance_db_roundtrip)
+{
+    CGovernanceDb db(1 << 20, true, true);
+    BOOST_CHECK(!db.HasCurrentVersion());
+    db.WriteCurrentVersion();
+    BOOST_CHECK(db.HasCurrentVersion());
+
+    CGovernanceObject govobj1(uint256(), 1, 1000, GetRandHash(), "00");
+    CGovernanceObject govobj2(uint256(), 1, 2000, GetRandHash(), "00");
+    uint256 nHash1 = govobj1.GetHash();
+    uint256 nHash2 = govobj2.GetHash();
+
+    COutPoint mnOutpoint(GetRandHash(), 0);
+    auto vote1 = CreateVote(mnOutpoint, nHash1, VOTE_OUTCOME_YES, 1000);
+    auto vote2 = CreateVote(mnOutpoint, nHash2, VOTE_OUTCOME_NO, 1000);
+    vote_rec_t voteRecord;
+    voteRecord.mapInstances.emplace(VOTE_SIGNAL_FUNDING, vote_instance_t(VOTE_OUTCOME_YES, 1000, 1000));
+
+    {
+        CDBBatch batch(db.GetRawDB());
+        db.WriteObject(batch, govobj1);
+        db.WriteObject(batch, govobj2);
+        db.WriteVote(batch, vote1);
+        db.WriteVote(batch, vote2);
+        db.WriteVoteRecord(batch, nHash1, mnOutpoint, voteRecord);
+        db.WriteVoteRecord(batch, nHash2, mnOutpoint, voteRecord);
+        db.WriteBatch(batch);
+    }
+
+    std::set<uint256> objects;
+    db.ForEachObject([&](CGovernanceObject& govobj) {
+        objects.emplace(govobj.GetHash());
+    });
+    BOOST_CHECK(objects == std::set<uint256>({nHash1, nHash2}));
+
+    auto votes = db.ReadVotes(nHash1);
+    BOOST_CHECK_EQUAL(votes.size(), 1);
+    BOOST_CHECK(votes[0].GetHash() == vote1.GetHash());
+    BOOST_CHECK(db.HasVote(nHash1, vote1.GetHash()));
+    BOOST_CHECK(!db.HasVote(nHash1, vote2.GetHash()));
+
+    CGovernanceVote vote;
+    BOOST_CHECK(db.ReadVote(nHash2, vote2.GetHash(), vote));
+    BOOST_CHECK(vote.GetHash() == vote2.GetHash());
+
+    // erasing an object erases its votes and vote records, but nothing of other objects
+    {
+        CDBBatch batch(db.GetRawDB());
+        db.EraseObject(batch, nHash1);
+        db.WriteBatch(batch);
+    }
+
+    objects.clear();
+    db.ForEachObject([&](CGovernanceObject& govobj) {
+        objects.emplace(govobj.GetHash());
+    });
+    BOOST_CHECK(objects == std::set<uint256>({nHash2}));
+    BOOST_CHECK(db.ReadVotes(nHash1).empty());
+    BOOST_CHECK_EQUAL(db.ReadVotes(nHash2).size(), 1);
+
+    size_t nVoteRecords = 0;
+    db.ForEachVoteRecord([&](const uint256& nParentHash, const COutPoint& outpoint, const vote_rec_t& rec) {
+        BOOST_CHECK(nParentHash == nHash2);
+        BOOST_CHECK(outpoint == mnOutpoint);
+        nVoteRecords++;
+    });
+    BOOST_CHECK_EQUAL(nVoteRecords, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,35 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "governance-vote.h"
+#include "random.h"
+#include "timedata.h"
+
+#include "test/test_jemcash.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(governance_vote_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(batchverifier_unknown_masternode)
+{
+    // the MN list of the test setup is empty, so no masternode is known
+    CGovernanceVote vote1(COutPoint(GetRandHash(), 0), GetRandHash(), VOTE_SIGNAL_FUNDING, VOTE_OUTCOME_YES);
+    vote1.SetTime(GetAdjustedTime());
+    vote1.SetSignature(std::vector<unsigned char>(65, 0));
+    CGovernanceVote vote2(COutPoint(GetRandHash(), 1), GetRandHash(), VOTE_SIGNAL_DELETE, VOTE_OUTCOME_NO);
+    vote2.SetTime(GetAdjustedTime());
+    vote2.SetSignature(std::vector<unsigned char>(96, 0));
+
+    CGovernanceVoteBatchVerifier verifier;
+    verifier.PushVote(vote1, true);
+    verifier.PushVote(vote2, false);
+    verifier.Verify();
+
+    // votes of unknown masternodes are neither valid nor invalid, they are orphaned when processed
+    BOOST_CHECK(verifier.mapValidVotes.empty());
+    BOOST_CHECK(verifier.setInvalidVotes.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
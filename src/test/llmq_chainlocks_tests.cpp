@@ -0,0 +1,158 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "llmq/quorums_chainlocks.h"
+#include "random.h"
+
+#include "test/test_jemcash.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace llmq;
+
+BOOST_FIXTURE_TEST_SUITE(llmq_chainlocks_tests, BasicTestingSetup)
+
+static const int64_t WINDOW = 10 * 60;
+
+BOOST_AUTO_TEST_CASE(txtracker_expiry)
+{
+    CChainLocksTxTracker tracker(WINDOW, 1000);
+    int64_t nTime = 1000000;
+
+    uint256 txid1 = GetRandHash();
+    uint256 txid2 = GetRandHash();
+    uint256 blockHash = GetRandHash();
+    BOOST_CHECK(tracker.AddTx(txid1, nTime));
+    BOOST_CHECK(!tracker.AddTx(txid1, nTime + 10));
+    BOOST_CHECK(tracker.AddTx(txid2, nTime + 5 * 60));
+    BOOST_CHECK(tracker.AddBlock(blockHash, nTime, 1));
+    BOOST_CHECK(tracker.AddBlockTx(blockHash, txid1));
+
+    int64_t nFirstSeenTime;
+    bool fLocked;
+    BOOST_CHECK(tracker.GetTx(txid1, nFirstSeenTime, fLocked));
+    BOOST_CHECK_EQUAL(nFirstSeenTime, nTime);
+    BOOST_CHECK(!fLocked);
+    tracker.SetTxLocked(txid1);
+    BOOST_CHECK(tracker.GetTx(txid1, nFirstSeenTime, fLocked) && fLocked);
+
+    CChainLocksTxTracker::TxIdsPtr txids;
+    int64_t nConnectedTimeMicros;
+    BOOST_CHECK(tracker.GetBlock(blockHash, txids, nConnectedTimeMicros));
+    BOOST_CHECK(txids->count(txid1));
+    BOOST_CHECK_EQUAL(nConnectedTimeMicros, 1);
+
+    // nothing expires before the window has passed
+    tracker.Expire(nTime + WINDOW);
+    BOOST_CHECK(tracker.GetTx(txid1, nFirstSeenTime, fLocked));
+    BOOST_CHECK_EQUAL(tracker.GetBlockCount(), 1);
+
+    tracker.Expire(nTime + WINDOW + CChainLocksTxTracker::BUCKET_SECONDS);
+    BOOST_CHECK(!tracker.GetTx(txid1, nFirstSeenTime, fLocked));
+    BOOST_CHECK(!tracker.GetBlock(blockHash, txids, nConnectedTimeMicros));
+    BOOST_CHECK(tracker.GetTx(txid2, nFirstSeenTime, fLocked));
+    BOOST_CHECK_EQUAL(tracker.GetTxCount(), 1);
+
+    // TXs which are older than the window are not tracked at all
+    BOOST_CHECK(!tracker.AddTx(GetRandHash(), nTime));
+
+    tracker.Expire(nTime + 2 * WINDOW);
+    BOOST_CHECK_EQUAL(tracker.GetTxCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(txtracker_limit)
+{
+    CChainLocksTxTracker tracker(WINDOW, 10);
+    int64_t nTime = 1000000;
+
+    std::vector<uint256> oldTxids;
+    for (int i = 0; i < 5; i++) {
+        oldTxids.emplace_back(GetRandHash());
+        BOOST_CHECK(tracker.AddTx(oldTxids.back(), nTime));
+    }
+    for (int i = 0; i < 5; i++) {
+        BOOST_CHECK(tracker.AddTx(GetRandHash(), nTime + CChainLocksTxTracker::BUCKET_SECONDS));
+    }
+    BOOST_CHECK_EQUAL(tracker.GetTxCount(), 10);
+
+    // the oldest bucket is dropped to make room
+    BOOST_CHECK(tracker.AddTx(GetRandHash(), nTime + CChainLocksTxTracker::BUCKET_SECONDS));
+    BOOST_CHECK_EQUAL(tracker.GetTxCount(), 6);
+    BOOST_CHECK_EQUAL(tracker.GetEvictedBucketCount(), 1);
+    int64_t nFirstSeenTime;
+    bool fLocked;
+    for (auto& txid : oldTxids) {
+        BOOST_CHECK(!tracker.GetTx(txid, nFirstSeenTime, fLocked));
+    }
+
+    // the current bucket is never dropped
+    for (int i = 0; i < 4; i++) {
+        BOOST_CHECK(tracker.AddTx(GetRandHash(), nTime + CChainLocksTxTracker::BUCKET_SECONDS));
+    }
+    BOOST_CHECK(!tracker.AddTx(GetRandHash(), nTime + CChainLocksTxTracker::BUCKET_SECONDS));
+    BOOST_CHECK_EQUAL(tracker.GetTxCount(), 10);
+    BOOST_CHECK(tracker.GetMemoryUsage() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(txtracker_limit_fails_closed)
+{
+    CChainLocksTxTracker tracker(WINDOW, 10);
+    int64_t nTime = 1000000;
+
+    uint256 evictedTxid = GetRandHash();
+    BOOST_CHECK(tracker.AddTx(evictedTxid, nTime));
+    BOOST_CHECK(tracker.IsComplete(nTime));
+    BOOST_CHECK(!tracker.IsTxSafe(evictedTxid, nTime));
+    // unknown TXs are safe as long as nothing was dropped
+    BOOST_CHECK(tracker.IsTxSafe(GetRandHash(), nTime));
+
+    // flood the tracker, which drops the first bucket and then rejects new TXs
+    nTime += CChainLocksTxTracker::BUCKET_SECONDS;
+    std::vector<uint256> floodTxids;
+    for (int i = 0; i < 10; i++) {
+        floodTxids.emplace_back(GetRandHash());
+        BOOST_CHECK(tracker.AddTx(floodTxids.back(), nTime));
+    }
+    uint256 rejectedTxid = GetRandHash();
+    BOOST_CHECK(!tracker.AddTx(rejectedTxid, nTime));
+    BOOST_CHECK_EQUAL(tracker.GetEvictedBucketCount(), 1);
+
+    // neither the dropped nor the rejected TX may look old enough, and neither may any other unknown TX
+    BOOST_CHECK(!tracker.IsComplete(nTime));
+    BOOST_CHECK(!tracker.IsTxSafe(evictedTxid, nTime));
+    BOOST_CHECK(!tracker.IsTxSafe(rejectedTxid, nTime));
+    BOOST_CHECK(!tracker.IsTxSafe(GetRandHash(), nTime));
+
+    // an ixlock makes a tracked TX safe right away
+    BOOST_CHECK(!tracker.IsTxSafe(floodTxids[0], nTime));
+    tracker.SetTxLocked(floodTxids[0]);
+    BOOST_CHECK(tracker.IsTxSafe(floodTxids[0], nTime));
+
+    // once the window passed, everything that was dropped is old enough
+    nTime += WINDOW + CChainLocksTxTracker::BUCKET_SECONDS;
+    tracker.Expire(nTime);
+    BOOST_CHECK(tracker.IsComplete(nTime));
+    BOOST_CHECK(tracker.IsTxSafe(evictedTxid, nTime));
+    BOOST_CHECK(tracker.IsTxSafe(rejectedTxid, nTime));
+    BOOST_CHECK_EQUAL(tracker.GetTxCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(txtracker_incomplete_block)
+{
+    CChainLocksTxTracker tracker(WINDOW, 3);
+    int64_t nTime = 1000000;
+
+    uint256 blockHash = GetRandHash();
+    BOOST_CHECK(tracker.AddBlock(blockHash, nTime, 1));
+    BOOST_CHECK(tracker.AddBlockTx(blockHash, GetRandHash()));
+    BOOST_CHECK(tracker.AddBlockTx(blockHash, GetRandHash()));
+    // a block with missing TXs must not be returned at all
+    BOOST_CHECK(!tracker.AddBlockTx(blockHash, GetRandHash()));
+    CChainLocksTxTracker::TxIdsPtr txids;
+    int64_t nConnectedTimeMicros;
+    BOOST_CHECK(!tracker.GetBlock(blockHash, txids, nConnectedTimeMicros));
+    BOOST_CHECK(!tracker.IsComplete(nTime));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
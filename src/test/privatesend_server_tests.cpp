@@ -0,0 +1,82 @@
+// Copyright (c) 2019 The Jemcash Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "privatesend-server.h"
+#include "random.h"
+#include "timedata.h"
+#include "util.h"
+
+#include "test/test_jemcash.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(privatesend_server_tests, TestingSetup)
+
+static CPrivateSendAccept MakeAccept(int nDenom)
+{
+    CMutableTransaction txCollateral;
+    txCollateral.vin.resize(1);
+    txCollateral.vin[0].prevout = COutPoint(GetRandHash(), 0);
+    return CPrivateSendAccept(nDenom, txCollateral);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_sessions)
+{
+    fMasternodeMode = true;
+
+    PoolMessage nMessageID;
+    CPrivateSendQueue dsq;
+    CPrivateSendServerSession session1(true);
+    CPrivateSendServerSession session2(true);
+    BOOST_CHECK(session1.CreateNewSession(1, MakeAccept(1), false, nMessageID, *g_connman, dsq));
+    BOOST_CHECK(session2.CreateNewSession(2, MakeAccept(2), false, nMessageID, *g_connman, dsq));
+    BOOST_CHECK_EQUAL(session1.GetSessionID(), 1);
+    BOOST_CHECK_EQUAL(session2.GetSessionID(), 2);
+
+    // users only join sessions of their own denomination
+    BOOST_CHECK(!session1.AddUserToExistingSession(MakeAccept(2), nMessageID));
+    BOOST_CHECK_EQUAL(nMessageID, ERR_DENOM);
+
+    int nUsers = 1;
+    while (!session1.IsSessionReady() && nUsers < CPrivateSend::GetMaxPoolParticipants()) {
+        BOOST_CHECK(session1.AddUserToExistingSession(MakeAccept(1), nMessageID));
+        nUsers++;
+    }
+    BOOST_CHECK(session1.IsSessionReady());
+    BOOST_CHECK(nUsers >= CPrivateSend::GetMinPoolParticipants());
+    // a full session takes no more users
+    BOOST_CHECK(!session1.AddUserToExistingSession(MakeAccept(1), nMessageID));
+
+    // only the full session gets ready, the other one keeps waiting for users
+    CPrivateSendQueue dsqReady;
+    BOOST_CHECK(session1.CheckForCompleteQueue(dsqReady));
+    BOOST_CHECK(dsqReady.fReady);
+    BOOST_CHECK_EQUAL(dsqReady.nDenom, 1);
+    BOOST_CHECK_EQUAL(session1.GetState(), POOL_STATE_ACCEPTING_ENTRIES);
+    BOOST_CHECK(!session1.CheckForCompleteQueue(dsqReady));
+
+    BOOST_CHECK(!session2.CheckForCompleteQueue(dsqReady));
+    BOOST_CHECK_EQUAL(session2.GetState(), POOL_STATE_QUEUE);
+    BOOST_CHECK(session2.AddUserToExistingSession(MakeAccept(2), nMessageID));
+
+    fMasternodeMode = false;
+}
+
+BOOST_AUTO_TEST_CASE(queue_overlap)
+{
+    COutPoint mnOutpoint(GetRandHash(), 0);
+    int64_t nTime = GetAdjustedTime();
+    CPrivateSendQueue dsq(1, mnOutpoint, nTime, false);
+
+    // one public queue per masternode at a time, whatever its denomination is
+    BOOST_CHECK(CPrivateSendQueue(2, mnOutpoint, nTime + 1, false).OverlapsWith(dsq));
+    BOOST_CHECK(CPrivateSendQueue(1, mnOutpoint, nTime - 1, false).OverlapsWith(dsq));
+    BOOST_CHECK(!CPrivateSendQueue(2, mnOutpoint, nTime + PRIVATESEND_QUEUE_TIMEOUT, false).OverlapsWith(dsq));
+
+    // other masternodes and ready queues are independent
+    BOOST_CHECK(!CPrivateSendQueue(1, COutPoint(GetRandHash(), 0), nTime, false).OverlapsWith(dsq));
+    BOOST_CHECK(!CPrivateSendQueue(1, mnOutpoint, nTime, true).OverlapsWith(dsq));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
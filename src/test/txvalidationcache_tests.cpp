@@ -84,4 +84,85 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_block_doublespend, TestChain100Setup)
     BOOST_CHECK_EQUAL(mempool.size(), 0);
 }
 
+BOOST_FIXTURE_TEST_CASE(checkinputs_test, TestChain100Setup)
+{
+    // Test that passing CheckInputs with one set of script flags doesn't imply
+    // that we would pass again with a different set of flags, and that only
+    // fully executed and successful checks are cached.
+    CScript scriptPubKey = CScript() <<  ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    CMutableTransaction spend_tx;
+    spend_tx.nVersion = 1;
+    spend_tx.vin.resize(1);
+    spend_tx.vin[0].prevout.hash = coinbaseTxns[0].GetHash();
+    spend_tx.vin[0].prevout.n = 0;
+    spend_tx.vout.resize(1);
+    spend_tx.vout[0].nValue = 11*CENT;
+    spend_tx.vout[0].scriptPubKey = scriptPubKey;
+
+    CMutableTransaction invalid_tx = spend_tx;
+    invalid_tx.vout[0].nValue = 12*CENT;
+
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(scriptPubKey, spend_tx, 0, SIGHASH_ALL);
+    BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    spend_tx.vin[0].scriptSig << vchSig;
+    // signed for another transaction
+    invalid_tx.vin[0].scriptSig << vchSig;
+
+    LOCK(cs_main);
+    InitScriptExecutionCache();
+
+    CCoinsViewCache inputs(pcoinsTip);
+    const CTransaction tx(spend_tx);
+    const unsigned int flags = SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_STRICTENC;
+    uint64_t nLookups, nHits, nLookupsPrev, nHitsPrev;
+    CValidationState state;
+
+    // Deferred checks are not executed by CheckInputs, so nothing is cached for them
+    std::vector<CScriptCheck> vChecks;
+    BOOST_CHECK(CheckInputs(tx, state, inputs, true, flags, true, true, &vChecks));
+    BOOST_CHECK_EQUAL(vChecks.size(), 1);
+    GetScriptExecutionCacheStats(nLookupsPrev, nHitsPrev);
+    vChecks.clear();
+    BOOST_CHECK(CheckInputs(tx, state, inputs, true, flags, true, true, &vChecks));
+    BOOST_CHECK_EQUAL(vChecks.size(), 1);
+    GetScriptExecutionCacheStats(nLookups, nHits);
+    BOOST_CHECK_EQUAL(nLookups, nLookupsPrev + 1);
+    BOOST_CHECK_EQUAL(nHits, nHitsPrev);
+
+    // Executed checks are cached for the flags they were executed with
+    BOOST_CHECK(CheckInputs(tx, state, inputs, true, flags, true, true, NULL));
+    vChecks.clear();
+    BOOST_CHECK(CheckInputs(tx, state, inputs, true, flags, true, true, &vChecks));
+    BOOST_CHECK(vChecks.empty());
+    GetScriptExecutionCacheStats(nLookupsPrev, nHitsPrev);
+    BOOST_CHECK_EQUAL(nHitsPrev, nHits + 1);
+
+    // ... but not for any other flags
+    BOOST_CHECK(CheckInputs(tx, state, inputs, true, SCRIPT_VERIFY_P2SH, true, true, &vChecks));
+    BOOST_CHECK_EQUAL(vChecks.size(), 1);
+    GetScriptExecutionCacheStats(nLookups, nHits);
+    BOOST_CHECK_EQUAL(nHits, nHitsPrev);
+
+    // A lookup without cacheFullScriptStore (as in ConnectBlock) uses up the entry
+    BOOST_CHECK(CheckInputs(tx, state, inputs, true, flags, true, false, NULL));
+    GetScriptExecutionCacheStats(nLookupsPrev, nHitsPrev);
+    BOOST_CHECK_EQUAL(nHitsPrev, nHits + 1);
+    vChecks.clear();
+    BOOST_CHECK(CheckInputs(tx, state, inputs, true, flags, true, false, &vChecks));
+    BOOST_CHECK_EQUAL(vChecks.size(), 1);
+
+    // Failures are never cached
+    const CTransaction txInvalid(invalid_tx);
+    for (int i = 0; i < 2; i++) {
+        CValidationState stateInvalid;
+        BOOST_CHECK(!CheckInputs(txInvalid, stateInvalid, inputs, true, flags, true, true, NULL));
+        BOOST_CHECK_EQUAL(stateInvalid.GetRejectReason(), "mandatory-script-verify-flag-failed (Script evaluated without error but finished with a false/empty top stack element)");
+    }
+    GetScriptExecutionCacheStats(nLookups, nHits);
+    BOOST_CHECK_EQUAL(nHits, nHitsPrev);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -698,6 +698,8 @@ public:
 
     boost::signals2::signal<void (CTransactionRef)> NotifyEntryAdded;
     boost::signals2::signal<void (CTransactionRef, MemPoolRemovalReason)> NotifyEntryRemoved;
+    /** Fired when PrioritiseTransaction changed the modified fees of a mempool entry (and its ancestors/descendants) */
+    boost::signals2::signal<void (const uint256&)> NotifyEntryPrioritised;
 
 private:
     /** UpdateForDescendants is used by UpdateTransactionsFromBlock to update
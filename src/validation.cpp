@@ -16,6 +16,7 @@
 #include "consensus/consensus.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
+#include "cuckoocache.h"
 #include "hash.h"
 #include "init.h"
 #include "policy/policy.h"
@@ -108,6 +109,7 @@ CTxMemPool mempool;
 std::map<uint256, int64_t> mapRejectedBlocks GUARDED_BY(cs_main);
 
 static void CheckBlockIndex(const Consensus::Params& consensusParams);
+static unsigned int GetBlockScriptFlags(const CBlockIndex* pindex, const Consensus::Params& consensusparams);
 
 /** Constant stuff for coinbase transactions we create: */
 CScript COINBASE_FLAGS;
@@ -666,7 +668,8 @@ static bool IsCurrentForFeeEstimation()
 
 bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const CTransactionRef& ptx, bool fLimitFree,
                               bool* pfMissingInputs, int64_t nAcceptTime, bool fOverrideMempoolLimit,
-                              const CAmount& nAbsurdFee, std::vector<COutPoint>& coins_to_uncache, bool fDryRun)
+                              const CAmount& nAbsurdFee, std::vector<COutPoint>& coins_to_uncache, bool fDryRun,
+                              std::vector<CScriptCheck>* pvScriptChecks = NULL)
 {
     const CTransaction& tx = *ptx;
     const uint256 hash = tx.GetHash();
@@ -1033,13 +1036,24 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
         // If we aren't going to actually accept it but just were verifying it, we are fine already
         if(fDryRun) return true;
 
+        // Leave the script checks to the caller, see AcceptToMemoryPoolBatch()
+        if (pvScriptChecks) {
+            return CheckInputs(tx, state, view, true, STANDARD_SCRIPT_VERIFY_FLAGS, true, false, pvScriptChecks);
+        }
+
         // Check against previous transactions
         // This is done last to help prevent CPU exhaustion denial-of-service attacks.
-        if (!CheckInputs(tx, state, view, true, STANDARD_SCRIPT_VERIFY_FLAGS, true))
+        if (!CheckInputs(tx, state, view, true, STANDARD_SCRIPT_VERIFY_FLAGS, true, false))
             return false; // state filled in by CheckInputs
 
-        // Check again against just the consensus-critical mandatory script
-        // verification flags, in case of bugs in the standard flags that cause
+        // Check again against the current block tip's script verification
+        // flags to cache our script execution flags. This is, of course,
+        // useless if the next block has different script flags from the
+        // previous one, but because the cache tracks script flags for us it
+        // will auto-invalidate and we'll just have a few blocks of extra
+        // misses on soft-fork activation.
+        //
+        // This is also useful in case of bugs in the standard flags that cause
         // transactions to pass as valid when they're actually invalid. For
         // instance the STRICTENC flag was incorrectly allowing certain
         // CHECKSIG NOT scripts to pass, even though they were invalid.
@@ -1047,9 +1061,10 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
         // There is a similar check in CreateNewBlock() to prevent creating
         // invalid blocks, however allowing such transactions into the mempool
         // can be exploited as a DoS attack.
-        if (!CheckInputs(tx, state, view, true, MANDATORY_SCRIPT_VERIFY_FLAGS, true))
+        unsigned int currentBlockScriptVerifyFlags = GetBlockScriptFlags(chainActive.Tip(), Params().GetConsensus());
+        if (!CheckInputs(tx, state, view, true, currentBlockScriptVerifyFlags, true, true))
         {
-            return error("%s: BUG! PLEASE REPORT THIS! ConnectInputs failed against MANDATORY but not STANDARD flags %s, %s",
+            return error("%s: BUG! PLEASE REPORT THIS! ConnectInputs failed against block but not STANDARD flags %s, %s",
                 __func__, hash.ToString(), FormatStateMessage(state));
         }
 
@@ -1581,7 +1596,28 @@ bool CheckTxInputs(const CTransaction& tx, CValidationState& state, const CCoins
 }
 }// namespace Consensus
 
-bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheStore, std::vector<CScriptCheck> *pvChecks)
+static CuckooCache::cache<uint256, SignatureCacheHasher> scriptExecutionCache;
+static uint256 scriptExecutionCacheNonce(GetRandHash());
+static uint64_t nScriptExecutionCacheLookups = 0;
+static uint64_t nScriptExecutionCacheHits = 0;
+
+void InitScriptExecutionCache() {
+    // nMaxCacheSize is unsigned. If -maxsigcachesize is set to zero,
+    // setup_bytes creates the minimum possible cache (2 elements).
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, GetArg("-maxsigcachesize", DEFAULT_MAX_SIG_CACHE_SIZE) / 2), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = scriptExecutionCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for script execution cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+void GetScriptExecutionCacheStats(uint64_t& nLookupsRet, uint64_t& nHitsRet)
+{
+    LOCK(cs_main);
+    nLookupsRet = nScriptExecutionCacheLookups;
+    nHitsRet = nScriptExecutionCacheHits;
+}
+
+bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, std::vector<CScriptCheck> *pvChecks)
 {
     if (!tx.IsCoinBase())
     {
@@ -1601,6 +1637,24 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
         // Of course, if an assumed valid block is invalid due to false scriptSigs
         // this optimization would allow an invalid chain to be accepted.
         if (fScriptChecks) {
+            // First check if script executions have been cached with the same
+            // flags. Note that this assumes that the inputs provided are
+            // correct (ie that the transaction hash which is in tx's prevouts
+            // properly commits to the scriptPubKey in the inputs view of that
+            // transaction).
+            uint256 hashCacheEntry;
+            // We only use the first 19 bytes of nonce to avoid a second SHA
+            // round - giving us 19 + 32 + 4 = 55 bytes (+ 8 + 1 = 64)
+            static_assert(55 - sizeof(flags) - 32 >= 128/8, "Want at least 128 bits of nonce for script execution cache");
+            CSHA256().Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32).Write(tx.GetHash().begin(), 32).Write((unsigned char*)&flags, sizeof(flags)).Finalize(hashCacheEntry.begin());
+            // scriptExecutionCache and its counters are guarded by cs_main
+            AssertLockHeld(cs_main);
+            nScriptExecutionCacheLookups++;
+            if (scriptExecutionCache.contains(hashCacheEntry, !cacheFullScriptStore)) {
+                nScriptExecutionCacheHits++;
+                return true;
+            }
+
             for (unsigned int i = 0; i < tx.vin.size(); i++) {
                 const COutPoint &prevout = tx.vin[i].prevout;
                 const Coin& coin = inputs.AccessCoin(prevout);
@@ -1617,7 +1671,7 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
                     continue;
 
                 // Verify signature
-                CScriptCheck check(scriptPubKey, amount, tx, i, flags, cacheStore);
+                CScriptCheck check(scriptPubKey, amount, tx, i, flags, cacheSigStore);
                 if (pvChecks) {
                     pvChecks->push_back(CScriptCheck());
                     check.swap(pvChecks->back());
@@ -1630,7 +1684,7 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
                         // avoid splitting the network between upgraded and
                         // non-upgraded nodes.
                         CScriptCheck check2(scriptPubKey, amount, tx, i,
-                                flags & ~STANDARD_NOT_MANDATORY_VERIFY_FLAGS, cacheStore);
+                                flags & ~STANDARD_NOT_MANDATORY_VERIFY_FLAGS, cacheSigStore);
                         if (check2())
                             return state.Invalid(false, REJECT_NONSTANDARD, strprintf("non-mandatory-script-verify-flag (%s)", ScriptErrorString(check.GetScriptError())));
                     }
@@ -1647,6 +1701,12 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
                     return state.DoS(100,false, REJECT_INVALID, strprintf("mandatory-script-verify-flag-failed (%s)", ScriptErrorString(check.GetScriptError())));
                 }
             }
+
+            if (cacheFullScriptStore && !pvChecks) {
+                // We executed all of the provided scripts, and were told to
+                // cache the result. Do so now.
+                scriptExecutionCache.insert(hashCacheEntry);
+            }
         }
     }
 
@@ -1967,11 +2027,101 @@ bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos, unsigne
 
 static CCheckQueue<CScriptCheck> scriptcheckqueue(128);
 
+static unsigned int GetBlockScriptFlags(const CBlockIndex* pindex, const Consensus::Params& consensusparams)
+{
+    AssertLockHeld(cs_main);
+
+    // BIP16 didn't become active until Apr 1 2012
+    int64_t nBIP16SwitchTime = 1333238400;
+    bool fStrictPayToScriptHash = (pindex->GetBlockTime() >= nBIP16SwitchTime);
+
+    unsigned int flags = fStrictPayToScriptHash ? SCRIPT_VERIFY_P2SH : SCRIPT_VERIFY_NONE;
+
+    // Start enforcing the DERSIG (BIP66) rule
+    if (pindex->nHeight >= consensusparams.BIP66Height) {
+        flags |= SCRIPT_VERIFY_DERSIG;
+    }
+
+    // Start enforcing CHECKLOCKTIMEVERIFY (BIP65) rule
+    if (pindex->nHeight >= consensusparams.BIP65Height) {
+        flags |= SCRIPT_VERIFY_CHECKLOCKTIMEVERIFY;
+    }
+
+    // Start enforcing BIP112 (CHECKSEQUENCEVERIFY) using versionbits logic.
+    if (VersionBitsState(pindex->pprev, consensusparams, Consensus::DEPLOYMENT_CSV, versionbitscache) == THRESHOLD_ACTIVE) {
+        flags |= SCRIPT_VERIFY_CHECKSEQUENCEVERIFY;
+    }
+
+    if (VersionBitsState(pindex->pprev, consensusparams, Consensus::DEPLOYMENT_BIP147, versionbitscache) == THRESHOLD_ACTIVE) {
+        flags |= SCRIPT_VERIFY_NULLDUMMY;
+    }
+
+    return flags;
+}
+
 void ThreadScriptCheck() {
     RenameThread("jemcash-scriptch");
     scriptcheckqueue.Thread();
 }
 
+void AcceptToMemoryPoolBatch(CTxMemPool& pool, const std::vector<CTransactionRef>& vtx, const std::vector<int64_t>& vAcceptTime,
+                             bool fLimitFree, std::vector<bool>& vAcceptedRet, std::vector<CValidationState>& vStatesRet,
+                             std::vector<bool>& vMissingInputsRet)
+{
+    AssertLockHeld(cs_main);
+    assert(vAcceptTime.size() == vtx.size());
+
+    vAcceptedRet.assign(vtx.size(), false);
+    vStatesRet.assign(vtx.size(), CValidationState());
+    vMissingInputsRet.assign(vtx.size(), false);
+
+    // Transactions which failed the checks in front of the script checks, they are not looked at again
+    std::vector<bool> vRejected(vtx.size(), false);
+
+    if (nScriptCheckThreads && vtx.size() > 1) {
+        int64_t nTimeStart = GetTimeMicros();
+        size_t nPreChecked = 0;
+        size_t nChecks = 0;
+
+        CCheckQueueControl<CScriptCheck> control(&scriptcheckqueue);
+        for (size_t i = 0; i < vtx.size(); i++) {
+            std::vector<COutPoint> coins_to_uncache;
+            std::vector<CScriptCheck> vChecks;
+            bool fMissingInputs = false;
+            if (AcceptToMemoryPoolWorker(pool, vStatesRet[i], vtx[i], fLimitFree, &fMissingInputs, vAcceptTime[i], false, 0, coins_to_uncache, false, &vChecks)) {
+                nChecks += vChecks.size();
+                control.Add(vChecks);
+                nPreChecked++;
+            } else if (!fMissingInputs) {
+                // Rejections don't depend on transactions accepted before this one, except for missing inputs
+                vRejected[i] = true;
+                LogPrint("mempool", "%s: %s %s (%s)\n", __func__, vtx[i]->GetHash().ToString(), vStatesRet[i].GetRejectReason(), vStatesRet[i].GetDebugMessage());
+            }
+            // The script checks keep their own copy of the spent outputs
+            for (const COutPoint& outpoint : coins_to_uncache) {
+                pcoinsTip->Uncache(outpoint);
+            }
+        }
+        // A failure is not attributed to a transaction here. The scripts of all transactions passed are in the
+        // signature cache now, except for those of the invalid transaction (and maybe of some checks which were
+        // skipped after the failure), which are verified again by the serial acceptance below.
+        control.Wait();
+
+        LogPrint("bench", "    - Pre-verify mempool scripts: %u txs, %u checks: %.2fms\n",
+                 nPreChecked, nChecks, 0.001 * (GetTimeMicros() - nTimeStart));
+    }
+
+    for (size_t i = 0; i < vtx.size(); i++) {
+        if (vRejected[i]) {
+            continue;
+        }
+        bool fMissingInputs = false;
+        vStatesRet[i] = CValidationState();
+        vAcceptedRet[i] = AcceptToMemoryPoolWithTime(pool, vStatesRet[i], vtx[i], fLimitFree, &fMissingInputs, vAcceptTime[i]);
+        vMissingInputsRet[i] = fMissingInputs;
+    }
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2212,33 +2362,15 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
     /// END JEMCASH
 
-    // BIP16 didn't become active until Apr 1 2012
-    int64_t nBIP16SwitchTime = 1333238400;
-    bool fStrictPayToScriptHash = (pindex->GetBlockTime() >= nBIP16SwitchTime);
-
-    unsigned int flags = fStrictPayToScriptHash ? SCRIPT_VERIFY_P2SH : SCRIPT_VERIFY_NONE;
+    // Get the script flags for this block
+    unsigned int flags = GetBlockScriptFlags(pindex, chainparams.GetConsensus());
 
-    // Start enforcing the DERSIG (BIP66) rule
-    if (pindex->nHeight >= chainparams.GetConsensus().BIP66Height) {
-        flags |= SCRIPT_VERIFY_DERSIG;
-    }
-
-    // Start enforcing CHECKLOCKTIMEVERIFY (BIP65) rule
-    if (pindex->nHeight >= chainparams.GetConsensus().BIP65Height) {
-        flags |= SCRIPT_VERIFY_CHECKLOCKTIMEVERIFY;
-    }
-
-    // Start enforcing BIP68 (sequence locks) and BIP112 (CHECKSEQUENCEVERIFY) using versionbits logic.
+    // Start enforcing BIP68 (sequence locks) using versionbits logic.
     int nLockTimeFlags = 0;
     if (VersionBitsState(pindex->pprev, chainparams.GetConsensus(), Consensus::DEPLOYMENT_CSV, versionbitscache) == THRESHOLD_ACTIVE) {
-        flags |= SCRIPT_VERIFY_CHECKSEQUENCEVERIFY;
         nLockTimeFlags |= LOCKTIME_VERIFY_SEQUENCE;
     }
 
-    if (VersionBitsState(pindex->pprev, chainparams.GetConsensus(), Consensus::DEPLOYMENT_BIP147, versionbitscache) == THRESHOLD_ACTIVE) {
-        flags |= SCRIPT_VERIFY_NULLDUMMY;
-    }
-
     int64_t nTime2 = GetTimeMicros(); nTimeForks += nTime2 - nTime1;
     LogPrint("bench", "    - Fork checks: %.2fms [%.2fs]\n", 0.001 * (nTime2 - nTime1), nTimeForks * 0.000001);
 
@@ -2331,7 +2463,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
             }
 
-            if (fStrictPayToScriptHash)
+            if (flags & SCRIPT_VERIFY_P2SH)
             {
                 // Add in sigops done by pay-to-script-hash inputs;
                 // this is to prevent a "rogue miner" from creating
@@ -2350,7 +2482,7 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
             std::vector<CScriptCheck> vChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
-            if (!CheckInputs(tx, state, view, fScriptChecks, flags, fCacheResults, nScriptCheckThreads ? &vChecks : NULL))
+            if (!CheckInputs(tx, state, view, fScriptChecks, flags, fCacheResults, fCacheResults, nScriptCheckThreads ? &vChecks : NULL))
                 return error("ConnectBlock(): CheckInputs on %s failed with %s",
                              tx.GetHash().ToString(), FormatStateMessage(state));
             control.Add(vChecks);
@@ -4780,6 +4912,8 @@ int VersionBitsTipStateSinceHeight(const Consensus::Params& params, Consensus::D
 }
 
 static const uint64_t MEMPOOL_DUMP_VERSION = 1;
+/** Number of transactions from mempool.dat which are verified together in LoadMempool() */
+static const size_t MEMPOOL_LOAD_BATCH_SIZE = 100;
 
 bool LoadMempool(void)
 {
@@ -4809,29 +4943,42 @@ bool LoadMempool(void)
         }
         uint64_t num;
         file >> num;
-        while (num--) {
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> tx;
-            file >> nTime;
-            file >> nFeeDelta;
-
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta) {
-                mempool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+        while (num) {
+            // Read transactions in batches, so that their scripts can be verified in parallel
+            std::vector<CTransactionRef> vtx;
+            std::vector<int64_t> vTime;
+            while (num && vtx.size() < MEMPOOL_LOAD_BATCH_SIZE) {
+                num--;
+                CTransactionRef tx;
+                int64_t nTime;
+                int64_t nFeeDelta;
+                file >> tx;
+                file >> nTime;
+                file >> nFeeDelta;
+
+                CAmount amountdelta = nFeeDelta;
+                if (amountdelta) {
+                    mempool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                }
+                if (nTime + nExpiryTimeout > nNow) {
+                    vtx.emplace_back(tx);
+                    vTime.emplace_back(nTime);
+                } else {
+                    ++skipped;
+                }
             }
-            CValidationState state;
-            if (nTime + nExpiryTimeout > nNow) {
-                LOCK(cs_main);
-                AcceptToMemoryPoolWithTime(mempool, state, tx, true, NULL, nTime);
+
+            LOCK(cs_main);
+            std::vector<bool> vAccepted;
+            std::vector<CValidationState> vStates;
+            std::vector<bool> vMissingInputs;
+            AcceptToMemoryPoolBatch(mempool, vtx, vTime, true, vAccepted, vStates, vMissingInputs);
+            for (const auto& state : vStates) {
                 if (state.IsValid()) {
                     ++count;
                 } else {
                     ++failed;
                 }
-            } else {
-                ++skipped;
             }
             if (ShutdownRequested())
                 return false;
@@ -350,6 +350,17 @@ bool AcceptToMemoryPoolWithTime(CTxMemPool& pool, CValidationState &state, const
                                 bool* pfMissingInputs, int64_t nAcceptTime, bool fOverrideMempoolLimit=false,
                                 const CAmount nAbsurdFee=0, bool fDryRun=false);
 
+/**
+ * (try to) add a batch of transactions to the memory pool, in order.
+ * All checks of AcceptToMemoryPool() in front of the script checks are done for every transaction first, then the
+ * scripts of the transactions which passed them are verified at once on the script check threads. Transactions
+ * rejected before that are not looked at again, the others are accepted one by one like AcceptToMemoryPool() does,
+ * which then finds their signatures in the cache. The results are returned per transaction.
+ */
+void AcceptToMemoryPoolBatch(CTxMemPool& pool, const std::vector<CTransactionRef>& vtx, const std::vector<int64_t>& vAcceptTime,
+                             bool fLimitFree, std::vector<bool>& vAcceptedRet, std::vector<CValidationState>& vStatesRet,
+                             std::vector<bool>& vMissingInputsRet);
+
 bool GetUTXOCoin(const COutPoint& outpoint, Coin& coin);
 int GetUTXOHeight(const COutPoint& outpoint);
 int GetUTXOConfirmations(const COutPoint& outpoint);
@@ -384,9 +395,17 @@ unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& ma
  * Check whether all inputs of this transaction are valid (no double spends, scripts & sigs, amounts)
  * This does not modify the UTXO set. If pvChecks is not NULL, script checks are pushed onto it
  * instead of being performed inline.
+ * If cacheFullScriptStore is set and all scripts were checked inline, the result is stored in the
+ * script execution cache, so that later checks with the same flags can skip the transaction.
  */
 bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &view, bool fScriptChecks,
-                 unsigned int flags, bool cacheStore, std::vector<CScriptCheck> *pvChecks = NULL);
+                 unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, std::vector<CScriptCheck> *pvChecks = NULL);
+
+/** Initializes the script execution cache */
+void InitScriptExecutionCache();
+
+/** Number of lookups in the script execution cache and how many of them were hits */
+void GetScriptExecutionCacheStats(uint64_t& nLookupsRet, uint64_t& nHitsRet);
 
 /** Apply the effects of this transaction on the UTXO set represented by view */
 void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight);
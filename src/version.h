@@ -13,9 +13,9 @@
  */
 
 
-static const int PROTOCOL_VERSION = 70220;
+static const int PROTOCOL_VERSION = 70221;
 
-static const int LLMQS_PROTO_VERSION = PROTOCOL_VERSION;
+static const int LLMQS_PROTO_VERSION = 70220;
 
 //! initial proto version, to be increased after version/verack negotiation
 static const int INIT_PROTO_VERSION = 209;
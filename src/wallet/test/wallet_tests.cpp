@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include "privatesend.h"
 #include "rpc/server.h"
 #include "test/test_jemcash.h"
 #include "validation.h"
@@ -566,4 +567,42 @@ BOOST_AUTO_TEST_CASE(ComputeTimeSmart)
     SetMockTime(0);
 }
 
+
+static CWalletTx AddDenominatedTx(CWallet& wallet, const COutPoint& prevout, const std::vector<CAmount>& vecAmounts, const CScript& scriptPubKey)
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(prevout);
+    for (const auto& nAmount : vecAmounts) {
+        tx.vout.emplace_back(nAmount, scriptPubKey);
+    }
+    return CWalletTx(&wallet, MakeTransactionRef(tx));
+}
+
+// Rounds of outputs must be recomputed when a part of their ancestry shows up later, e.g. while rescanning
+BOOST_AUTO_TEST_CASE(privatesend_rounds_out_of_order)
+{
+    CPrivateSend::InitStandardDenominations();
+    CAmount nDenom = CPrivateSend::GetStandardDenominations()[1];
+
+    CWallet wallet;
+    CKey key;
+    key.MakeNewKey(true);
+    BOOST_CHECK(wallet.AddKeyPubKey(key, key.GetPubKey()));
+    CScript scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+    CWalletTx wtx0 = AddDenominatedTx(wallet, COutPoint(GetRandHash(), 0), {nDenom, 5 * COIN}, scriptPubKey);
+    CWalletTx wtx1 = AddDenominatedTx(wallet, COutPoint(wtx0.GetHash(), 0), {nDenom}, scriptPubKey);
+    CWalletTx wtx2 = AddDenominatedTx(wallet, COutPoint(wtx1.GetHash(), 0), {nDenom}, scriptPubKey);
+
+    wallet.AddToWallet(wtx0);
+    wallet.AddToWallet(wtx2);
+    BOOST_CHECK_EQUAL(wallet.GetRealOutpointPrivateSendRounds(COutPoint(wtx0.GetHash(), 0)), 0);
+    BOOST_CHECK_EQUAL(wallet.GetRealOutpointPrivateSendRounds(COutPoint(wtx0.GetHash(), 1)), -2);
+    BOOST_CHECK_EQUAL(wallet.GetRealOutpointPrivateSendRounds(COutPoint(wtx2.GetHash(), 0)), 0);
+
+    wallet.AddToWallet(wtx1);
+    BOOST_CHECK_EQUAL(wallet.GetRealOutpointPrivateSendRounds(COutPoint(wtx1.GetHash(), 0)), 1);
+    BOOST_CHECK_EQUAL(wallet.GetRealOutpointPrivateSendRounds(COutPoint(wtx2.GetHash(), 0)), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
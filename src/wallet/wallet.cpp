@@ -776,7 +776,7 @@ bool CWallet::IsSpent(const uint256& hash, unsigned int n) const
 void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid)
 {
     mapTxSpends.insert(std::make_pair(outpoint, wtxid));
-    setWalletUTXO.erase(outpoint);
+    RemoveFromWalletUTXO(outpoint);
 
     std::pair<TxSpends::iterator, TxSpends::iterator> range;
     range = mapTxSpends.equal_range(outpoint);
@@ -795,6 +795,52 @@ void CWallet::AddToSpends(const uint256& wtxid)
         AddToSpends(txin.prevout, wtxid);
 }
 
+void CWallet::AddToWalletUTXO(const COutPoint& outpoint, CAmount nValue)
+{
+    setWalletUTXO.insert(outpoint);
+
+    if (CPrivateSend::IsDenominatedAmount(nValue)) {
+        mapDenominatedUTXO[nValue].insert(outpoint);
+    } else if (CPrivateSend::IsCollateralAmount(nValue)) {
+        setCollateralUTXO.insert(outpoint);
+    }
+}
+
+void CWallet::RemoveFromWalletUTXO(const COutPoint& outpoint)
+{
+    if (!setWalletUTXO.erase(outpoint)) {
+        return;
+    }
+
+    const CWalletTx* wtx = GetWalletTx(outpoint.hash);
+    if (wtx == NULL) {
+        return;
+    }
+
+    CAmount nValue = wtx->tx->vout[outpoint.n].nValue;
+    auto it = mapDenominatedUTXO.find(nValue);
+    if (it != mapDenominatedUTXO.end()) {
+        it->second.erase(outpoint);
+    }
+    setCollateralUTXO.erase(outpoint);
+}
+
+void CWallet::AddInputsToWalletUTXO(const CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+
+    for (const auto& txin : wtx.tx->vin) {
+        const CWalletTx* prev = GetWalletTx(txin.prevout.hash);
+        if (prev == NULL || txin.prevout.n >= prev->tx->vout.size()) {
+            continue;
+        }
+        const CTxOut& txout = prev->tx->vout[txin.prevout.n];
+        if (IsMine(txout) && !IsSpent(txin.prevout.hash, txin.prevout.n)) {
+            AddToWalletUTXO(txin.prevout, txout.nValue);
+        }
+    }
+}
+
 bool CWallet::EncryptWallet(const SecureString& strWalletPassphrase)
 {
     if (IsCrypted())
@@ -1119,16 +1165,19 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
         wtxOrdered.insert(std::make_pair(wtx.nOrderPos, TxPair(&wtx, (CAccountingEntry*)0)));
         wtx.nTimeSmart = ComputeTimeSmart(wtx);
         AddToSpends(hash);
+        ErasePrivateSendRounds(walletdb, wtx);
 
         auto mnList = deterministicMNManager->GetListAtChainTip();
         for(unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
             if (IsMine(wtx.tx->vout[i]) && !IsSpent(hash, i)) {
-                setWalletUTXO.insert(COutPoint(hash, i));
+                AddToWalletUTXO(COutPoint(hash, i), wtx.tx->vout[i].nValue);
                 if (deterministicMNManager->IsProTxWithCollateral(wtx.tx, i) || mnList.HasMNByCollateral(COutPoint(hash, i))) {
                     LockCoin(COutPoint(hash, i));
                 }
             }
         }
+
+        UpdatePrivateSendRounds(walletdb, hash);
     }
 
     bool fUpdated = false;
@@ -1291,6 +1340,8 @@ bool CWallet::AbandonTransaction(const uint256& hashTx)
             wtx.MarkDirty();
             walletdb.WriteTx(wtx);
             NotifyTransactionChanged(this, wtx.GetHash(), CT_UPDATED);
+            // the coins spent by this tx are available again
+            AddInputsToWalletUTXO(wtx);
             // Iterate over all its outputs, and mark transactions in the wallet that spend them abandoned too
             TxSpends::const_iterator iter = mapTxSpends.lower_bound(COutPoint(hashTx, 0));
             while (iter != mapTxSpends.end() && iter->first.hash == now) {
@@ -1355,6 +1406,8 @@ void CWallet::MarkConflicted(const uint256& hashBlock, const uint256& hashTx)
             wtx.hashBlock = hashBlock;
             wtx.MarkDirty();
             walletdb.WriteTx(wtx);
+            // the coins spent by this tx are available again
+            AddInputsToWalletUTXO(wtx);
             // Iterate over all its outputs, and mark transactions in the wallet that spend them conflicted too
             TxSpends::const_iterator iter = mapTxSpends.lower_bound(COutPoint(now, 0));
             while (iter != mapTxSpends.end() && iter->first.hash == now) {
@@ -1434,83 +1487,137 @@ CAmount CWallet::GetDebit(const CTxIn &txin, const isminefilter& filter) const
 // Recursively determine the rounds of a given input (How deep is the PrivateSend chain for a given input)
 int CWallet::GetRealOutpointPrivateSendRounds(const COutPoint& outpoint, int nRounds) const
 {
-    static std::map<uint256, CMutableTransaction> mDenomWtxes;
+    LOCK(cs_wallet);
 
     if(nRounds >= MAX_PRIVATESEND_ROUNDS) {
         // there can only be MAX_PRIVATESEND_ROUNDS rounds max
         return MAX_PRIVATESEND_ROUNDS - 1;
     }
 
-    uint256 hash = outpoint.hash;
-    unsigned int nout = outpoint.n;
-
-    const CWalletTx* wtx = GetWalletTx(hash);
-    if(wtx != NULL)
-    {
-        std::map<uint256, CMutableTransaction>::const_iterator mdwi = mDenomWtxes.find(hash);
-        if (mdwi == mDenomWtxes.end()) {
-            // not known yet, let's add it
-            LogPrint("privatesend", "GetRealOutpointPrivateSendRounds INSERTING %s\n", hash.ToString());
-            mDenomWtxes[hash] = CMutableTransaction(*wtx);
-        } else if(mDenomWtxes[hash].vout[nout].nRounds != -10) {
-            // found and it's not an initial value, just return it
-            return mDenomWtxes[hash].vout[nout].nRounds;
-        }
-
+    auto itCache = mapOutpointRoundsCache.find(outpoint);
+    if (itCache != mapOutpointRoundsCache.end()) {
+        return itCache->second;
+    }
 
-        // bounds check
-        if (nout >= wtx->tx->vout.size()) {
-            // should never actually hit this
-            LogPrint("privatesend", "GetRealOutpointPrivateSendRounds UPDATED   %s %3d %3d\n", hash.ToString(), nout, -4);
-            return -4;
-        }
+    const CWalletTx* wtx = GetWalletTx(outpoint.hash);
+    if(wtx == NULL) {
+        return nRounds - 1;
+    }
 
-        if (CPrivateSend::IsCollateralAmount(wtx->tx->vout[nout].nValue)) {
-            mDenomWtxes[hash].vout[nout].nRounds = -3;
-            LogPrint("privatesend", "GetRealOutpointPrivateSendRounds UPDATED   %s %3d %3d\n", hash.ToString(), nout, mDenomWtxes[hash].vout[nout].nRounds);
-            return mDenomWtxes[hash].vout[nout].nRounds;
-        }
+    // bounds check
+    if (outpoint.n >= wtx->tx->vout.size()) {
+        // should never actually hit this
+        LogPrint("privatesend", "GetRealOutpointPrivateSendRounds UPDATED   %s %3d %3d\n", outpoint.hash.ToString(), outpoint.n, -4);
+        return -4;
+    }
 
+    int nOutpointRounds;
+    if (CPrivateSend::IsCollateralAmount(wtx->tx->vout[outpoint.n].nValue)) {
+        nOutpointRounds = -3;
+    } else if (!CPrivateSend::IsDenominatedAmount(wtx->tx->vout[outpoint.n].nValue)) {
         //make sure the final output is non-denominate
-        if (!CPrivateSend::IsDenominatedAmount(wtx->tx->vout[nout].nValue)) { //NOT DENOM
-            mDenomWtxes[hash].vout[nout].nRounds = -2;
-            LogPrint("privatesend", "GetRealOutpointPrivateSendRounds UPDATED   %s %3d %3d\n", hash.ToString(), nout, mDenomWtxes[hash].vout[nout].nRounds);
-            return mDenomWtxes[hash].vout[nout].nRounds;
-        }
-
+        nOutpointRounds = -2;
+    } else {
         bool fAllDenoms = true;
         for (const auto& out : wtx->tx->vout) {
             fAllDenoms = fAllDenoms && CPrivateSend::IsDenominatedAmount(out.nValue);
         }
 
-        // this one is denominated but there is another non-denominated output found in the same tx
         if (!fAllDenoms) {
-            mDenomWtxes[hash].vout[nout].nRounds = 0;
-            LogPrint("privatesend", "GetRealOutpointPrivateSendRounds UPDATED   %s %3d %3d\n", hash.ToString(), nout, mDenomWtxes[hash].vout[nout].nRounds);
-            return mDenomWtxes[hash].vout[nout].nRounds;
-        }
-
-        int nShortest = -10; // an initial value, should be no way to get this by calculations
-        bool fDenomFound = false;
-        // only denoms here so let's look up
-        for (const auto& txinNext : wtx->tx->vin) {
-            if (IsMine(txinNext)) {
-                int n = GetRealOutpointPrivateSendRounds(txinNext.prevout, nRounds + 1);
-                // denom found, find the shortest chain or initially assign nShortest with the first found value
-                if(n >= 0 && (n < nShortest || nShortest == -10)) {
-                    nShortest = n;
-                    fDenomFound = true;
+            // this one is denominated but there is another non-denominated output found in the same tx
+            nOutpointRounds = 0;
+        } else {
+            int nShortest = -10; // an initial value, should be no way to get this by calculations
+            bool fDenomFound = false;
+            // only denoms here so let's look up
+            for (const auto& txinNext : wtx->tx->vin) {
+                if (IsMine(txinNext)) {
+                    int n = GetRealOutpointPrivateSendRounds(txinNext.prevout, nRounds + 1);
+                    // denom found, find the shortest chain or initially assign nShortest with the first found value
+                    if(n >= 0 && (n < nShortest || nShortest == -10)) {
+                        nShortest = n;
+                        fDenomFound = true;
+                    }
                 }
             }
+            nOutpointRounds = fDenomFound
+                    ? (nShortest >= MAX_PRIVATESEND_ROUNDS - 1 ? MAX_PRIVATESEND_ROUNDS : nShortest + 1) // good, we a +1 to the shortest one but only MAX_PRIVATESEND_ROUNDS rounds max allowed
+                    : 0;            // too bad, we are the fist one in that chain
+        }
+    }
+
+    mapOutpointRoundsCache.emplace(outpoint, nOutpointRounds);
+    LogPrint("privatesend", "GetRealOutpointPrivateSendRounds UPDATED   %s %3d %3d\n", outpoint.hash.ToString(), outpoint.n, nOutpointRounds);
+    return nOutpointRounds;
+}
+
+void CWallet::LoadPrivateSendRounds(const COutPoint& outpoint, int nRounds)
+{
+    // entries written with a different MAX_PRIVATESEND_ROUNDS are simply recomputed
+    if (nRounds < 0 || nRounds > MAX_PRIVATESEND_ROUNDS) return;
+
+    mapOutpointRoundsCache[outpoint] = nRounds;
+}
+
+void CWallet::ErasePrivateSendRounds(CWalletDB& walletdb, const CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+
+    if (fLiteMode) return;
+
+    // Stored rounds are only needed for coins in setWalletUTXO, the cache keeps them for computing the rounds of
+    // descendants
+    for (const auto& txin : wtx.tx->vin) {
+        if (mapOutpointRoundsCache.count(txin.prevout) && !setWalletUTXO.count(txin.prevout)) {
+            walletdb.ErasePrivateSendRounds(txin.prevout);
+        }
+    }
+}
+
+void CWallet::UpdatePrivateSendRounds(CWalletDB& walletdb, const uint256& hash)
+{
+    AssertLockHeld(cs_wallet);
+
+    if (fLiteMode) return;
+
+    // Wallet transactions spending this one (directly or indirectly) could have been added before it, in which case
+    // their rounds were computed without knowing this part of their ancestry
+    std::set<uint256> setToUpdate{hash};
+    std::vector<uint256> vecToVisit{hash};
+    while (!vecToVisit.empty()) {
+        uint256 hashCur = vecToVisit.back();
+        vecToVisit.pop_back();
+        TxSpends::const_iterator iter = mapTxSpends.lower_bound(COutPoint(hashCur, 0));
+        while (iter != mapTxSpends.end() && iter->first.hash == hashCur) {
+            if (setToUpdate.emplace(iter->second).second) {
+                vecToVisit.emplace_back(iter->second);
+            }
+            ++iter;
+        }
+    }
+
+    for (const auto& hashUpdate : setToUpdate) {
+        const CWalletTx* wtx = GetWalletTx(hashUpdate);
+        if (wtx == NULL) continue;
+        for (unsigned int i = 0; i < wtx->tx->vout.size(); i++) {
+            mapOutpointRoundsCache.erase(COutPoint(hashUpdate, i));
         }
-        mDenomWtxes[hash].vout[nout].nRounds = fDenomFound
-                ? (nShortest >= MAX_PRIVATESEND_ROUNDS - 1 ? MAX_PRIVATESEND_ROUNDS : nShortest + 1) // good, we a +1 to the shortest one but only MAX_PRIVATESEND_ROUNDS rounds max allowed
-                : 0;            // too bad, we are the fist one in that chain
-        LogPrint("privatesend", "GetRealOutpointPrivateSendRounds UPDATED   %s %3d %3d\n", hash.ToString(), nout, mDenomWtxes[hash].vout[nout].nRounds);
-        return mDenomWtxes[hash].vout[nout].nRounds;
     }
 
-    return nRounds - 1;
+    for (const auto& hashUpdate : setToUpdate) {
+        const CWalletTx* wtx = GetWalletTx(hashUpdate);
+        if (wtx == NULL) continue;
+        for (unsigned int i = 0; i < wtx->tx->vout.size(); i++) {
+            if (!IsMine(wtx->tx->vout[i])) continue;
+            COutPoint outpoint(hashUpdate, i);
+            int nRounds = GetRealOutpointPrivateSendRounds(outpoint);
+            // only unspent denominated outputs are worth storing, everything else is known without walking the
+            // ancestry or not needed anymore
+            if (nRounds >= 0 && setWalletUTXO.count(outpoint)) {
+                walletdb.WritePrivateSendRounds(outpoint, nRounds);
+            }
+        }
+    }
 }
 
 // respect current settings
@@ -2587,71 +2694,118 @@ CAmount CWallet::GetImmatureWatchOnlyBalance() const
     return nTotal;
 }
 
+bool CWallet::IsAvailableCoinTx(const CWalletTx* pcoin, bool fOnlySafe, bool fUseInstantSend, int& nDepthRet, bool& fSafeRet) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    if (!CheckFinalTx(*pcoin))
+        return false;
+
+    if (pcoin->IsCoinBase() && pcoin->GetBlocksToMaturity() > 0)
+        return false;
+
+    nDepthRet = pcoin->GetDepthInMainChain();
+    // do not use IX for inputs that have less then nInstantSendConfirmationsRequired blockchain confirmations
+    if (fUseInstantSend && nDepthRet < Params().GetConsensus().nInstantSendConfirmationsRequired)
+        return false;
+
+    // We should not consider coins which aren't at least in our mempool
+    // It's possible for these to be conflicted via ancestors which we may never be able to detect
+    if (nDepthRet == 0 && !pcoin->InMempool())
+        return false;
+
+    fSafeRet = pcoin->IsTrusted();
+
+    if (fOnlySafe && !fSafeRet) {
+        return false;
+    }
+
+    return true;
+}
+
+void CWallet::AddAvailableCoin(std::vector<COutput>& vCoins, const CWalletTx* pcoin, unsigned int i, int nDepth, bool fSafe, const CCoinControl* coinControl, bool fIncludeZeroValue, AvailableCoinsType nCoinType) const
+{
+    const uint256& wtxid = pcoin->GetHash();
+
+    bool found = false;
+    if(nCoinType == ONLY_DENOMINATED) {
+        found = CPrivateSend::IsDenominatedAmount(pcoin->tx->vout[i].nValue);
+    } else if(nCoinType == ONLY_NONDENOMINATED) {
+        if (CPrivateSend::IsCollateralAmount(pcoin->tx->vout[i].nValue)) return; // do not use collateral amounts
+        found = !CPrivateSend::IsDenominatedAmount(pcoin->tx->vout[i].nValue);
+    } else if(nCoinType == ONLY_1000) {
+        found = pcoin->tx->vout[i].nValue == 1000*COIN;
+    } else if(nCoinType == ONLY_PRIVATESEND_COLLATERAL) {
+        found = CPrivateSend::IsCollateralAmount(pcoin->tx->vout[i].nValue);
+    } else {
+        found = true;
+    }
+    if(!found) return;
+
+    isminetype mine = IsMine(pcoin->tx->vout[i]);
+    if (!(IsSpent(wtxid, i)) && mine != ISMINE_NO &&
+        (!IsLockedCoin(wtxid, i) || nCoinType == ONLY_1000) &&
+        (pcoin->tx->vout[i].nValue > 0 || fIncludeZeroValue) &&
+        (!coinControl || !coinControl->HasSelected() || coinControl->fAllowOtherInputs || coinControl->IsSelected(COutPoint(wtxid, i))))
+            vCoins.push_back(COutput(pcoin, i, nDepth,
+                                     ((mine & ISMINE_SPENDABLE) != ISMINE_NO) ||
+                                      (coinControl && coinControl->fAllowWatchOnly && (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO),
+                                     (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE)) != ISMINE_NO, fSafe));
+}
+
+void CWallet::AvailableCoinsFromOutpoints(std::vector<COutput>& vCoins, const std::set<COutPoint>& setOutpoints, bool fOnlySafe, const CCoinControl* coinControl, bool fIncludeZeroValue, AvailableCoinsType nCoinType, bool fUseInstantSend) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+
+    // outpoints are ordered by txid, so tx level checks are only done once per tx
+    const CWalletTx* pcoin = NULL;
+    bool fAvailable = false;
+    int nDepth = 0;
+    bool fSafe = false;
+    for (const auto& outpoint : setOutpoints) {
+        if (pcoin == NULL || pcoin->GetHash() != outpoint.hash) {
+            pcoin = GetWalletTx(outpoint.hash);
+            if (pcoin == NULL) continue;
+            fAvailable = IsAvailableCoinTx(pcoin, fOnlySafe, fUseInstantSend, nDepth, fSafe);
+        }
+        if (fAvailable) {
+            AddAvailableCoin(vCoins, pcoin, outpoint.n, nDepth, fSafe, coinControl, fIncludeZeroValue, nCoinType);
+        }
+    }
+}
+
 void CWallet::AvailableCoins(std::vector<COutput>& vCoins, bool fOnlySafe, const CCoinControl *coinControl, bool fIncludeZeroValue, AvailableCoinsType nCoinType, bool fUseInstantSend) const
 {
     vCoins.clear();
 
     {
         LOCK2(cs_main, cs_wallet);
-        int nInstantSendConfirmationsRequired = Params().GetConsensus().nInstantSendConfirmationsRequired;
+
+        // PrivateSend coins are indexed, no need to look at every wallet transaction
+        if (nCoinType == ONLY_DENOMINATED) {
+            for (const auto& pair : mapDenominatedUTXO) {
+                AvailableCoinsFromOutpoints(vCoins, pair.second, fOnlySafe, coinControl, fIncludeZeroValue, nCoinType, fUseInstantSend);
+            }
+            return;
+        }
+        if (nCoinType == ONLY_PRIVATESEND_COLLATERAL) {
+            AvailableCoinsFromOutpoints(vCoins, setCollateralUTXO, fOnlySafe, coinControl, fIncludeZeroValue, nCoinType, fUseInstantSend);
+            return;
+        }
 
         for (std::map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
         {
-            const uint256& wtxid = it->first;
             const CWalletTx* pcoin = &(*it).second;
 
-            if (!CheckFinalTx(*pcoin))
+            int nDepth;
+            bool fSafe;
+            if (!IsAvailableCoinTx(pcoin, fOnlySafe, fUseInstantSend, nDepth, fSafe))
                 continue;
 
-            if (pcoin->IsCoinBase() && pcoin->GetBlocksToMaturity() > 0)
-                continue;
-
-            int nDepth = pcoin->GetDepthInMainChain();
-            // do not use IX for inputs that have less then nInstantSendConfirmationsRequired blockchain confirmations
-            if (fUseInstantSend && nDepth < nInstantSendConfirmationsRequired)
-                continue;
-
-            // We should not consider coins which aren't at least in our mempool
-            // It's possible for these to be conflicted via ancestors which we may never be able to detect
-            if (nDepth == 0 && !pcoin->InMempool())
-                continue;
-
-            // We should not consider coins which aren't at least in our mempool
-            // It's possible for these to be conflicted via ancestors which we may never be able to detect
-            if (nDepth == 0 && !pcoin->InMempool())
-                continue;
-
-            bool safeTx = pcoin->IsTrusted();
-
-            if (fOnlySafe && !safeTx) {
-                continue;
-            }
-
             for (unsigned int i = 0; i < pcoin->tx->vout.size(); i++) {
-                bool found = false;
-                if(nCoinType == ONLY_DENOMINATED) {
-                    found = CPrivateSend::IsDenominatedAmount(pcoin->tx->vout[i].nValue);
-                } else if(nCoinType == ONLY_NONDENOMINATED) {
-                    if (CPrivateSend::IsCollateralAmount(pcoin->tx->vout[i].nValue)) continue; // do not use collateral amounts
-                    found = !CPrivateSend::IsDenominatedAmount(pcoin->tx->vout[i].nValue);
-                } else if(nCoinType == ONLY_1000) {
-                    found = pcoin->tx->vout[i].nValue == 1000*COIN;
-                } else if(nCoinType == ONLY_PRIVATESEND_COLLATERAL) {
-                    found = CPrivateSend::IsCollateralAmount(pcoin->tx->vout[i].nValue);
-                } else {
-                    found = true;
-                }
-                if(!found) continue;
-
-                isminetype mine = IsMine(pcoin->tx->vout[i]);
-                if (!(IsSpent(wtxid, i)) && mine != ISMINE_NO &&
-                    (!IsLockedCoin((*it).first, i) || nCoinType == ONLY_1000) &&
-                    (pcoin->tx->vout[i].nValue > 0 || fIncludeZeroValue) &&
-                    (!coinControl || !coinControl->HasSelected() || coinControl->fAllowOtherInputs || coinControl->IsSelected(COutPoint((*it).first, i))))
-                        vCoins.push_back(COutput(pcoin, i, nDepth,
-                                                 ((mine & ISMINE_SPENDABLE) != ISMINE_NO) ||
-                                                  (coinControl && coinControl->fAllowWatchOnly && (mine & ISMINE_WATCH_SOLVABLE) != ISMINE_NO),
-                                                 (mine & (ISMINE_SPENDABLE | ISMINE_WATCH_SOLVABLE)) != ISMINE_NO, safeTx));
+                AddAvailableCoin(vCoins, pcoin, i, nDepth, fSafe, coinControl, fIncludeZeroValue, nCoinType);
             }
         }
     }
@@ -3127,12 +3281,22 @@ bool CWallet::SelectPSInOutPairsByDenominations(int nDenom, CAmount nValueMin, C
         return false;
     }
 
-    AvailableCoins(vCoins, true, NULL, false, ONLY_DENOMINATED);
+    std::vector<CAmount> vecPrivateSendDenominations = CPrivateSend::GetStandardDenominations();
+
+    {
+        // only look at the buckets of the requested denominations
+        LOCK2(cs_main, cs_wallet);
+        for (const auto& nBit : vecBits) {
+            auto it = mapDenominatedUTXO.find(vecPrivateSendDenominations[nBit]);
+            if (it != mapDenominatedUTXO.end()) {
+                AvailableCoinsFromOutpoints(vCoins, it->second, true, NULL, false, ONLY_DENOMINATED, false);
+            }
+        }
+    }
     LogPrintf("CWallet::%s -- vCoins.size(): %d\n", __func__, vCoins.size());
 
     std::random_shuffle(vCoins.rbegin(), vCoins.rend(), GetRandInt);
 
-    std::vector<CAmount> vecPrivateSendDenominations = CPrivateSend::GetStandardDenominations();
     for (const auto& out : vCoins) {
         uint256 txHash = out.tx->GetHash();
         int nValue = out.tx->tx->vout[out.i].nValue;
@@ -3378,7 +3542,15 @@ int CWallet::CountInputsWithAmount(CAmount nInputAmount) const
 
     LOCK2(cs_main, cs_wallet);
 
-    for (const auto& outpoint : setWalletUTXO) {
+    // denominations have their own bucket, everything else needs a look at all coins
+    const std::set<COutPoint>* pOutpoints = &setWalletUTXO;
+    if (CPrivateSend::IsDenominatedAmount(nInputAmount)) {
+        auto itBucket = mapDenominatedUTXO.find(nInputAmount);
+        if (itBucket == mapDenominatedUTXO.end()) return 0;
+        pOutpoints = &itBucket->second;
+    }
+
+    for (const auto& outpoint : *pOutpoints) {
         const auto it = mapWallet.find(outpoint.hash);
         if (it == mapWallet.end()) continue;
         if (it->second.tx->vout[outpoint.n].nValue != nInputAmount) continue;
@@ -4121,12 +4293,34 @@ DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
         for (auto& pair : mapWallet) {
             for(unsigned int i = 0; i < pair.second.tx->vout.size(); ++i) {
                 if (IsMine(pair.second.tx->vout[i]) && !IsSpent(pair.first, i)) {
-                    setWalletUTXO.insert(COutPoint(pair.first, i));
+                    AddToWalletUTXO(COutPoint(pair.first, i), pair.second.tx->vout[i].nValue);
                 }
             }
         }
     }
 
+    if (!fLiteMode && nLoadWalletRet == DB_LOAD_OK) {
+        // Wallets written by older versions (or entries dropped because of changed limits) have no stored rounds for
+        // some of their coins yet. Compute them once here instead of on every balance query. Only the rounds of
+        // unspent coins are kept in the db, entries of coins which were spent meanwhile are dropped.
+        LOCK(cs_wallet);
+        CWalletDB walletdb(strWalletFile);
+        walletdb.TxnBegin();
+        for (const auto& pair : mapOutpointRoundsCache) {
+            if (!setWalletUTXO.count(pair.first)) {
+                walletdb.ErasePrivateSendRounds(pair.first);
+            }
+        }
+        for (const auto& outpoint : setWalletUTXO) {
+            if (mapOutpointRoundsCache.count(outpoint)) continue;
+            int nRounds = GetRealOutpointPrivateSendRounds(outpoint);
+            if (nRounds >= 0) {
+                walletdb.WritePrivateSendRounds(outpoint, nRounds);
+            }
+        }
+        walletdb.TxnCommit();
+    }
+
     if (nLoadWalletRet != DB_LOAD_OK)
         return nLoadWalletRet;
     fFirstRunRet = !vchDefaultKey.IsValid();
@@ -721,6 +721,35 @@ private:
 
     std::set<COutPoint> setWalletUTXO;
 
+    /**
+     * Subsets of setWalletUTXO used by PrivateSend: unspent denominated coins bucketed by denomination and unspent
+     * collateral coins. Both are maintained together with setWalletUTXO (see AddToWalletUTXO/RemoveFromWalletUTXO),
+     * so that PrivateSend coin selection does not need to scan the whole wallet.
+     */
+    std::map<CAmount, std::set<COutPoint> > mapDenominatedUTXO;
+    std::set<COutPoint> setCollateralUTXO;
+    void AddToWalletUTXO(const COutPoint& outpoint, CAmount nValue);
+    void RemoveFromWalletUTXO(const COutPoint& outpoint);
+    /* Re-adds the inputs of an abandoned or conflicted tx which are not spent by any other tx anymore */
+    void AddInputsToWalletUTXO(const CWalletTx& wtx);
+
+    /* Tx level checks of AvailableCoins, returns false if no output of this tx can be used */
+    bool IsAvailableCoinTx(const CWalletTx* pcoin, bool fOnlySafe, bool fUseInstantSend, int& nDepthRet, bool& fSafeRet) const;
+    void AddAvailableCoin(std::vector<COutput>& vCoins, const CWalletTx* pcoin, unsigned int i, int nDepth, bool fSafe, const CCoinControl* coinControl, bool fIncludeZeroValue, AvailableCoinsType nCoinType) const;
+    /* Same as AvailableCoins, but only looks at the given outpoints. Appends to vCoins */
+    void AvailableCoinsFromOutpoints(std::vector<COutput>& vCoins, const std::set<COutPoint>& setOutpoints, bool fOnlySafe, const CCoinControl* coinControl, bool fIncludeZeroValue, AvailableCoinsType nCoinType, bool fUseInstantSend) const;
+
+    /**
+     * PrivateSend rounds of wallet outputs. Rounds of denominated outputs are computed when their transaction is added
+     * and persisted in the wallet db ("psrounds") while they are unspent, so the ancestry of an output is only ever
+     * walked once. Entries of
+     * all in-wallet descendants are recomputed when a missing ancestor is added later (see UpdatePrivateSendRounds).
+     */
+    mutable std::map<COutPoint, int> mapOutpointRoundsCache;
+    void UpdatePrivateSendRounds(CWalletDB& walletdb, const uint256& hash);
+    /* Drops the stored rounds of the coins spent by wtx */
+    void ErasePrivateSendRounds(CWalletDB& walletdb, const CWalletTx& wtx);
+
     /* Mark a transaction (and its in-wallet descendants) as conflicting with a particular block. */
     void MarkConflicted(const uint256& hashBlock, const uint256& hashTx);
 
@@ -891,6 +920,8 @@ public:
 
     // get the PrivateSend chain depth for a given input
     int GetRealOutpointPrivateSendRounds(const COutPoint& outpoint, int nRounds = 0) const;
+    // load the PrivateSend rounds of an output from the wallet db, without saving it to disk
+    void LoadPrivateSendRounds(const COutPoint& outpoint, int nRounds);
     // respect current settings
     int GetCappedOutpointPrivateSendRounds(const COutPoint& outpoint) const;
 
@@ -187,6 +187,18 @@ bool CWalletDB::ReadAccount(const std::string& strAccount, CAccount& account)
     return Read(make_pair(std::string("acc"), strAccount), account);
 }
 
+bool CWalletDB::WritePrivateSendRounds(const COutPoint& outpoint, int nRounds)
+{
+    nWalletDBUpdateCounter++;
+    return Write(std::make_pair(std::string("psrounds"), outpoint), nRounds);
+}
+
+bool CWalletDB::ErasePrivateSendRounds(const COutPoint& outpoint)
+{
+    nWalletDBUpdateCounter++;
+    return Erase(std::make_pair(std::string("psrounds"), outpoint));
+}
+
 bool CWalletDB::WriteAccount(const std::string& strAccount, const CAccount& account)
 {
     return Write(make_pair(std::string("acc"), strAccount), account);
@@ -526,6 +538,14 @@ ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue,
                 return false;
             }
         }
+        else if (strType == "psrounds")
+        {
+            COutPoint outpoint;
+            int nRounds;
+            ssKey >> outpoint;
+            ssValue >> nRounds;
+            pwallet->LoadPrivateSendRounds(outpoint, nRounds);
+        }
         else if (strType == "hdchain")
         {
             CHDChain chain;
@@ -24,6 +24,7 @@ class CAccountingEntry;
 struct CBlockLocator;
 class CKeyPool;
 class CMasterKey;
+class COutPoint;
 class CScript;
 class CWallet;
 class CWalletTx;
@@ -112,6 +113,9 @@ public:
 
     bool WriteMinVersion(int nVersion);
 
+    bool WritePrivateSendRounds(const COutPoint& outpoint, int nRounds);
+    bool ErasePrivateSendRounds(const COutPoint& outpoint);
+
     /// This writes directly to the database, and will not update the CWallet's cached accounting entries!
     /// Use wallet.AddAccountingEntry instead, to write *and* update its caches.
     bool WriteAccountingEntry(const uint64_t nAccEntryNum, const CAccountingEntry& acentry);